@@ -29,6 +29,9 @@ bool cs_ambig_wide;
 
 static uint codepage, default_codepage;
 
+// Bumped on changes of the configured charset, to invalidate all decoders.
+static uint cs_gen = 1;
+
 static wchar cp_default_wchar;
 static char cp_default_char[4];
 
@@ -263,18 +266,6 @@ update_mode(void)
 #else
   get_cp_info();
 #endif
-
-  // Clear output conversion state.
-  cs_mb1towc(0, 0);
-}
-
-void
-cs_set_mode(cs_mode new_mode)
-{
-  if (new_mode == mode)
-    return;
-  mode = new_mode;
-  update_mode();
 }
 
 static void
@@ -319,11 +310,20 @@ cs_get_locale(void)
 }
 
 void
-cs_set_locale(string locale)
+cs_select(cs_mode new_mode, string locale)
 {
-  delete(term_locale);
-  term_locale = *locale ? strdup(locale) : 0;
-  update_locale();
+  bool same_locale =
+    locale && term_locale ? !strcmp(locale, term_locale) : locale == term_locale;
+  if (!same_locale) {
+    delete(term_locale);
+    term_locale = locale ? strdup(locale) : 0;
+    mode = new_mode;
+    update_locale();
+  }
+  else if (new_mode != mode) {
+    mode = new_mode;
+    update_mode();
+  }
 }
 
 void
@@ -348,6 +348,7 @@ cs_reconfig(void)
     config_locale = 0;
   
   update_locale();
+  cs_gen++;
 }
 
 static string
@@ -411,32 +412,35 @@ cs_mbstowcs(wchar *ws, const char *s, size_t wlen)
 }
 
 int
-cs_mb1towc(wchar *pwc, char c)
+cs_mb1towc(cs_decoder *d, wchar *pwc, char c)
 {
+  if (!pwc || d->gen != cs_gen) {
+    // Reset state
+    memset(d, 0, sizeof *d);
+    d->gen = cs_gen;
+    if (!pwc)
+      return 0;
+  }
+
 #if HAS_LOCALES
   if (use_locale)
-    return mbrtowc(pwc, &c, 1, 0);
+    return mbrtowc(pwc, &c, 1, &d->mbs);
 #endif
 
   // The Windows way
-  static int sn;
-  static char s[8];
-  static wchar ws[2];
+  int *sn = &d->n;
+  char *s = d->s;
+  wchar *ws = d->ws;
 
-  if (!pwc) {
-    // Reset state
-    sn = 0;
-    return 0;
-  }
-  if (sn < 0) {
+  if (*sn < 0) {
     // Leftover surrogate
     *pwc = ws[1];
-    sn = 0;
+    *sn = 0;
     return 1;
   }
-  s[sn++] = c;
-  s[sn] = 0;
-  switch (MultiByteToWideChar(codepage, 0, s, sn, ws, 2)) {
+  s[(*sn)++] = c;
+  s[*sn] = 0;
+  switch (MultiByteToWideChar(codepage, 0, s, *sn, ws, 2)) {
     when 1: {
       // Incomplete sequences yield the codepage's default character, but so
       // does the default character's very own (valid) sequence.
@@ -447,23 +451,23 @@ cs_mb1towc(wchar *pwc, char c)
         (!*ws && *s);
       if (!incomplete) {
         *pwc = *ws;
-        sn = 0;
+        *sn = 0;
         return 1;
       }
     }
     when 2:
       if (IS_HIGH_SURROGATE(*ws)) {
         *pwc = *ws;
-        sn = -1; // Surrogate pair
+        *sn = -1; // Surrogate pair
         return 0;
       }
       // Special handling for GB18030. Windows considers the first two bytes
       // of a four-byte sequence as an encoding error followed by a digit.
-      if (codepage == 54936 && sn == 2 && ws[1] >= '0' && ws[1] <= '9')
+      if (codepage == 54936 && *sn == 2 && ws[1] >= '0' && ws[1] <= '9')
         return -2;
       return -1; // Encoding error
   }
-  return sn < cs_cur_max ? -2 : -1;
+  return *sn < cs_cur_max ? -2 : -1;
 }
 
 wchar
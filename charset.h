@@ -1,7 +1,7 @@
 #ifndef CHARSET_H
 #define CHARSET_H
 
-#if CYGWIN_VERSION_DLL_MAJOR >= 1007
+#if !defined HEADLESS && CYGWIN_VERSION_DLL_MAJOR >= 1007
   #define HAS_LOCALES 1
 #else
   #define HAS_LOCALES 0
@@ -33,14 +33,34 @@ void cs_reconfig(void);
 string cs_lang(void);
 
 string cs_get_locale(void);
-void cs_set_locale(string);
 
+/*
+ * Select the charset mode and locale set by a terminal's control sequences,
+ * with a null locale standing for the configured one. Conversions follow
+ * the settings selected last, so each terminal selects its own before
+ * converting anything.
+ */
 typedef enum { CSM_DEFAULT, CSM_OEM, CSM_UTF8 } cs_mode;
-void cs_set_mode(cs_mode);
+void cs_select(cs_mode, string locale);
 
 int cs_wcntombn(char *s, const wchar *ws, size_t len, size_t wlen);
 int cs_mbstowcs(wchar *ws, const char *s, size_t wlen);
-int cs_mb1towc(wchar *pwc, char c);
+/*
+ * State of a multibyte to UTF-16 conversion, so that each terminal can
+ * decode its input independently. A decoder starts out zeroed, and is
+ * reset by passing a null output pointer, or by a change of the
+ * configured charset.
+ */
+typedef struct {
+  uint gen;       /* charset generation the state belongs to */
+  int n;          /* bytes of a partial sequence, or -1 if the second half
+                   * of a surrogate pair is pending */
+  char s[8];      /* the partial sequence */
+  wchar ws[2];    /* result of the conversion */
+  mbstate_t mbs;  /* state of the C library's conversion */
+} cs_decoder;
+
+int cs_mb1towc(cs_decoder *, wchar *pwc, char c);
 wchar cs_btowc_glyph(char);
 
 extern string locale_menu[];
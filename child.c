@@ -5,7 +5,11 @@
 #include "child.h"
 
 #include "term.h"
+#include "win.h"
 #include "charset.h"
+#include "latency.h"
+#include "counters.h"
+#include "trace.h"
 
 #include <pwd.h>
 #include <fcntl.h>
@@ -33,9 +37,136 @@ int forkpty(int *, char *, struct termios *, struct winsize *);
 
 char *home, *cmd;
 
-static pid_t pid;
 static bool killed;
-static int pty_fd = -1, log_fd = -1, win_fd;
+static int win_fd = -1;
+
+/*
+ * There's a child process with a pseudo terminal of its own for each
+ * terminal. The child_* functions act on the one for the current terminal.
+ */
+typedef struct child {
+  struct child *next;
+  term_t *term;
+  pid_t pid;
+  int pty_fd, log_fd;
+
+  /*
+   * All output to the child goes through this queue. It's flushed once
+   * per event loop iteration, and anything the pty doesn't accept is kept
+   * until the pty becomes writable again.
+   */
+  struct {
+    char *data;
+    uint pos, len, size;
+  } out;
+
+  /*
+   * Output from the child is buffered here before being processed.
+   * Processing is done in time-limited slices, so that the window stays
+   * responsive if the child produces output faster than it can be
+   * displayed. If too much builds up, reading from the pty stops until
+   * the buffer is down to half the limit, which makes the child wait.
+   */
+  struct {
+    char *data;
+    uint pos, len, size;
+    bool throttled;
+  } in;
+} child;
+
+static child *children;
+static child *cur_child;  // cache for get_child()
+
+static child *
+get_child(void)
+{
+  if (cur_child && cur_child->term == term)
+    return cur_child;
+  for (child *c = children; c; c = c->next) {
+    if (c->term == term)
+      return cur_child = c;
+  }
+  return 0;
+}
+
+static void
+reserve_out(child *c, uint len)
+{
+  if (c->out.len + len > c->out.size && c->out.pos) {
+    memmove(c->out.data, c->out.data + c->out.pos, c->out.len - c->out.pos);
+    c->out.len -= c->out.pos;
+    c->out.pos = 0;
+  }
+  if (c->out.len + len > c->out.size) {
+    c->out.size = max(c->out.size * 2, c->out.len + len);
+    c->out.data = renewn(c->out.data, c->out.size);
+  }
+}
+
+enum { PROCESS_CHUNK = 4096, PROCESS_TICKS = 50 };
+
+static uint
+in_limit(void)
+{ return max(cfg.output_buffer_limit, 16) * 1024; }
+
+static void
+queue_in(child *c, const char *buf, uint len)
+{
+  if (c->in.len + len > c->in.size && c->in.pos) {
+    memmove(c->in.data, c->in.data + c->in.pos, c->in.len - c->in.pos);
+    c->in.len -= c->in.pos;
+    c->in.pos = 0;
+  }
+  if (c->in.len + len > c->in.size) {
+    c->in.size = max(c->in.size * 2, c->in.len + len);
+    c->in.data = renewn(c->in.data, c->in.size);
+  }
+  memcpy(c->in.data + c->in.len, buf, len);
+  c->in.len += len;
+  if (c->in.len - c->in.pos >= in_limit())
+    c->in.throttled = true;
+}
+
+/*
+ * Process a chunk of buffered output, with the child's terminal current.
+ * Returns whether there's more.
+ */
+static bool
+process_chunk(child *c)
+{
+  uint len = min(c->in.len - c->in.pos, (uint)PROCESS_CHUNK);
+  term_write(c->in.data + c->in.pos, len);
+  c->in.pos += len;
+  if (c->in.pos == c->in.len) {
+    c->in.pos = c->in.len = 0;
+    c->in.throttled = false;
+    return false;
+  }
+  if (c->in.throttled && c->in.len - c->in.pos <= in_limit() / 2)
+    c->in.throttled = false;
+  return true;
+}
+
+/* Number of bytes read from the pty that haven't been processed yet. */
+uint
+child_read_backlog(void)
+{
+  child *c = get_child();
+  return c ? c->in.len - c->in.pos : 0;
+}
+
+static void
+flush_out(child *c)
+{
+  while (c->out.pos < c->out.len) {
+    int ret = write(c->pty_fd, c->out.data + c->out.pos,
+                    c->out.len - c->out.pos);
+    if (ret <= 0)
+      return;
+    c->out.pos += ret;
+  }
+  c->out.pos = c->out.len = 0;
+}
 
 static void
 error(char *action)
@@ -51,17 +182,41 @@ error(char *action)
 static void
 sigexit(int sig)
 {
-  if (pid)
-    kill(-pid, SIGHUP);
+  for (child *c = children; c; c = c->next) {
+    if (c->pid)
+      kill(-c->pid, SIGHUP);
+  }
   signal(sig, SIG_DFL);
   kill(getpid(), sig);
 }
 
+static void
+free_child(child *c)
+{
+  child **pp = &children;
+  while (*pp != c)
+    pp = &(*pp)->next;
+  *pp = c->next;
+  if (cur_child == c)
+    cur_child = 0;
+  free(c->in.data);
+  free(c->out.data);
+  free(c);
+}
+
 void
 child_create(char *argv[], struct winsize *winp)
 {
   string lang = cs_lang();
 
+  child *c = newn(child, 1);
+  c->term = term;
+  c->pty_fd = c->log_fd = -1;
+  child **pp = &children;
+  while (*pp)
+    pp = &(*pp)->next;
+  *pp = c;
+
   // xterm and urxvt ignore SIGHUP, so let's do the same.
   signal(SIGHUP, SIG_IGN);
   
@@ -70,9 +225,9 @@ child_create(char *argv[], struct winsize *winp)
   signal(SIGQUIT, sigexit);
   
   // Create the child process and pseudo terminal.
-  pid = forkpty(&pty_fd, 0, 0, winp);
+  pid_t pid = c->pid = forkpty(&c->pty_fd, 0, 0, winp);
   if (pid < 0) {
-    pid = 0;
+    c->pid = 0;
     bool rebase_prompt = (errno == EAGAIN);
     error("fork child process");
     if (rebase_prompt) {
@@ -155,10 +310,13 @@ child_create(char *argv[], struct winsize *winp)
     exit(255);
   }
   else { // Parent process.
-    fcntl(pty_fd, F_SETFL, O_NONBLOCK);
+    fcntl(c->pty_fd, F_SETFL, O_NONBLOCK);
+
+    // Don't let the children of other panes inherit the pty.
+    fcntl(c->pty_fd, F_SETFD, FD_CLOEXEC);
     
     if (cfg.utmp) {
-      char *dev = ptsname(pty_fd);
+      char *dev = ptsname(c->pty_fd);
       if (dev) {
         struct utmp ut;
         memset(&ut, 0, sizeof ut);
@@ -183,88 +341,149 @@ child_create(char *argv[], struct winsize *winp)
     }
   }
 
-  win_fd = open("/dev/windows", O_RDONLY);
+  if (win_fd < 0)
+    win_fd = open("/dev/windows", O_RDONLY);
 
-  // Open log file if any
-  if (*cfg.log) {
+  // Open log file if any. Only the first child's output is logged.
+  if (*cfg.log && c == children && !c->next) {
     if (!strcmp(cfg.log, "-"))
-      log_fd = fileno(stdout);
+      c->log_fd = fileno(stdout);
     else {
-      log_fd = open(cfg.log, O_WRONLY | O_CREAT | O_TRUNC, 0600);
-      if (log_fd < 0)
+      c->log_fd = open(cfg.log, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+      if (c->log_fd < 0)
         error("open log file");
     }
   }
 }
 
+/*
+ * Deal with the exit of the current terminal's child by exiting, closing
+ * its pane, or holding the pane open with the exit status shown.
+ * Returns whether the pane was closed.
+ */
+static bool
+child_exited(int status)
+{
+  bool done;
+  if (killed || cfg.hold == HOLD_NEVER)
+    done = true;
+  else if (cfg.hold == HOLD_START)
+    done = WIFSIGNALED(status) || WEXITSTATUS(status) != 255;
+  else if (cfg.hold == HOLD_ERROR) {
+    if (WIFEXITED(status))
+      done = WEXITSTATUS(status) == 0;
+    else {
+      const int error_sigs =
+        1<<SIGILL | 1<<SIGTRAP | 1<<SIGABRT | 1<<SIGFPE | 
+        1<<SIGBUS | 1<<SIGSEGV | 1<<SIGPIPE | 1<<SIGSYS;
+      done = !(error_sigs & 1<<WTERMSIG(status));
+    }
+  }
+  else
+    done = false;
+
+  if (done) {
+    bool others = false;
+    for (child *c = children; c; c = c->next)
+      others |= c->term && c->term != term;
+    if (killed || !others)
+      exit(0);
+    win_close_pane();
+    return true;
+  }
+
+  int l = 0;
+  char *s = 0; 
+  if (WIFEXITED(status)) {
+    int code = WEXITSTATUS(status);
+    if (code && cfg.hold != HOLD_START)
+      l = asprintf(&s, "%s: Exit %i", cmd, code); 
+  }
+  else if (WIFSIGNALED(status))
+    l = asprintf(&s, "%s: %s", cmd, strsignal(WTERMSIG(status)));
+
+  if (s)
+    term_write(s, l);
+  return false;
+}
+
 void
 child_proc(void)
 {
+  // The active pane's terminal, which is current between children.
+  term_t *active = term;
+
   for (;;) {
-    if (term.paste_buffer)
-      term_send_paste();
+    for (child *c = children; c; c = c->next) {
+      if (!c->term)
+        continue;
+      term = c->term;
+      if (term->paste_buffer)
+        term_send_paste();
+      if (c->pty_fd >= 0)
+        flush_out(c);
+    }
+    term = active;
 
     struct timeval timeout = {0, 100000}, *timeout_p = 0;
-    fd_set fds;
+    fd_set fds, wfds;
     FD_ZERO(&fds);
+    FD_ZERO(&wfds);
     FD_SET(win_fd, &fds);  
-    if (pty_fd >= 0)
-      FD_SET(pty_fd, &fds);
-    else if (pid) {
-      int status;
-      if (waitpid(pid, &status, WNOHANG) == pid) {
-        pid = 0;
-        
-        // Decide whether we want to exit now or later
-        if (killed || cfg.hold == HOLD_NEVER)
-          exit(0);
-        else if (cfg.hold == HOLD_START) {
-          if (WIFSIGNALED(status) || WEXITSTATUS(status) != 255)
-            exit(0);
-        }
-        else if (cfg.hold == HOLD_ERROR) {
-          if (WIFEXITED(status)) {
-            if (WEXITSTATUS(status) == 0)
-              exit(0);
-          }
+    int max_fd = win_fd;
+    for (child *c = children, *next; c; c = next) {
+      next = c->next;
+      if (c->pty_fd >= 0) {
+        if (!c->in.throttled)
+          FD_SET(c->pty_fd, &fds);
+        if (c->out.pos < c->out.len)
+          FD_SET(c->pty_fd, &wfds);
+        max_fd = max(max_fd, c->pty_fd);
+      }
+      else if (c->pid && c->in.pos == c->in.len) {
+        // Only reap the child once the output it left behind has been
+        // processed, so that it comes before any exit message.
+        int status;
+        if (waitpid(c->pid, &status, WNOHANG) == c->pid) {
+          c->pid = 0;
+          if (!c->term)
+            free_child(c);  // its pane has been closed already
           else {
-            const int error_sigs =
-              1<<SIGILL | 1<<SIGTRAP | 1<<SIGABRT | 1<<SIGFPE | 
-              1<<SIGBUS | 1<<SIGSEGV | 1<<SIGPIPE | 1<<SIGSYS;
-            if (!(error_sigs & 1<<WTERMSIG(status)))
-              exit(0);
+            term = c->term;
+            if (child_exited(status))
+              active = term;
+            else
+              term = active;
           }
         }
-      
-        int l = 0;
-        char *s = 0; 
-        if (WIFEXITED(status)) {
-          int code = WEXITSTATUS(status);
-          if (code && cfg.hold != HOLD_START)
-            l = asprintf(&s, "%s: Exit %i", cmd, code); 
-        }
-        else if (WIFSIGNALED(status))
-          l = asprintf(&s, "%s: %s", cmd, strsignal(WTERMSIG(status)));
-
-        if (s)
-          term_write(s, l);
+        else // Pty gone, but process still there: keep checking
+          timeout_p = &timeout;
       }
-      else // Pty gone, but process still there: keep checking
-        timeout_p = &timeout;
     }
     
-    if (select(win_fd + 1, &fds, 0, 0, timeout_p) > 0) {
-      if (pty_fd >= 0 && FD_ISSET(pty_fd, &fds)) {
+    // Don't wait if there's output left to process.
+    struct timeval no_wait = {0, 0};
+    for (child *c = children; c; c = c->next) {
+      if (c->in.pos < c->in.len)
+        timeout_p = &no_wait;
+    }
+
+    bool win_ready = false;
+    if (select(max_fd + 1, &fds, &wfds, 0, timeout_p) > 0) {
+      for (child *c = children; c; c = c->next) {
+        if (c->pty_fd < 0 || !FD_ISSET(c->pty_fd, &fds))
+          continue;
+        long long start = trace_begin();
 #if CYGWIN_VERSION_DLL_MAJOR >= 1005
         static char buf[4096];
-        int len = read(pty_fd, buf, sizeof buf);
+        int len = read(c->pty_fd, buf, sizeof buf);
 #else
         // Pty devices on old Cygwin version deliver only 4 bytes at a time,
         // so call read() repeatedly until we have a worthwhile haul.
         static char buf[512];
         uint len = 0;
         do {
-          int ret = read(pty_fd, buf + len, sizeof buf - len);
+          int ret = read(c->pty_fd, buf + len, sizeof buf - len);
           if (ret > 0)
             len += ret;
           else
@@ -272,17 +491,46 @@ child_proc(void)
         } while (len < sizeof buf);
 #endif
         if (len > 0) {
-          term_write(buf, len);
-          if (log_fd >= 0)
-            write(log_fd, buf, len);
+          term = c->term;
+          trace_latency(LAT_READ);
+          term = active;
+          count(CNT_READ, len);
+          trace_end("read", start, len);
+          queue_in(c, buf, len);
+          if (c->log_fd >= 0)
+            write(c->log_fd, buf, len);
         }
         else {
-          pty_fd = -1;
+          close(c->pty_fd);
+          c->pty_fd = -1;
+          c->out.pos = c->out.len = 0;
+          term = c->term;
           term_hide_cursor();
+          term = active;
         }
       }
-      if (FD_ISSET(win_fd, &fds))
-        return;
+      win_ready = FD_ISSET(win_fd, &fds);
+    }
+
+    // Process the output of each child a chunk at a time in turn, so that
+    // a busy child doesn't hold up the others.
+    int start = get_tick_count();
+    bool more;
+    do {
+      more = false;
+      for (child *c = children; c; c = c->next) {
+        if (c->in.pos < c->in.len) {
+          term = c->term;
+          more |= process_chunk(c);
+        }
+      }
+      term = active;
+    } while (more && get_tick_count() - start < PROCESS_TICKS);
+
+    // Let the window catch up if processing takes too long.
+    if (more || win_ready) {
+      term_update_cs();  // for the active pane's input
+      return;
     }
   }
 }
@@ -290,23 +538,54 @@ child_proc(void)
 void
 child_kill(bool point_blank)
 { 
-  if (!pid ||
-      kill(-pid, point_blank ? SIGKILL : SIGHUP) < 0 || 
-      point_blank)
+  bool alive = false;
+  for (child *c = children; c; c = c->next) {
+    if (c->term && c->pid &&
+        kill(-c->pid, point_blank ? SIGKILL : SIGHUP) >= 0)
+      alive = true;
+  }
+  if (!alive || point_blank)
     exit(0);
   killed = true;
 }
 
+/*
+ * Hang up on the current terminal's child, for closing its pane. The
+ * process is reaped later.
+ */
+void
+child_free(void)
+{
+  child *c = get_child();
+  if (!c)
+    return;
+  if (c->pty_fd >= 0)
+    close(c->pty_fd);
+  if (c->log_fd >= 0 && c->log_fd != fileno(stdout))
+    close(c->log_fd);
+  if (c->pid) {
+    kill(-c->pid, SIGHUP);
+    c->term = 0;
+    c->pty_fd = c->log_fd = -1;
+    c->in.pos = c->in.len = c->out.pos = c->out.len = 0;
+    cur_child = 0;
+  }
+  else
+    free_child(c);
+}
+
 bool
 child_is_alive(void)
 {
-    return pid;
+  child *c = get_child();
+  return c && c->pid;
 }
 
 bool
 child_is_parent(void)
 {
-  if (!pid)
+  child *c = get_child();
+  if (!c || !c->pid)
     return false;
   DIR *d = opendir("/proc");
   if (!d)
@@ -324,7 +603,7 @@ child_is_parent(void)
       pid_t ppid = 0;
       fscanf(f, "%u", &ppid);
       fclose(f);
-      if (ppid == pid) {
+      if (ppid == c->pid) {
         res = true;
         break;
       }
@@ -337,30 +616,51 @@ child_is_parent(void)
 void
 child_write(const char *buf, uint len)
 { 
-  if (pty_fd >= 0)
-    write(pty_fd, buf, len);
+  child *c = get_child();
+  if (c && c->pty_fd >= 0) {
+    reserve_out(c, len);
+    memcpy(c->out.data + c->out.len, buf, len);
+    c->out.len += len;
+  }
+}
+
+/* Number of bytes waiting for the pty to accept them. */
+uint
+child_write_backlog(void)
+{
+  child *c = get_child();
+  return c ? c->out.len - c->out.pos : 0;
 }
 
 void
 child_printf(const char *fmt, ...)
 {
-  if (pty_fd >= 0) {
-    va_list va;
-    va_start(va, fmt);
-    char *s;
-    int len = vasprintf(&s, fmt, va);
-    va_end(va);
-    if (len >= 0)
-      write(pty_fd, s, len);
-    free(s);
+  child *c = get_child();
+  if (c && c->pty_fd >= 0) {
+    // Format straight into the output queue, growing it if necessary.
+    for (;;) {
+      uint avail = c->out.size - c->out.len;
+      va_list va;
+      va_start(va, fmt);
+      int len = vsnprintf(c->out.data + c->out.len, avail, fmt, va);
+      va_end(va);
+      if (len < 0)
+        return;
+      if ((uint)len < avail) {
+        c->out.len += len;
+        return;
+      }
+      reserve_out(c, len + 1);
+    }
   }
 }
 
 void
 child_send(const char *buf, uint len)
 {
+  trace_latency(LAT_SEND);
   term_reset_screen();
-  if (term.echoing)
+  if (term->echoing)
     term_write(buf, len);
   child_write(buf, len);
 }
@@ -368,17 +668,27 @@ child_send(const char *buf, uint len)
 void
 child_sendw(const wchar *ws, uint wlen)
 {
-  char s[wlen * cs_cur_max];
-  int len = cs_wcntombn(s, ws, sizeof s, wlen);
-  if (len > 0)
-    child_send(s, len);
+  // Convert in chunks, so that the stack buffer stays small,
+  // but without splitting surrogate pairs.
+  while (wlen) {
+    uint n = min(wlen, 1024u);
+    if (n < wlen && is_high_surrogate(ws[n - 1]))
+      n--;
+    char s[n * cs_cur_max];
+    int len = cs_wcntombn(s, ws, sizeof s, n);
+    if (len > 0)
+      child_send(s, len);
+    ws += n;
+    wlen -= n;
+  }
 }
 
 void
 child_resize(struct winsize *winp)
 { 
-  if (pty_fd >= 0)
-    ioctl(pty_fd, TIOCSWINSZ, winp);
+  child *c = get_child();
+  if (c && c->pty_fd >= 0)
+    ioctl(c->pty_fd, TIOCSWINSZ, winp);
 }
 
 wstring
@@ -420,9 +730,10 @@ child_conv_path(wstring wpath)
     // requires the /proc filesystem, which isn't available before Cygwin 1.5.
     
     // Find pty's foreground process, if any. Fall back to child process.
-    int fg_pid = (pty_fd >= 0) ? tcgetpgrp(pty_fd) : 0;
-    if (fg_pid <= 0)
-      fg_pid = pid;
+    child *c = get_child();
+    int fg_pid = (c && c->pty_fd >= 0) ? tcgetpgrp(c->pty_fd) : 0;
+    if (fg_pid <= 0 && c)
+      fg_pid = c->pid;
     
     char *cwd = 0;
     if (fg_pid > 0) {
@@ -479,10 +790,12 @@ void
 child_fork(char *argv[])
 {
   if (fork() == 0) {
-    if (pty_fd >= 0)
-      close(pty_fd);
-    if (log_fd >= 0)
-      close(log_fd);
+    for (child *c = children; c; c = c->next) {
+      if (c->pty_fd >= 0)
+        close(c->pty_fd);
+      if (c->log_fd >= 0)
+        close(c->log_fd);
+    }
     close(win_fd);
 
 #if CYGWIN_VERSION_DLL_MAJOR >= 1005
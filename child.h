@@ -2,13 +2,17 @@
 #define CHILD_H
 
 #include <sys/termios.h>
+#include <sys/ioctl.h>
 
 extern char *home, *cmd;
 
 void child_create(char *argv[], struct winsize *winp);
+void child_free(void);
 void child_proc(void);
+uint child_read_backlog(void);
 void child_kill(bool point_blank);
 void child_write(const char *, uint len);
+uint child_write_backlog(void);
 void child_printf(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
 void child_send(const char *, uint len);
 void child_sendw(const wchar *, uint len);
@@ -95,6 +95,14 @@ const config default_cfg = {
   .word_chars = "",
   .use_system_colours = false,
   .ime_cursor_colour = DEFAULT_COLOUR,
+  .glyph_cache_dir = "",
+  .mouse_motion_rate = 60,
+  .output_buffer_limit = 1024,
+  .latency_trace = false,
+  .latency_log = "",
+  .perf_counters = false,
+  .trace_spans = false,
+  .trace_file = "",
   .ansi_colours = {
     [BLACK_I]        = 0x000000,
     [RED_I]          = 0x0000BF,
@@ -216,6 +224,14 @@ options[] = {
   {"RowSpacing", OPT_INT, offcfg(row_spacing)},
   {"WordChars", OPT_STRING, offcfg(word_chars)},
   {"IMECursorColour", OPT_COLOUR, offcfg(ime_cursor_colour)},
+  {"GlyphCacheDir", OPT_STRING, offcfg(glyph_cache_dir)},
+  {"MouseMotionRate", OPT_INT, offcfg(mouse_motion_rate)},
+  {"OutputBufferLimit", OPT_INT, offcfg(output_buffer_limit)},
+  {"LatencyTrace", OPT_BOOL, offcfg(latency_trace)},
+  {"LatencyLog", OPT_STRING, offcfg(latency_log)},
+  {"PerfCounters", OPT_BOOL, offcfg(perf_counters)},
+  {"TraceSpans", OPT_BOOL, offcfg(trace_spans)},
+  {"TraceFile", OPT_STRING, offcfg(trace_file)},
   
   // ANSI colours
   {"Black", OPT_COLOUR, offcfg(ansi_colours[BLACK_I])},
@@ -937,8 +953,8 @@ static void
 current_size_handler(control *unused(ctrl), int event)
 {
   if (event == EVENT_ACTION) {
-    new_cfg.cols = term.cols;
-    new_cfg.rows = term.rows;
+    new_cfg.cols = term->cols;
+    new_cfg.rows = term->rows;
     dlg_refresh(cols_box);
     dlg_refresh(rows_box);
   }
@@ -27,6 +27,15 @@ static inline uchar red(colour c) { return c; }
 static inline uchar green(colour c) { return c >> 8; }
 static inline uchar blue(colour c) { return c >> 16; }
 
+static inline uint
+colour_dist(colour a, colour b)
+{
+  return
+    2 * sqr(red(a) - red(b)) +
+    4 * sqr(green(a) - green(b)) +
+    1 * sqr(blue(a) - blue(b));
+}
+
 const char *THEME_DIR;
 
 // Font properties.
@@ -100,6 +109,14 @@ typedef struct {
   int col_spacing, row_spacing;
   string word_chars;
   colour ime_cursor_colour;
+  string glyph_cache_dir;
+  int mouse_motion_rate;
+  int output_buffer_limit;
+  bool latency_trace;
+  string latency_log;
+  bool perf_counters;
+  bool trace_spans;
+  string trace_file;
   colour ansi_colours[16];
   // Legacy
   bool use_system_colours;
@@ -0,0 +1,80 @@
+// counters.c (part of mintty)
+// Licensed under the terms of the GNU General Public License v3 or later.
+
+#include "counters.h"
+
+#include "termpriv.h"
+#include "child.h"
+
+#include <time.h>
+
+bool counting;
+long long counters[CNT_NUM];
+long long csi_counts[0x40], osc_counts[CNT_OSC_OTHER + 1];
+
+static const char *counter_names[CNT_NUM] = {
+  "read", "parsed", "cells", "esc", "csi", "osc", "dcs", "scrolled",
+  "compress", "compress_us", "decompress", "decompress_us",
+  "paint", "paint_us", "text", "text_chars", "bidi_hit", "bidi_miss", "alloc"
+};
+
+long long
+counter_clock(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+void
+counters_enable(bool enable)
+{
+  if (enable) {
+    memset(counters, 0, sizeof counters);
+    memset(csi_counts, 0, sizeof csi_counts);
+    memset(osc_counts, 0, sizeof osc_counts);
+  }
+  counting = enable;
+}
+
+char *
+counters_report(void)
+{
+  size_t size = 256, len = 0;
+  char *report = newn(char, size);
+
+  void add(const char *fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(report + len, size - len, fmt, ap);
+    va_end(ap);
+    if (len + n >= size) {
+      size = (len + n) * 2;
+      report = renewn(report, size);
+      va_start(ap, fmt);
+      vsnprintf(report + len, size - len, fmt, ap);
+      va_end(ap);
+    }
+    len += n;
+  }
+
+  add("enabled=%i", counting);
+  for (uint i = 0; i < CNT_NUM; i++) {
+    bool time = strstr(counter_names[i], "_us");
+    add(";%s=%lli", counter_names[i], counters[i] / (time ? 1000 : 1));
+  }
+  for (uint i = 0; i < lengthof(csi_counts); i++) {
+    if (csi_counts[i])
+      add(";csi.%c=%lli", 0x40 | i, csi_counts[i]);
+  }
+  for (uint i = 0; i < CNT_OSC_OTHER; i++) {
+    if (osc_counts[i])
+      add(";osc.%u=%lli", i, osc_counts[i]);
+  }
+  if (osc_counts[CNT_OSC_OTHER])
+    add(";osc.other=%lli", osc_counts[CNT_OSC_OTHER]);
+
+  add(";sblines=%i;sbbytes=%lli", term->sblines, term->sbbytes);
+  add(";inbuf=%u;outbuf=%u", child_read_backlog(), child_write_backlog());
+  return report;
+}
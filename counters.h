@@ -0,0 +1,91 @@
+#ifndef COUNTERS_H
+#define COUNTERS_H
+
+/*
+ * Performance counters.
+ *
+ * Counting is off by default, which leaves each counting point with the
+ * cost of testing a flag. Times are in nanoseconds. The counters cover
+ * all terminals in the process.
+ */
+
+typedef enum {
+  CNT_READ,             // bytes read from the child
+  CNT_PARSED,           // bytes processed by the terminal
+  CNT_CELLS,            // characters written to the screen
+  CNT_ESC,              // escape sequences
+  CNT_CSI,              // control sequences, also counted by final byte
+  CNT_OSC,              // operating system commands, also counted by number
+  CNT_DCS,              // device control strings
+  CNT_SCROLLED,         // lines scrolled
+  CNT_COMPRESS,         // lines compressed
+  CNT_COMPRESS_TIME,
+  CNT_DECOMPRESS,       // lines decompressed
+  CNT_DECOMPRESS_TIME,
+  CNT_PAINT,            // terminal paints
+  CNT_PAINT_TIME,
+  CNT_TEXT,             // text runs drawn
+  CNT_TEXT_CHARS,       // characters in those runs
+  CNT_BIDI_HIT,         // bidi cache lookups
+  CNT_BIDI_MISS,
+  CNT_ALLOC,            // line buffers allocated
+  CNT_NUM
+} counter;
+
+// OSC numbers from this up are counted together.
+enum { CNT_OSC_OTHER = 127 };
+
+extern bool counting;
+extern long long counters[CNT_NUM];
+extern long long csi_counts[0x40], osc_counts[CNT_OSC_OTHER + 1];
+
+long long counter_clock(void);
+
+static inline void
+count(counter c, long long n)
+{
+  if (counting)
+    counters[c] += n;
+}
+
+static inline void
+count_csi(uchar final)
+{
+  if (counting) {
+    counters[CNT_CSI]++;
+    csi_counts[final & 0x3F]++;
+  }
+}
+
+static inline void
+count_osc(int num)
+{
+  if (counting) {
+    counters[CNT_OSC]++;
+    osc_counts[num >= 0 && num < CNT_OSC_OTHER ? num : CNT_OSC_OTHER]++;
+  }
+}
+
+// Start timing, returning 0 if counting is off.
+static inline long long
+count_start(void)
+{
+  return counting ? counter_clock() : 0;
+}
+
+// Add the time since count_start() to a counter.
+static inline void
+count_time(counter c, long long start)
+{
+  if (counting && start)
+    counters[c] += counter_clock() - start;
+}
+
+// Enabling starts afresh; disabling keeps the results.
+void counters_enable(bool);
+
+// The counters as "NAME=VALUE;...", omitting the breakdowns that are zero.
+// Times are reported in microseconds.
+char *counters_report(void);
+
+#endif
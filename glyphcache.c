@@ -0,0 +1,204 @@
+// glyphcache.c (part of mintty)
+// Licensed under the terms of the GNU General Public License v3 or later.
+
+#include "glyphcache.h"
+
+/*
+ * Characters are looked up in pages of 256, which are allocated when
+ * first used. Each page has bitmaps of which of its characters have been
+ * measured, which have been checked for a glyph, and which have one,
+ * plus a table of the measured widths.
+ */
+enum {
+  PAGE_BITS = 8,
+  PAGE_SIZE = 1 << PAGE_BITS,
+  PAGE_NUM = 0x110000 >> PAGE_BITS,
+  MAP_WORDS = PAGE_SIZE / 32
+};
+
+typedef struct {
+  uint measured[MAP_WORDS];
+  uint checked[MAP_WORDS];
+  uint covered[MAP_WORDS];
+  uchar widths[PAGE_SIZE];
+} glyph_page;
+
+struct glyph_cache {
+  glyph_measurer measurer;
+  string font_name;
+  int font_size;
+  bool dirty;
+  glyph_page *pages[PAGE_NUM];
+};
+
+static const char magic[] = "mintty glyph cache 1\n";
+
+static inline bool
+get_bit(const uint *map, uint i)
+{ return map[i / 32] >> (i % 32) & 1; }
+
+static inline void
+set_bit(uint *map, uint i, bool val)
+{
+  if (val)
+    map[i / 32] |= 1u << (i % 32);
+  else
+    map[i / 32] &= ~(1u << (i % 32));
+}
+
+static glyph_page *
+get_page(glyph_cache *gc, xchar c)
+{
+  if (c >= 0x110000)
+    return 0;
+  glyph_page **pp = &gc->pages[c >> PAGE_BITS];
+  if (!*pp) {
+    *pp = new(glyph_page);
+    memset(*pp, 0, sizeof **pp);
+  }
+  return *pp;
+}
+
+glyph_cache *
+glyph_cache_new(glyph_measurer measurer, string font_name, int font_size)
+{
+  glyph_cache *gc = new(glyph_cache);
+  memset(gc, 0, sizeof *gc);
+  gc->measurer = measurer;
+  gc->font_name = strdup(font_name);
+  gc->font_size = font_size;
+  return gc;
+}
+
+void
+glyph_cache_free(glyph_cache *gc)
+{
+  if (!gc)
+    return;
+  for (uint i = 0; i < PAGE_NUM; i++)
+    delete(gc->pages[i]);
+  delete(gc->font_name);
+  delete(gc);
+}
+
+int
+glyph_cache_width(glyph_cache *gc, xchar c)
+{
+  glyph_page *page = get_page(gc, c);
+  if (!page) {
+    uchar width;
+    gc->measurer.widths(gc->measurer.ctx, c, 1, &width);
+    return width;
+  }
+  uint i = c % PAGE_SIZE;
+  if (!get_bit(page->measured, i)) {
+    // Measure the whole page in one go, as measuring has a setup cost.
+    gc->measurer.widths(gc->measurer.ctx, c - i, PAGE_SIZE, page->widths);
+    memset(page->measured, 0xFF, sizeof page->measured);
+    gc->dirty = true;
+  }
+  return page->widths[i];
+}
+
+/*
+ * Zeroes each of the characters in the array that the font doesn't have a
+ * glyph for. Characters that haven't been checked before are passed to the
+ * measurer in a single batch.
+ */
+void
+glyph_cache_check(glyph_cache *gc, wchar *wcs, uint num)
+{
+  wchar unchecked[num];
+  uint n = 0;
+  for (uint i = 0; i < num; i++) {
+    glyph_page *page = get_page(gc, wcs[i]);
+    if (!get_bit(page->checked, wcs[i] % PAGE_SIZE))
+      unchecked[n++] = wcs[i];
+  }
+
+  if (n) {
+    bool has[n];
+    memset(has, 0, sizeof has);
+    gc->measurer.coverage(gc->measurer.ctx, unchecked, n, has);
+    for (uint i = 0; i < n; i++) {
+      glyph_page *page = get_page(gc, unchecked[i]);
+      set_bit(page->checked, unchecked[i] % PAGE_SIZE, true);
+      set_bit(page->covered, unchecked[i] % PAGE_SIZE, has[i]);
+    }
+    gc->dirty = true;
+  }
+
+  for (uint i = 0; i < num; i++) {
+    glyph_page *page = get_page(gc, wcs[i]);
+    if (!get_bit(page->covered, wcs[i] % PAGE_SIZE))
+      wcs[i] = 0;
+  }
+}
+
+/*
+ * The file name keeps letters and digits from the font name and
+ * hex-encodes everything else, so that different names can't collide.
+ */
+static char *
+cache_path(glyph_cache *gc, string dir)
+{
+  char *path = newn(char, strlen(dir) + strlen(gc->font_name) * 3 + 32);
+  char *p = path + sprintf(path, "%s/", dir);
+  for (string s = gc->font_name; *s; s++) {
+    if (isalnum((uchar)*s))
+      *p++ = *s;
+    else
+      p += sprintf(p, "_%02X", (uchar)*s);
+  }
+  sprintf(p, "-%d.glyphs", gc->font_size);
+  return path;
+}
+
+bool
+glyph_cache_load(glyph_cache *gc, string dir)
+{
+  char *path = cache_path(gc, dir);
+  FILE *file = fopen(path, "rb");
+  delete(path);
+  if (!file)
+    return false;
+
+  char buf[sizeof magic - 1];
+  bool ok =
+    fread(buf, sizeof buf, 1, file) == 1 && !memcmp(buf, magic, sizeof buf);
+  uint i;
+  while (ok && fread(&i, sizeof i, 1, file) == 1) {
+    glyph_page page;
+    ok = i < PAGE_NUM && fread(&page, sizeof page, 1, file) == 1;
+    if (ok)
+      *get_page(gc, i << PAGE_BITS) = page;
+  }
+  fclose(file);
+  gc->dirty = false;
+  return ok;
+}
+
+bool
+glyph_cache_save(glyph_cache *gc, string dir)
+{
+  if (!gc->dirty)
+    return true;
+
+  char *path = cache_path(gc, dir);
+  FILE *file = fopen(path, "wb");
+  delete(path);
+  if (!file)
+    return false;
+
+  bool ok = fwrite(magic, sizeof magic - 1, 1, file) == 1;
+  for (uint i = 0; ok && i < PAGE_NUM; i++) {
+    if (gc->pages[i]) {
+      ok = fwrite(&i, sizeof i, 1, file) == 1 &&
+           fwrite(gc->pages[i], sizeof *gc->pages[i], 1, file) == 1;
+    }
+  }
+  ok = !fclose(file) && ok;
+  if (ok)
+    gc->dirty = false;
+  return ok;
+}
@@ -0,0 +1,32 @@
+#ifndef GLYPHCACHE_H
+#define GLYPHCACHE_H
+
+/*
+ * Cache of character widths and glyph coverage for a font.
+ *
+ * The actual measuring is done by the front end through a glyph_measurer,
+ * so the cache logic doesn't depend on any particular font API.
+ */
+
+typedef struct {
+  void *ctx;
+  // Set widths[i] to the width in cells of character first + i, or to 0
+  // if it can't be measured.
+  void (*widths)(void *ctx, xchar first, uint num, uchar *widths);
+  // Set has[i] for each of the num characters that have a glyph.
+  void (*coverage)(void *ctx, const wchar *, uint num, bool *has);
+} glyph_measurer;
+
+typedef struct glyph_cache glyph_cache;
+
+glyph_cache *glyph_cache_new(glyph_measurer, string font_name, int font_size);
+void glyph_cache_free(glyph_cache *);
+
+int glyph_cache_width(glyph_cache *, xchar);
+void glyph_cache_check(glyph_cache *, wchar *wcs, uint num);
+
+// Persistence, in a file named after the font in the given directory.
+bool glyph_cache_load(glyph_cache *, string dir);
+bool glyph_cache_save(glyph_cache *, string dir);
+
+#endif
@@ -0,0 +1,1431 @@
+// Generated by scripts/mkgcbtable.pl from Unicode 14.0.0 data.
+// Grapheme cluster break properties of non-ASCII characters,
+// as ranges sorted by code point. Unlisted characters are GCB_Other.
+  {0x0080, 0x009F, GCB_Control},
+  {0x00A9, 0x00A9, GCB_ExtPict},
+  {0x00AD, 0x00AD, GCB_Control},
+  {0x00AE, 0x00AE, GCB_ExtPict},
+  {0x0300, 0x036F, GCB_Extend},
+  {0x0483, 0x0489, GCB_Extend},
+  {0x0591, 0x05BD, GCB_Extend},
+  {0x05BF, 0x05BF, GCB_Extend},
+  {0x05C1, 0x05C2, GCB_Extend},
+  {0x05C4, 0x05C5, GCB_Extend},
+  {0x05C7, 0x05C7, GCB_Extend},
+  {0x0600, 0x0605, GCB_Prepend},
+  {0x0610, 0x061A, GCB_Extend},
+  {0x061C, 0x061C, GCB_Control},
+  {0x064B, 0x065F, GCB_Extend},
+  {0x0670, 0x0670, GCB_Extend},
+  {0x06D6, 0x06DC, GCB_Extend},
+  {0x06DD, 0x06DD, GCB_Prepend},
+  {0x06DF, 0x06E4, GCB_Extend},
+  {0x06E7, 0x06E8, GCB_Extend},
+  {0x06EA, 0x06ED, GCB_Extend},
+  {0x070F, 0x070F, GCB_Prepend},
+  {0x0711, 0x0711, GCB_Extend},
+  {0x0730, 0x074A, GCB_Extend},
+  {0x07A6, 0x07B0, GCB_Extend},
+  {0x07EB, 0x07F3, GCB_Extend},
+  {0x07FD, 0x07FD, GCB_Extend},
+  {0x0816, 0x0819, GCB_Extend},
+  {0x081B, 0x0823, GCB_Extend},
+  {0x0825, 0x0827, GCB_Extend},
+  {0x0829, 0x082D, GCB_Extend},
+  {0x0859, 0x085B, GCB_Extend},
+  {0x0890, 0x0891, GCB_Prepend},
+  {0x0898, 0x089F, GCB_Extend},
+  {0x08CA, 0x08E1, GCB_Extend},
+  {0x08E2, 0x08E2, GCB_Prepend},
+  {0x08E3, 0x0902, GCB_Extend},
+  {0x0903, 0x0903, GCB_SpacingMark},
+  {0x093A, 0x093A, GCB_Extend},
+  {0x093B, 0x093B, GCB_SpacingMark},
+  {0x093C, 0x093C, GCB_Extend},
+  {0x093E, 0x0940, GCB_SpacingMark},
+  {0x0941, 0x0948, GCB_Extend},
+  {0x0949, 0x094C, GCB_SpacingMark},
+  {0x094D, 0x094D, GCB_Extend},
+  {0x094E, 0x094F, GCB_SpacingMark},
+  {0x0951, 0x0957, GCB_Extend},
+  {0x0962, 0x0963, GCB_Extend},
+  {0x0981, 0x0981, GCB_Extend},
+  {0x0982, 0x0983, GCB_SpacingMark},
+  {0x09BC, 0x09BC, GCB_Extend},
+  {0x09BE, 0x09BE, GCB_Extend},
+  {0x09BF, 0x09C0, GCB_SpacingMark},
+  {0x09C1, 0x09C4, GCB_Extend},
+  {0x09C7, 0x09C8, GCB_SpacingMark},
+  {0x09CB, 0x09CC, GCB_SpacingMark},
+  {0x09CD, 0x09CD, GCB_Extend},
+  {0x09D7, 0x09D7, GCB_Extend},
+  {0x09E2, 0x09E3, GCB_Extend},
+  {0x09FE, 0x09FE, GCB_Extend},
+  {0x0A01, 0x0A02, GCB_Extend},
+  {0x0A03, 0x0A03, GCB_SpacingMark},
+  {0x0A3C, 0x0A3C, GCB_Extend},
+  {0x0A3E, 0x0A40, GCB_SpacingMark},
+  {0x0A41, 0x0A42, GCB_Extend},
+  {0x0A47, 0x0A48, GCB_Extend},
+  {0x0A4B, 0x0A4D, GCB_Extend},
+  {0x0A51, 0x0A51, GCB_Extend},
+  {0x0A70, 0x0A71, GCB_Extend},
+  {0x0A75, 0x0A75, GCB_Extend},
+  {0x0A81, 0x0A82, GCB_Extend},
+  {0x0A83, 0x0A83, GCB_SpacingMark},
+  {0x0ABC, 0x0ABC, GCB_Extend},
+  {0x0ABE, 0x0AC0, GCB_SpacingMark},
+  {0x0AC1, 0x0AC5, GCB_Extend},
+  {0x0AC7, 0x0AC8, GCB_Extend},
+  {0x0AC9, 0x0AC9, GCB_SpacingMark},
+  {0x0ACB, 0x0ACC, GCB_SpacingMark},
+  {0x0ACD, 0x0ACD, GCB_Extend},
+  {0x0AE2, 0x0AE3, GCB_Extend},
+  {0x0AFA, 0x0AFF, GCB_Extend},
+  {0x0B01, 0x0B01, GCB_Extend},
+  {0x0B02, 0x0B03, GCB_SpacingMark},
+  {0x0B3C, 0x0B3C, GCB_Extend},
+  {0x0B3E, 0x0B3F, GCB_Extend},
+  {0x0B40, 0x0B40, GCB_SpacingMark},
+  {0x0B41, 0x0B44, GCB_Extend},
+  {0x0B47, 0x0B48, GCB_SpacingMark},
+  {0x0B4B, 0x0B4C, GCB_SpacingMark},
+  {0x0B4D, 0x0B4D, GCB_Extend},
+  {0x0B55, 0x0B57, GCB_Extend},
+  {0x0B62, 0x0B63, GCB_Extend},
+  {0x0B82, 0x0B82, GCB_Extend},
+  {0x0BBE, 0x0BBE, GCB_Extend},
+  {0x0BBF, 0x0BBF, GCB_SpacingMark},
+  {0x0BC0, 0x0BC0, GCB_Extend},
+  {0x0BC1, 0x0BC2, GCB_SpacingMark},
+  {0x0BC6, 0x0BC8, GCB_SpacingMark},
+  {0x0BCA, 0x0BCC, GCB_SpacingMark},
+  {0x0BCD, 0x0BCD, GCB_Extend},
+  {0x0BD7, 0x0BD7, GCB_Extend},
+  {0x0C00, 0x0C00, GCB_Extend},
+  {0x0C01, 0x0C03, GCB_SpacingMark},
+  {0x0C04, 0x0C04, GCB_Extend},
+  {0x0C3C, 0x0C3C, GCB_Extend},
+  {0x0C3E, 0x0C40, GCB_Extend},
+  {0x0C41, 0x0C44, GCB_SpacingMark},
+  {0x0C46, 0x0C48, GCB_Extend},
+  {0x0C4A, 0x0C4D, GCB_Extend},
+  {0x0C55, 0x0C56, GCB_Extend},
+  {0x0C62, 0x0C63, GCB_Extend},
+  {0x0C81, 0x0C81, GCB_Extend},
+  {0x0C82, 0x0C83, GCB_SpacingMark},
+  {0x0CBC, 0x0CBC, GCB_Extend},
+  {0x0CBE, 0x0CBE, GCB_SpacingMark},
+  {0x0CBF, 0x0CBF, GCB_Extend},
+  {0x0CC0, 0x0CC1, GCB_SpacingMark},
+  {0x0CC2, 0x0CC2, GCB_Extend},
+  {0x0CC3, 0x0CC4, GCB_SpacingMark},
+  {0x0CC6, 0x0CC6, GCB_Extend},
+  {0x0CC7, 0x0CC8, GCB_SpacingMark},
+  {0x0CCA, 0x0CCB, GCB_SpacingMark},
+  {0x0CCC, 0x0CCD, GCB_Extend},
+  {0x0CD5, 0x0CD6, GCB_Extend},
+  {0x0CE2, 0x0CE3, GCB_Extend},
+  {0x0D00, 0x0D01, GCB_Extend},
+  {0x0D02, 0x0D03, GCB_SpacingMark},
+  {0x0D3B, 0x0D3C, GCB_Extend},
+  {0x0D3E, 0x0D3E, GCB_Extend},
+  {0x0D3F, 0x0D40, GCB_SpacingMark},
+  {0x0D41, 0x0D44, GCB_Extend},
+  {0x0D46, 0x0D48, GCB_SpacingMark},
+  {0x0D4A, 0x0D4C, GCB_SpacingMark},
+  {0x0D4D, 0x0D4D, GCB_Extend},
+  {0x0D4E, 0x0D4E, GCB_Prepend},
+  {0x0D57, 0x0D57, GCB_Extend},
+  {0x0D62, 0x0D63, GCB_Extend},
+  {0x0D81, 0x0D81, GCB_Extend},
+  {0x0D82, 0x0D83, GCB_SpacingMark},
+  {0x0DCA, 0x0DCA, GCB_Extend},
+  {0x0DCF, 0x0DCF, GCB_Extend},
+  {0x0DD0, 0x0DD1, GCB_SpacingMark},
+  {0x0DD2, 0x0DD4, GCB_Extend},
+  {0x0DD6, 0x0DD6, GCB_Extend},
+  {0x0DD8, 0x0DDE, GCB_SpacingMark},
+  {0x0DDF, 0x0DDF, GCB_Extend},
+  {0x0DF2, 0x0DF3, GCB_SpacingMark},
+  {0x0E31, 0x0E31, GCB_Extend},
+  {0x0E33, 0x0E33, GCB_SpacingMark},
+  {0x0E34, 0x0E3A, GCB_Extend},
+  {0x0E47, 0x0E4E, GCB_Extend},
+  {0x0EB1, 0x0EB1, GCB_Extend},
+  {0x0EB3, 0x0EB3, GCB_SpacingMark},
+  {0x0EB4, 0x0EBC, GCB_Extend},
+  {0x0EC8, 0x0ECD, GCB_Extend},
+  {0x0F18, 0x0F19, GCB_Extend},
+  {0x0F35, 0x0F35, GCB_Extend},
+  {0x0F37, 0x0F37, GCB_Extend},
+  {0x0F39, 0x0F39, GCB_Extend},
+  {0x0F3E, 0x0F3F, GCB_SpacingMark},
+  {0x0F71, 0x0F7E, GCB_Extend},
+  {0x0F7F, 0x0F7F, GCB_SpacingMark},
+  {0x0F80, 0x0F84, GCB_Extend},
+  {0x0F86, 0x0F87, GCB_Extend},
+  {0x0F8D, 0x0F97, GCB_Extend},
+  {0x0F99, 0x0FBC, GCB_Extend},
+  {0x0FC6, 0x0FC6, GCB_Extend},
+  {0x102D, 0x1030, GCB_Extend},
+  {0x1031, 0x1031, GCB_SpacingMark},
+  {0x1032, 0x1037, GCB_Extend},
+  {0x1039, 0x103A, GCB_Extend},
+  {0x103B, 0x103C, GCB_SpacingMark},
+  {0x103D, 0x103E, GCB_Extend},
+  {0x1056, 0x1057, GCB_SpacingMark},
+  {0x1058, 0x1059, GCB_Extend},
+  {0x105E, 0x1060, GCB_Extend},
+  {0x1071, 0x1074, GCB_Extend},
+  {0x1082, 0x1082, GCB_Extend},
+  {0x1084, 0x1084, GCB_SpacingMark},
+  {0x1085, 0x1086, GCB_Extend},
+  {0x108D, 0x108D, GCB_Extend},
+  {0x109D, 0x109D, GCB_Extend},
+  {0x1100, 0x115F, GCB_L},
+  {0x1160, 0x11A7, GCB_V},
+  {0x11A8, 0x11FF, GCB_T},
+  {0x135D, 0x135F, GCB_Extend},
+  {0x1712, 0x1714, GCB_Extend},
+  {0x1715, 0x1715, GCB_SpacingMark},
+  {0x1732, 0x1733, GCB_Extend},
+  {0x1734, 0x1734, GCB_SpacingMark},
+  {0x1752, 0x1753, GCB_Extend},
+  {0x1772, 0x1773, GCB_Extend},
+  {0x17B4, 0x17B5, GCB_Extend},
+  {0x17B6, 0x17B6, GCB_SpacingMark},
+  {0x17B7, 0x17BD, GCB_Extend},
+  {0x17BE, 0x17C5, GCB_SpacingMark},
+  {0x17C6, 0x17C6, GCB_Extend},
+  {0x17C7, 0x17C8, GCB_SpacingMark},
+  {0x17C9, 0x17D3, GCB_Extend},
+  {0x17DD, 0x17DD, GCB_Extend},
+  {0x180B, 0x180D, GCB_Extend},
+  {0x180E, 0x180E, GCB_Control},
+  {0x180F, 0x180F, GCB_Extend},
+  {0x1885, 0x1886, GCB_Extend},
+  {0x18A9, 0x18A9, GCB_Extend},
+  {0x1920, 0x1922, GCB_Extend},
+  {0x1923, 0x1926, GCB_SpacingMark},
+  {0x1927, 0x1928, GCB_Extend},
+  {0x1929, 0x192B, GCB_SpacingMark},
+  {0x1930, 0x1931, GCB_SpacingMark},
+  {0x1932, 0x1932, GCB_Extend},
+  {0x1933, 0x1938, GCB_SpacingMark},
+  {0x1939, 0x193B, GCB_Extend},
+  {0x1A17, 0x1A18, GCB_Extend},
+  {0x1A19, 0x1A1A, GCB_SpacingMark},
+  {0x1A1B, 0x1A1B, GCB_Extend},
+  {0x1A55, 0x1A55, GCB_SpacingMark},
+  {0x1A56, 0x1A56, GCB_Extend},
+  {0x1A57, 0x1A57, GCB_SpacingMark},
+  {0x1A58, 0x1A5E, GCB_Extend},
+  {0x1A60, 0x1A60, GCB_Extend},
+  {0x1A62, 0x1A62, GCB_Extend},
+  {0x1A65, 0x1A6C, GCB_Extend},
+  {0x1A6D, 0x1A72, GCB_SpacingMark},
+  {0x1A73, 0x1A7C, GCB_Extend},
+  {0x1A7F, 0x1A7F, GCB_Extend},
+  {0x1AB0, 0x1ACE, GCB_Extend},
+  {0x1B00, 0x1B03, GCB_Extend},
+  {0x1B04, 0x1B04, GCB_SpacingMark},
+  {0x1B34, 0x1B3A, GCB_Extend},
+  {0x1B3B, 0x1B3B, GCB_SpacingMark},
+  {0x1B3C, 0x1B3C, GCB_Extend},
+  {0x1B3D, 0x1B41, GCB_SpacingMark},
+  {0x1B42, 0x1B42, GCB_Extend},
+  {0x1B43, 0x1B44, GCB_SpacingMark},
+  {0x1B6B, 0x1B73, GCB_Extend},
+  {0x1B80, 0x1B81, GCB_Extend},
+  {0x1B82, 0x1B82, GCB_SpacingMark},
+  {0x1BA1, 0x1BA1, GCB_SpacingMark},
+  {0x1BA2, 0x1BA5, GCB_Extend},
+  {0x1BA6, 0x1BA7, GCB_SpacingMark},
+  {0x1BA8, 0x1BA9, GCB_Extend},
+  {0x1BAA, 0x1BAA, GCB_SpacingMark},
+  {0x1BAB, 0x1BAD, GCB_Extend},
+  {0x1BE6, 0x1BE6, GCB_Extend},
+  {0x1BE7, 0x1BE7, GCB_SpacingMark},
+  {0x1BE8, 0x1BE9, GCB_Extend},
+  {0x1BEA, 0x1BEC, GCB_SpacingMark},
+  {0x1BED, 0x1BED, GCB_Extend},
+  {0x1BEE, 0x1BEE, GCB_SpacingMark},
+  {0x1BEF, 0x1BF1, GCB_Extend},
+  {0x1BF2, 0x1BF3, GCB_SpacingMark},
+  {0x1C24, 0x1C2B, GCB_SpacingMark},
+  {0x1C2C, 0x1C33, GCB_Extend},
+  {0x1C34, 0x1C35, GCB_SpacingMark},
+  {0x1C36, 0x1C37, GCB_Extend},
+  {0x1CD0, 0x1CD2, GCB_Extend},
+  {0x1CD4, 0x1CE0, GCB_Extend},
+  {0x1CE1, 0x1CE1, GCB_SpacingMark},
+  {0x1CE2, 0x1CE8, GCB_Extend},
+  {0x1CED, 0x1CED, GCB_Extend},
+  {0x1CF4, 0x1CF4, GCB_Extend},
+  {0x1CF7, 0x1CF7, GCB_SpacingMark},
+  {0x1CF8, 0x1CF9, GCB_Extend},
+  {0x1DC0, 0x1DFF, GCB_Extend},
+  {0x200B, 0x200B, GCB_Control},
+  {0x200C, 0x200C, GCB_Extend},
+  {0x200D, 0x200D, GCB_ZWJ},
+  {0x200E, 0x200F, GCB_Control},
+  {0x2028, 0x202E, GCB_Control},
+  {0x203C, 0x203C, GCB_ExtPict},
+  {0x2049, 0x2049, GCB_ExtPict},
+  {0x2060, 0x206F, GCB_Control},
+  {0x20D0, 0x20F0, GCB_Extend},
+  {0x2122, 0x2122, GCB_ExtPict},
+  {0x2139, 0x2139, GCB_ExtPict},
+  {0x2194, 0x2199, GCB_ExtPict},
+  {0x21A9, 0x21AA, GCB_ExtPict},
+  {0x231A, 0x231B, GCB_ExtPict},
+  {0x2328, 0x2328, GCB_ExtPict},
+  {0x2388, 0x2388, GCB_ExtPict},
+  {0x23CF, 0x23CF, GCB_ExtPict},
+  {0x23E9, 0x23F3, GCB_ExtPict},
+  {0x23F8, 0x23FA, GCB_ExtPict},
+  {0x24C2, 0x24C2, GCB_ExtPict},
+  {0x25AA, 0x25AB, GCB_ExtPict},
+  {0x25B6, 0x25B6, GCB_ExtPict},
+  {0x25C0, 0x25C0, GCB_ExtPict},
+  {0x25FB, 0x25FE, GCB_ExtPict},
+  {0x2600, 0x2605, GCB_ExtPict},
+  {0x2607, 0x2612, GCB_ExtPict},
+  {0x2614, 0x2685, GCB_ExtPict},
+  {0x2690, 0x2705, GCB_ExtPict},
+  {0x2708, 0x2712, GCB_ExtPict},
+  {0x2714, 0x2714, GCB_ExtPict},
+  {0x2716, 0x2716, GCB_ExtPict},
+  {0x271D, 0x271D, GCB_ExtPict},
+  {0x2721, 0x2721, GCB_ExtPict},
+  {0x2728, 0x2728, GCB_ExtPict},
+  {0x2733, 0x2734, GCB_ExtPict},
+  {0x2744, 0x2744, GCB_ExtPict},
+  {0x2747, 0x2747, GCB_ExtPict},
+  {0x274C, 0x274C, GCB_ExtPict},
+  {0x274E, 0x274E, GCB_ExtPict},
+  {0x2753, 0x2755, GCB_ExtPict},
+  {0x2757, 0x2757, GCB_ExtPict},
+  {0x2763, 0x2767, GCB_ExtPict},
+  {0x2795, 0x2797, GCB_ExtPict},
+  {0x27A1, 0x27A1, GCB_ExtPict},
+  {0x27B0, 0x27B0, GCB_ExtPict},
+  {0x27BF, 0x27BF, GCB_ExtPict},
+  {0x2934, 0x2935, GCB_ExtPict},
+  {0x2B05, 0x2B07, GCB_ExtPict},
+  {0x2B1B, 0x2B1C, GCB_ExtPict},
+  {0x2B50, 0x2B50, GCB_ExtPict},
+  {0x2B55, 0x2B55, GCB_ExtPict},
+  {0x2CEF, 0x2CF1, GCB_Extend},
+  {0x2D7F, 0x2D7F, GCB_Extend},
+  {0x2DE0, 0x2DFF, GCB_Extend},
+  {0x302A, 0x302F, GCB_Extend},
+  {0x3030, 0x3030, GCB_ExtPict},
+  {0x303D, 0x303D, GCB_ExtPict},
+  {0x3099, 0x309A, GCB_Extend},
+  {0x3297, 0x3297, GCB_ExtPict},
+  {0x3299, 0x3299, GCB_ExtPict},
+  {0xA66F, 0xA672, GCB_Extend},
+  {0xA674, 0xA67D, GCB_Extend},
+  {0xA69E, 0xA69F, GCB_Extend},
+  {0xA6F0, 0xA6F1, GCB_Extend},
+  {0xA802, 0xA802, GCB_Extend},
+  {0xA806, 0xA806, GCB_Extend},
+  {0xA80B, 0xA80B, GCB_Extend},
+  {0xA823, 0xA824, GCB_SpacingMark},
+  {0xA825, 0xA826, GCB_Extend},
+  {0xA827, 0xA827, GCB_SpacingMark},
+  {0xA82C, 0xA82C, GCB_Extend},
+  {0xA880, 0xA881, GCB_SpacingMark},
+  {0xA8B4, 0xA8C3, GCB_SpacingMark},
+  {0xA8C4, 0xA8C5, GCB_Extend},
+  {0xA8E0, 0xA8F1, GCB_Extend},
+  {0xA8FF, 0xA8FF, GCB_Extend},
+  {0xA926, 0xA92D, GCB_Extend},
+  {0xA947, 0xA951, GCB_Extend},
+  {0xA952, 0xA953, GCB_SpacingMark},
+  {0xA960, 0xA97C, GCB_L},
+  {0xA980, 0xA982, GCB_Extend},
+  {0xA983, 0xA983, GCB_SpacingMark},
+  {0xA9B3, 0xA9B3, GCB_Extend},
+  {0xA9B4, 0xA9B5, GCB_SpacingMark},
+  {0xA9B6, 0xA9B9, GCB_Extend},
+  {0xA9BA, 0xA9BB, GCB_SpacingMark},
+  {0xA9BC, 0xA9BD, GCB_Extend},
+  {0xA9BE, 0xA9C0, GCB_SpacingMark},
+  {0xA9E5, 0xA9E5, GCB_Extend},
+  {0xAA29, 0xAA2E, GCB_Extend},
+  {0xAA2F, 0xAA30, GCB_SpacingMark},
+  {0xAA31, 0xAA32, GCB_Extend},
+  {0xAA33, 0xAA34, GCB_SpacingMark},
+  {0xAA35, 0xAA36, GCB_Extend},
+  {0xAA43, 0xAA43, GCB_Extend},
+  {0xAA4C, 0xAA4C, GCB_Extend},
+  {0xAA4D, 0xAA4D, GCB_SpacingMark},
+  {0xAA7C, 0xAA7C, GCB_Extend},
+  {0xAAB0, 0xAAB0, GCB_Extend},
+  {0xAAB2, 0xAAB4, GCB_Extend},
+  {0xAAB7, 0xAAB8, GCB_Extend},
+  {0xAABE, 0xAABF, GCB_Extend},
+  {0xAAC1, 0xAAC1, GCB_Extend},
+  {0xAAEB, 0xAAEB, GCB_SpacingMark},
+  {0xAAEC, 0xAAED, GCB_Extend},
+  {0xAAEE, 0xAAEF, GCB_SpacingMark},
+  {0xAAF5, 0xAAF5, GCB_SpacingMark},
+  {0xAAF6, 0xAAF6, GCB_Extend},
+  {0xABE3, 0xABE4, GCB_SpacingMark},
+  {0xABE5, 0xABE5, GCB_Extend},
+  {0xABE6, 0xABE7, GCB_SpacingMark},
+  {0xABE8, 0xABE8, GCB_Extend},
+  {0xABE9, 0xABEA, GCB_SpacingMark},
+  {0xABEC, 0xABEC, GCB_SpacingMark},
+  {0xABED, 0xABED, GCB_Extend},
+  {0xAC00, 0xAC00, GCB_LV},
+  {0xAC01, 0xAC1B, GCB_LVT},
+  {0xAC1C, 0xAC1C, GCB_LV},
+  {0xAC1D, 0xAC37, GCB_LVT},
+  {0xAC38, 0xAC38, GCB_LV},
+  {0xAC39, 0xAC53, GCB_LVT},
+  {0xAC54, 0xAC54, GCB_LV},
+  {0xAC55, 0xAC6F, GCB_LVT},
+  {0xAC70, 0xAC70, GCB_LV},
+  {0xAC71, 0xAC8B, GCB_LVT},
+  {0xAC8C, 0xAC8C, GCB_LV},
+  {0xAC8D, 0xACA7, GCB_LVT},
+  {0xACA8, 0xACA8, GCB_LV},
+  {0xACA9, 0xACC3, GCB_LVT},
+  {0xACC4, 0xACC4, GCB_LV},
+  {0xACC5, 0xACDF, GCB_LVT},
+  {0xACE0, 0xACE0, GCB_LV},
+  {0xACE1, 0xACFB, GCB_LVT},
+  {0xACFC, 0xACFC, GCB_LV},
+  {0xACFD, 0xAD17, GCB_LVT},
+  {0xAD18, 0xAD18, GCB_LV},
+  {0xAD19, 0xAD33, GCB_LVT},
+  {0xAD34, 0xAD34, GCB_LV},
+  {0xAD35, 0xAD4F, GCB_LVT},
+  {0xAD50, 0xAD50, GCB_LV},
+  {0xAD51, 0xAD6B, GCB_LVT},
+  {0xAD6C, 0xAD6C, GCB_LV},
+  {0xAD6D, 0xAD87, GCB_LVT},
+  {0xAD88, 0xAD88, GCB_LV},
+  {0xAD89, 0xADA3, GCB_LVT},
+  {0xADA4, 0xADA4, GCB_LV},
+  {0xADA5, 0xADBF, GCB_LVT},
+  {0xADC0, 0xADC0, GCB_LV},
+  {0xADC1, 0xADDB, GCB_LVT},
+  {0xADDC, 0xADDC, GCB_LV},
+  {0xADDD, 0xADF7, GCB_LVT},
+  {0xADF8, 0xADF8, GCB_LV},
+  {0xADF9, 0xAE13, GCB_LVT},
+  {0xAE14, 0xAE14, GCB_LV},
+  {0xAE15, 0xAE2F, GCB_LVT},
+  {0xAE30, 0xAE30, GCB_LV},
+  {0xAE31, 0xAE4B, GCB_LVT},
+  {0xAE4C, 0xAE4C, GCB_LV},
+  {0xAE4D, 0xAE67, GCB_LVT},
+  {0xAE68, 0xAE68, GCB_LV},
+  {0xAE69, 0xAE83, GCB_LVT},
+  {0xAE84, 0xAE84, GCB_LV},
+  {0xAE85, 0xAE9F, GCB_LVT},
+  {0xAEA0, 0xAEA0, GCB_LV},
+  {0xAEA1, 0xAEBB, GCB_LVT},
+  {0xAEBC, 0xAEBC, GCB_LV},
+  {0xAEBD, 0xAED7, GCB_LVT},
+  {0xAED8, 0xAED8, GCB_LV},
+  {0xAED9, 0xAEF3, GCB_LVT},
+  {0xAEF4, 0xAEF4, GCB_LV},
+  {0xAEF5, 0xAF0F, GCB_LVT},
+  {0xAF10, 0xAF10, GCB_LV},
+  {0xAF11, 0xAF2B, GCB_LVT},
+  {0xAF2C, 0xAF2C, GCB_LV},
+  {0xAF2D, 0xAF47, GCB_LVT},
+  {0xAF48, 0xAF48, GCB_LV},
+  {0xAF49, 0xAF63, GCB_LVT},
+  {0xAF64, 0xAF64, GCB_LV},
+  {0xAF65, 0xAF7F, GCB_LVT},
+  {0xAF80, 0xAF80, GCB_LV},
+  {0xAF81, 0xAF9B, GCB_LVT},
+  {0xAF9C, 0xAF9C, GCB_LV},
+  {0xAF9D, 0xAFB7, GCB_LVT},
+  {0xAFB8, 0xAFB8, GCB_LV},
+  {0xAFB9, 0xAFD3, GCB_LVT},
+  {0xAFD4, 0xAFD4, GCB_LV},
+  {0xAFD5, 0xAFEF, GCB_LVT},
+  {0xAFF0, 0xAFF0, GCB_LV},
+  {0xAFF1, 0xB00B, GCB_LVT},
+  {0xB00C, 0xB00C, GCB_LV},
+  {0xB00D, 0xB027, GCB_LVT},
+  {0xB028, 0xB028, GCB_LV},
+  {0xB029, 0xB043, GCB_LVT},
+  {0xB044, 0xB044, GCB_LV},
+  {0xB045, 0xB05F, GCB_LVT},
+  {0xB060, 0xB060, GCB_LV},
+  {0xB061, 0xB07B, GCB_LVT},
+  {0xB07C, 0xB07C, GCB_LV},
+  {0xB07D, 0xB097, GCB_LVT},
+  {0xB098, 0xB098, GCB_LV},
+  {0xB099, 0xB0B3, GCB_LVT},
+  {0xB0B4, 0xB0B4, GCB_LV},
+  {0xB0B5, 0xB0CF, GCB_LVT},
+  {0xB0D0, 0xB0D0, GCB_LV},
+  {0xB0D1, 0xB0EB, GCB_LVT},
+  {0xB0EC, 0xB0EC, GCB_LV},
+  {0xB0ED, 0xB107, GCB_LVT},
+  {0xB108, 0xB108, GCB_LV},
+  {0xB109, 0xB123, GCB_LVT},
+  {0xB124, 0xB124, GCB_LV},
+  {0xB125, 0xB13F, GCB_LVT},
+  {0xB140, 0xB140, GCB_LV},
+  {0xB141, 0xB15B, GCB_LVT},
+  {0xB15C, 0xB15C, GCB_LV},
+  {0xB15D, 0xB177, GCB_LVT},
+  {0xB178, 0xB178, GCB_LV},
+  {0xB179, 0xB193, GCB_LVT},
+  {0xB194, 0xB194, GCB_LV},
+  {0xB195, 0xB1AF, GCB_LVT},
+  {0xB1B0, 0xB1B0, GCB_LV},
+  {0xB1B1, 0xB1CB, GCB_LVT},
+  {0xB1CC, 0xB1CC, GCB_LV},
+  {0xB1CD, 0xB1E7, GCB_LVT},
+  {0xB1E8, 0xB1E8, GCB_LV},
+  {0xB1E9, 0xB203, GCB_LVT},
+  {0xB204, 0xB204, GCB_LV},
+  {0xB205, 0xB21F, GCB_LVT},
+  {0xB220, 0xB220, GCB_LV},
+  {0xB221, 0xB23B, GCB_LVT},
+  {0xB23C, 0xB23C, GCB_LV},
+  {0xB23D, 0xB257, GCB_LVT},
+  {0xB258, 0xB258, GCB_LV},
+  {0xB259, 0xB273, GCB_LVT},
+  {0xB274, 0xB274, GCB_LV},
+  {0xB275, 0xB28F, GCB_LVT},
+  {0xB290, 0xB290, GCB_LV},
+  {0xB291, 0xB2AB, GCB_LVT},
+  {0xB2AC, 0xB2AC, GCB_LV},
+  {0xB2AD, 0xB2C7, GCB_LVT},
+  {0xB2C8, 0xB2C8, GCB_LV},
+  {0xB2C9, 0xB2E3, GCB_LVT},
+  {0xB2E4, 0xB2E4, GCB_LV},
+  {0xB2E5, 0xB2FF, GCB_LVT},
+  {0xB300, 0xB300, GCB_LV},
+  {0xB301, 0xB31B, GCB_LVT},
+  {0xB31C, 0xB31C, GCB_LV},
+  {0xB31D, 0xB337, GCB_LVT},
+  {0xB338, 0xB338, GCB_LV},
+  {0xB339, 0xB353, GCB_LVT},
+  {0xB354, 0xB354, GCB_LV},
+  {0xB355, 0xB36F, GCB_LVT},
+  {0xB370, 0xB370, GCB_LV},
+  {0xB371, 0xB38B, GCB_LVT},
+  {0xB38C, 0xB38C, GCB_LV},
+  {0xB38D, 0xB3A7, GCB_LVT},
+  {0xB3A8, 0xB3A8, GCB_LV},
+  {0xB3A9, 0xB3C3, GCB_LVT},
+  {0xB3C4, 0xB3C4, GCB_LV},
+  {0xB3C5, 0xB3DF, GCB_LVT},
+  {0xB3E0, 0xB3E0, GCB_LV},
+  {0xB3E1, 0xB3FB, GCB_LVT},
+  {0xB3FC, 0xB3FC, GCB_LV},
+  {0xB3FD, 0xB417, GCB_LVT},
+  {0xB418, 0xB418, GCB_LV},
+  {0xB419, 0xB433, GCB_LVT},
+  {0xB434, 0xB434, GCB_LV},
+  {0xB435, 0xB44F, GCB_LVT},
+  {0xB450, 0xB450, GCB_LV},
+  {0xB451, 0xB46B, GCB_LVT},
+  {0xB46C, 0xB46C, GCB_LV},
+  {0xB46D, 0xB487, GCB_LVT},
+  {0xB488, 0xB488, GCB_LV},
+  {0xB489, 0xB4A3, GCB_LVT},
+  {0xB4A4, 0xB4A4, GCB_LV},
+  {0xB4A5, 0xB4BF, GCB_LVT},
+  {0xB4C0, 0xB4C0, GCB_LV},
+  {0xB4C1, 0xB4DB, GCB_LVT},
+  {0xB4DC, 0xB4DC, GCB_LV},
+  {0xB4DD, 0xB4F7, GCB_LVT},
+  {0xB4F8, 0xB4F8, GCB_LV},
+  {0xB4F9, 0xB513, GCB_LVT},
+  {0xB514, 0xB514, GCB_LV},
+  {0xB515, 0xB52F, GCB_LVT},
+  {0xB530, 0xB530, GCB_LV},
+  {0xB531, 0xB54B, GCB_LVT},
+  {0xB54C, 0xB54C, GCB_LV},
+  {0xB54D, 0xB567, GCB_LVT},
+  {0xB568, 0xB568, GCB_LV},
+  {0xB569, 0xB583, GCB_LVT},
+  {0xB584, 0xB584, GCB_LV},
+  {0xB585, 0xB59F, GCB_LVT},
+  {0xB5A0, 0xB5A0, GCB_LV},
+  {0xB5A1, 0xB5BB, GCB_LVT},
+  {0xB5BC, 0xB5BC, GCB_LV},
+  {0xB5BD, 0xB5D7, GCB_LVT},
+  {0xB5D8, 0xB5D8, GCB_LV},
+  {0xB5D9, 0xB5F3, GCB_LVT},
+  {0xB5F4, 0xB5F4, GCB_LV},
+  {0xB5F5, 0xB60F, GCB_LVT},
+  {0xB610, 0xB610, GCB_LV},
+  {0xB611, 0xB62B, GCB_LVT},
+  {0xB62C, 0xB62C, GCB_LV},
+  {0xB62D, 0xB647, GCB_LVT},
+  {0xB648, 0xB648, GCB_LV},
+  {0xB649, 0xB663, GCB_LVT},
+  {0xB664, 0xB664, GCB_LV},
+  {0xB665, 0xB67F, GCB_LVT},
+  {0xB680, 0xB680, GCB_LV},
+  {0xB681, 0xB69B, GCB_LVT},
+  {0xB69C, 0xB69C, GCB_LV},
+  {0xB69D, 0xB6B7, GCB_LVT},
+  {0xB6B8, 0xB6B8, GCB_LV},
+  {0xB6B9, 0xB6D3, GCB_LVT},
+  {0xB6D4, 0xB6D4, GCB_LV},
+  {0xB6D5, 0xB6EF, GCB_LVT},
+  {0xB6F0, 0xB6F0, GCB_LV},
+  {0xB6F1, 0xB70B, GCB_LVT},
+  {0xB70C, 0xB70C, GCB_LV},
+  {0xB70D, 0xB727, GCB_LVT},
+  {0xB728, 0xB728, GCB_LV},
+  {0xB729, 0xB743, GCB_LVT},
+  {0xB744, 0xB744, GCB_LV},
+  {0xB745, 0xB75F, GCB_LVT},
+  {0xB760, 0xB760, GCB_LV},
+  {0xB761, 0xB77B, GCB_LVT},
+  {0xB77C, 0xB77C, GCB_LV},
+  {0xB77D, 0xB797, GCB_LVT},
+  {0xB798, 0xB798, GCB_LV},
+  {0xB799, 0xB7B3, GCB_LVT},
+  {0xB7B4, 0xB7B4, GCB_LV},
+  {0xB7B5, 0xB7CF, GCB_LVT},
+  {0xB7D0, 0xB7D0, GCB_LV},
+  {0xB7D1, 0xB7EB, GCB_LVT},
+  {0xB7EC, 0xB7EC, GCB_LV},
+  {0xB7ED, 0xB807, GCB_LVT},
+  {0xB808, 0xB808, GCB_LV},
+  {0xB809, 0xB823, GCB_LVT},
+  {0xB824, 0xB824, GCB_LV},
+  {0xB825, 0xB83F, GCB_LVT},
+  {0xB840, 0xB840, GCB_LV},
+  {0xB841, 0xB85B, GCB_LVT},
+  {0xB85C, 0xB85C, GCB_LV},
+  {0xB85D, 0xB877, GCB_LVT},
+  {0xB878, 0xB878, GCB_LV},
+  {0xB879, 0xB893, GCB_LVT},
+  {0xB894, 0xB894, GCB_LV},
+  {0xB895, 0xB8AF, GCB_LVT},
+  {0xB8B0, 0xB8B0, GCB_LV},
+  {0xB8B1, 0xB8CB, GCB_LVT},
+  {0xB8CC, 0xB8CC, GCB_LV},
+  {0xB8CD, 0xB8E7, GCB_LVT},
+  {0xB8E8, 0xB8E8, GCB_LV},
+  {0xB8E9, 0xB903, GCB_LVT},
+  {0xB904, 0xB904, GCB_LV},
+  {0xB905, 0xB91F, GCB_LVT},
+  {0xB920, 0xB920, GCB_LV},
+  {0xB921, 0xB93B, GCB_LVT},
+  {0xB93C, 0xB93C, GCB_LV},
+  {0xB93D, 0xB957, GCB_LVT},
+  {0xB958, 0xB958, GCB_LV},
+  {0xB959, 0xB973, GCB_LVT},
+  {0xB974, 0xB974, GCB_LV},
+  {0xB975, 0xB98F, GCB_LVT},
+  {0xB990, 0xB990, GCB_LV},
+  {0xB991, 0xB9AB, GCB_LVT},
+  {0xB9AC, 0xB9AC, GCB_LV},
+  {0xB9AD, 0xB9C7, GCB_LVT},
+  {0xB9C8, 0xB9C8, GCB_LV},
+  {0xB9C9, 0xB9E3, GCB_LVT},
+  {0xB9E4, 0xB9E4, GCB_LV},
+  {0xB9E5, 0xB9FF, GCB_LVT},
+  {0xBA00, 0xBA00, GCB_LV},
+  {0xBA01, 0xBA1B, GCB_LVT},
+  {0xBA1C, 0xBA1C, GCB_LV},
+  {0xBA1D, 0xBA37, GCB_LVT},
+  {0xBA38, 0xBA38, GCB_LV},
+  {0xBA39, 0xBA53, GCB_LVT},
+  {0xBA54, 0xBA54, GCB_LV},
+  {0xBA55, 0xBA6F, GCB_LVT},
+  {0xBA70, 0xBA70, GCB_LV},
+  {0xBA71, 0xBA8B, GCB_LVT},
+  {0xBA8C, 0xBA8C, GCB_LV},
+  {0xBA8D, 0xBAA7, GCB_LVT},
+  {0xBAA8, 0xBAA8, GCB_LV},
+  {0xBAA9, 0xBAC3, GCB_LVT},
+  {0xBAC4, 0xBAC4, GCB_LV},
+  {0xBAC5, 0xBADF, GCB_LVT},
+  {0xBAE0, 0xBAE0, GCB_LV},
+  {0xBAE1, 0xBAFB, GCB_LVT},
+  {0xBAFC, 0xBAFC, GCB_LV},
+  {0xBAFD, 0xBB17, GCB_LVT},
+  {0xBB18, 0xBB18, GCB_LV},
+  {0xBB19, 0xBB33, GCB_LVT},
+  {0xBB34, 0xBB34, GCB_LV},
+  {0xBB35, 0xBB4F, GCB_LVT},
+  {0xBB50, 0xBB50, GCB_LV},
+  {0xBB51, 0xBB6B, GCB_LVT},
+  {0xBB6C, 0xBB6C, GCB_LV},
+  {0xBB6D, 0xBB87, GCB_LVT},
+  {0xBB88, 0xBB88, GCB_LV},
+  {0xBB89, 0xBBA3, GCB_LVT},
+  {0xBBA4, 0xBBA4, GCB_LV},
+  {0xBBA5, 0xBBBF, GCB_LVT},
+  {0xBBC0, 0xBBC0, GCB_LV},
+  {0xBBC1, 0xBBDB, GCB_LVT},
+  {0xBBDC, 0xBBDC, GCB_LV},
+  {0xBBDD, 0xBBF7, GCB_LVT},
+  {0xBBF8, 0xBBF8, GCB_LV},
+  {0xBBF9, 0xBC13, GCB_LVT},
+  {0xBC14, 0xBC14, GCB_LV},
+  {0xBC15, 0xBC2F, GCB_LVT},
+  {0xBC30, 0xBC30, GCB_LV},
+  {0xBC31, 0xBC4B, GCB_LVT},
+  {0xBC4C, 0xBC4C, GCB_LV},
+  {0xBC4D, 0xBC67, GCB_LVT},
+  {0xBC68, 0xBC68, GCB_LV},
+  {0xBC69, 0xBC83, GCB_LVT},
+  {0xBC84, 0xBC84, GCB_LV},
+  {0xBC85, 0xBC9F, GCB_LVT},
+  {0xBCA0, 0xBCA0, GCB_LV},
+  {0xBCA1, 0xBCBB, GCB_LVT},
+  {0xBCBC, 0xBCBC, GCB_LV},
+  {0xBCBD, 0xBCD7, GCB_LVT},
+  {0xBCD8, 0xBCD8, GCB_LV},
+  {0xBCD9, 0xBCF3, GCB_LVT},
+  {0xBCF4, 0xBCF4, GCB_LV},
+  {0xBCF5, 0xBD0F, GCB_LVT},
+  {0xBD10, 0xBD10, GCB_LV},
+  {0xBD11, 0xBD2B, GCB_LVT},
+  {0xBD2C, 0xBD2C, GCB_LV},
+  {0xBD2D, 0xBD47, GCB_LVT},
+  {0xBD48, 0xBD48, GCB_LV},
+  {0xBD49, 0xBD63, GCB_LVT},
+  {0xBD64, 0xBD64, GCB_LV},
+  {0xBD65, 0xBD7F, GCB_LVT},
+  {0xBD80, 0xBD80, GCB_LV},
+  {0xBD81, 0xBD9B, GCB_LVT},
+  {0xBD9C, 0xBD9C, GCB_LV},
+  {0xBD9D, 0xBDB7, GCB_LVT},
+  {0xBDB8, 0xBDB8, GCB_LV},
+  {0xBDB9, 0xBDD3, GCB_LVT},
+  {0xBDD4, 0xBDD4, GCB_LV},
+  {0xBDD5, 0xBDEF, GCB_LVT},
+  {0xBDF0, 0xBDF0, GCB_LV},
+  {0xBDF1, 0xBE0B, GCB_LVT},
+  {0xBE0C, 0xBE0C, GCB_LV},
+  {0xBE0D, 0xBE27, GCB_LVT},
+  {0xBE28, 0xBE28, GCB_LV},
+  {0xBE29, 0xBE43, GCB_LVT},
+  {0xBE44, 0xBE44, GCB_LV},
+  {0xBE45, 0xBE5F, GCB_LVT},
+  {0xBE60, 0xBE60, GCB_LV},
+  {0xBE61, 0xBE7B, GCB_LVT},
+  {0xBE7C, 0xBE7C, GCB_LV},
+  {0xBE7D, 0xBE97, GCB_LVT},
+  {0xBE98, 0xBE98, GCB_LV},
+  {0xBE99, 0xBEB3, GCB_LVT},
+  {0xBEB4, 0xBEB4, GCB_LV},
+  {0xBEB5, 0xBECF, GCB_LVT},
+  {0xBED0, 0xBED0, GCB_LV},
+  {0xBED1, 0xBEEB, GCB_LVT},
+  {0xBEEC, 0xBEEC, GCB_LV},
+  {0xBEED, 0xBF07, GCB_LVT},
+  {0xBF08, 0xBF08, GCB_LV},
+  {0xBF09, 0xBF23, GCB_LVT},
+  {0xBF24, 0xBF24, GCB_LV},
+  {0xBF25, 0xBF3F, GCB_LVT},
+  {0xBF40, 0xBF40, GCB_LV},
+  {0xBF41, 0xBF5B, GCB_LVT},
+  {0xBF5C, 0xBF5C, GCB_LV},
+  {0xBF5D, 0xBF77, GCB_LVT},
+  {0xBF78, 0xBF78, GCB_LV},
+  {0xBF79, 0xBF93, GCB_LVT},
+  {0xBF94, 0xBF94, GCB_LV},
+  {0xBF95, 0xBFAF, GCB_LVT},
+  {0xBFB0, 0xBFB0, GCB_LV},
+  {0xBFB1, 0xBFCB, GCB_LVT},
+  {0xBFCC, 0xBFCC, GCB_LV},
+  {0xBFCD, 0xBFE7, GCB_LVT},
+  {0xBFE8, 0xBFE8, GCB_LV},
+  {0xBFE9, 0xC003, GCB_LVT},
+  {0xC004, 0xC004, GCB_LV},
+  {0xC005, 0xC01F, GCB_LVT},
+  {0xC020, 0xC020, GCB_LV},
+  {0xC021, 0xC03B, GCB_LVT},
+  {0xC03C, 0xC03C, GCB_LV},
+  {0xC03D, 0xC057, GCB_LVT},
+  {0xC058, 0xC058, GCB_LV},
+  {0xC059, 0xC073, GCB_LVT},
+  {0xC074, 0xC074, GCB_LV},
+  {0xC075, 0xC08F, GCB_LVT},
+  {0xC090, 0xC090, GCB_LV},
+  {0xC091, 0xC0AB, GCB_LVT},
+  {0xC0AC, 0xC0AC, GCB_LV},
+  {0xC0AD, 0xC0C7, GCB_LVT},
+  {0xC0C8, 0xC0C8, GCB_LV},
+  {0xC0C9, 0xC0E3, GCB_LVT},
+  {0xC0E4, 0xC0E4, GCB_LV},
+  {0xC0E5, 0xC0FF, GCB_LVT},
+  {0xC100, 0xC100, GCB_LV},
+  {0xC101, 0xC11B, GCB_LVT},
+  {0xC11C, 0xC11C, GCB_LV},
+  {0xC11D, 0xC137, GCB_LVT},
+  {0xC138, 0xC138, GCB_LV},
+  {0xC139, 0xC153, GCB_LVT},
+  {0xC154, 0xC154, GCB_LV},
+  {0xC155, 0xC16F, GCB_LVT},
+  {0xC170, 0xC170, GCB_LV},
+  {0xC171, 0xC18B, GCB_LVT},
+  {0xC18C, 0xC18C, GCB_LV},
+  {0xC18D, 0xC1A7, GCB_LVT},
+  {0xC1A8, 0xC1A8, GCB_LV},
+  {0xC1A9, 0xC1C3, GCB_LVT},
+  {0xC1C4, 0xC1C4, GCB_LV},
+  {0xC1C5, 0xC1DF, GCB_LVT},
+  {0xC1E0, 0xC1E0, GCB_LV},
+  {0xC1E1, 0xC1FB, GCB_LVT},
+  {0xC1FC, 0xC1FC, GCB_LV},
+  {0xC1FD, 0xC217, GCB_LVT},
+  {0xC218, 0xC218, GCB_LV},
+  {0xC219, 0xC233, GCB_LVT},
+  {0xC234, 0xC234, GCB_LV},
+  {0xC235, 0xC24F, GCB_LVT},
+  {0xC250, 0xC250, GCB_LV},
+  {0xC251, 0xC26B, GCB_LVT},
+  {0xC26C, 0xC26C, GCB_LV},
+  {0xC26D, 0xC287, GCB_LVT},
+  {0xC288, 0xC288, GCB_LV},
+  {0xC289, 0xC2A3, GCB_LVT},
+  {0xC2A4, 0xC2A4, GCB_LV},
+  {0xC2A5, 0xC2BF, GCB_LVT},
+  {0xC2C0, 0xC2C0, GCB_LV},
+  {0xC2C1, 0xC2DB, GCB_LVT},
+  {0xC2DC, 0xC2DC, GCB_LV},
+  {0xC2DD, 0xC2F7, GCB_LVT},
+  {0xC2F8, 0xC2F8, GCB_LV},
+  {0xC2F9, 0xC313, GCB_LVT},
+  {0xC314, 0xC314, GCB_LV},
+  {0xC315, 0xC32F, GCB_LVT},
+  {0xC330, 0xC330, GCB_LV},
+  {0xC331, 0xC34B, GCB_LVT},
+  {0xC34C, 0xC34C, GCB_LV},
+  {0xC34D, 0xC367, GCB_LVT},
+  {0xC368, 0xC368, GCB_LV},
+  {0xC369, 0xC383, GCB_LVT},
+  {0xC384, 0xC384, GCB_LV},
+  {0xC385, 0xC39F, GCB_LVT},
+  {0xC3A0, 0xC3A0, GCB_LV},
+  {0xC3A1, 0xC3BB, GCB_LVT},
+  {0xC3BC, 0xC3BC, GCB_LV},
+  {0xC3BD, 0xC3D7, GCB_LVT},
+  {0xC3D8, 0xC3D8, GCB_LV},
+  {0xC3D9, 0xC3F3, GCB_LVT},
+  {0xC3F4, 0xC3F4, GCB_LV},
+  {0xC3F5, 0xC40F, GCB_LVT},
+  {0xC410, 0xC410, GCB_LV},
+  {0xC411, 0xC42B, GCB_LVT},
+  {0xC42C, 0xC42C, GCB_LV},
+  {0xC42D, 0xC447, GCB_LVT},
+  {0xC448, 0xC448, GCB_LV},
+  {0xC449, 0xC463, GCB_LVT},
+  {0xC464, 0xC464, GCB_LV},
+  {0xC465, 0xC47F, GCB_LVT},
+  {0xC480, 0xC480, GCB_LV},
+  {0xC481, 0xC49B, GCB_LVT},
+  {0xC49C, 0xC49C, GCB_LV},
+  {0xC49D, 0xC4B7, GCB_LVT},
+  {0xC4B8, 0xC4B8, GCB_LV},
+  {0xC4B9, 0xC4D3, GCB_LVT},
+  {0xC4D4, 0xC4D4, GCB_LV},
+  {0xC4D5, 0xC4EF, GCB_LVT},
+  {0xC4F0, 0xC4F0, GCB_LV},
+  {0xC4F1, 0xC50B, GCB_LVT},
+  {0xC50C, 0xC50C, GCB_LV},
+  {0xC50D, 0xC527, GCB_LVT},
+  {0xC528, 0xC528, GCB_LV},
+  {0xC529, 0xC543, GCB_LVT},
+  {0xC544, 0xC544, GCB_LV},
+  {0xC545, 0xC55F, GCB_LVT},
+  {0xC560, 0xC560, GCB_LV},
+  {0xC561, 0xC57B, GCB_LVT},
+  {0xC57C, 0xC57C, GCB_LV},
+  {0xC57D, 0xC597, GCB_LVT},
+  {0xC598, 0xC598, GCB_LV},
+  {0xC599, 0xC5B3, GCB_LVT},
+  {0xC5B4, 0xC5B4, GCB_LV},
+  {0xC5B5, 0xC5CF, GCB_LVT},
+  {0xC5D0, 0xC5D0, GCB_LV},
+  {0xC5D1, 0xC5EB, GCB_LVT},
+  {0xC5EC, 0xC5EC, GCB_LV},
+  {0xC5ED, 0xC607, GCB_LVT},
+  {0xC608, 0xC608, GCB_LV},
+  {0xC609, 0xC623, GCB_LVT},
+  {0xC624, 0xC624, GCB_LV},
+  {0xC625, 0xC63F, GCB_LVT},
+  {0xC640, 0xC640, GCB_LV},
+  {0xC641, 0xC65B, GCB_LVT},
+  {0xC65C, 0xC65C, GCB_LV},
+  {0xC65D, 0xC677, GCB_LVT},
+  {0xC678, 0xC678, GCB_LV},
+  {0xC679, 0xC693, GCB_LVT},
+  {0xC694, 0xC694, GCB_LV},
+  {0xC695, 0xC6AF, GCB_LVT},
+  {0xC6B0, 0xC6B0, GCB_LV},
+  {0xC6B1, 0xC6CB, GCB_LVT},
+  {0xC6CC, 0xC6CC, GCB_LV},
+  {0xC6CD, 0xC6E7, GCB_LVT},
+  {0xC6E8, 0xC6E8, GCB_LV},
+  {0xC6E9, 0xC703, GCB_LVT},
+  {0xC704, 0xC704, GCB_LV},
+  {0xC705, 0xC71F, GCB_LVT},
+  {0xC720, 0xC720, GCB_LV},
+  {0xC721, 0xC73B, GCB_LVT},
+  {0xC73C, 0xC73C, GCB_LV},
+  {0xC73D, 0xC757, GCB_LVT},
+  {0xC758, 0xC758, GCB_LV},
+  {0xC759, 0xC773, GCB_LVT},
+  {0xC774, 0xC774, GCB_LV},
+  {0xC775, 0xC78F, GCB_LVT},
+  {0xC790, 0xC790, GCB_LV},
+  {0xC791, 0xC7AB, GCB_LVT},
+  {0xC7AC, 0xC7AC, GCB_LV},
+  {0xC7AD, 0xC7C7, GCB_LVT},
+  {0xC7C8, 0xC7C8, GCB_LV},
+  {0xC7C9, 0xC7E3, GCB_LVT},
+  {0xC7E4, 0xC7E4, GCB_LV},
+  {0xC7E5, 0xC7FF, GCB_LVT},
+  {0xC800, 0xC800, GCB_LV},
+  {0xC801, 0xC81B, GCB_LVT},
+  {0xC81C, 0xC81C, GCB_LV},
+  {0xC81D, 0xC837, GCB_LVT},
+  {0xC838, 0xC838, GCB_LV},
+  {0xC839, 0xC853, GCB_LVT},
+  {0xC854, 0xC854, GCB_LV},
+  {0xC855, 0xC86F, GCB_LVT},
+  {0xC870, 0xC870, GCB_LV},
+  {0xC871, 0xC88B, GCB_LVT},
+  {0xC88C, 0xC88C, GCB_LV},
+  {0xC88D, 0xC8A7, GCB_LVT},
+  {0xC8A8, 0xC8A8, GCB_LV},
+  {0xC8A9, 0xC8C3, GCB_LVT},
+  {0xC8C4, 0xC8C4, GCB_LV},
+  {0xC8C5, 0xC8DF, GCB_LVT},
+  {0xC8E0, 0xC8E0, GCB_LV},
+  {0xC8E1, 0xC8FB, GCB_LVT},
+  {0xC8FC, 0xC8FC, GCB_LV},
+  {0xC8FD, 0xC917, GCB_LVT},
+  {0xC918, 0xC918, GCB_LV},
+  {0xC919, 0xC933, GCB_LVT},
+  {0xC934, 0xC934, GCB_LV},
+  {0xC935, 0xC94F, GCB_LVT},
+  {0xC950, 0xC950, GCB_LV},
+  {0xC951, 0xC96B, GCB_LVT},
+  {0xC96C, 0xC96C, GCB_LV},
+  {0xC96D, 0xC987, GCB_LVT},
+  {0xC988, 0xC988, GCB_LV},
+  {0xC989, 0xC9A3, GCB_LVT},
+  {0xC9A4, 0xC9A4, GCB_LV},
+  {0xC9A5, 0xC9BF, GCB_LVT},
+  {0xC9C0, 0xC9C0, GCB_LV},
+  {0xC9C1, 0xC9DB, GCB_LVT},
+  {0xC9DC, 0xC9DC, GCB_LV},
+  {0xC9DD, 0xC9F7, GCB_LVT},
+  {0xC9F8, 0xC9F8, GCB_LV},
+  {0xC9F9, 0xCA13, GCB_LVT},
+  {0xCA14, 0xCA14, GCB_LV},
+  {0xCA15, 0xCA2F, GCB_LVT},
+  {0xCA30, 0xCA30, GCB_LV},
+  {0xCA31, 0xCA4B, GCB_LVT},
+  {0xCA4C, 0xCA4C, GCB_LV},
+  {0xCA4D, 0xCA67, GCB_LVT},
+  {0xCA68, 0xCA68, GCB_LV},
+  {0xCA69, 0xCA83, GCB_LVT},
+  {0xCA84, 0xCA84, GCB_LV},
+  {0xCA85, 0xCA9F, GCB_LVT},
+  {0xCAA0, 0xCAA0, GCB_LV},
+  {0xCAA1, 0xCABB, GCB_LVT},
+  {0xCABC, 0xCABC, GCB_LV},
+  {0xCABD, 0xCAD7, GCB_LVT},
+  {0xCAD8, 0xCAD8, GCB_LV},
+  {0xCAD9, 0xCAF3, GCB_LVT},
+  {0xCAF4, 0xCAF4, GCB_LV},
+  {0xCAF5, 0xCB0F, GCB_LVT},
+  {0xCB10, 0xCB10, GCB_LV},
+  {0xCB11, 0xCB2B, GCB_LVT},
+  {0xCB2C, 0xCB2C, GCB_LV},
+  {0xCB2D, 0xCB47, GCB_LVT},
+  {0xCB48, 0xCB48, GCB_LV},
+  {0xCB49, 0xCB63, GCB_LVT},
+  {0xCB64, 0xCB64, GCB_LV},
+  {0xCB65, 0xCB7F, GCB_LVT},
+  {0xCB80, 0xCB80, GCB_LV},
+  {0xCB81, 0xCB9B, GCB_LVT},
+  {0xCB9C, 0xCB9C, GCB_LV},
+  {0xCB9D, 0xCBB7, GCB_LVT},
+  {0xCBB8, 0xCBB8, GCB_LV},
+  {0xCBB9, 0xCBD3, GCB_LVT},
+  {0xCBD4, 0xCBD4, GCB_LV},
+  {0xCBD5, 0xCBEF, GCB_LVT},
+  {0xCBF0, 0xCBF0, GCB_LV},
+  {0xCBF1, 0xCC0B, GCB_LVT},
+  {0xCC0C, 0xCC0C, GCB_LV},
+  {0xCC0D, 0xCC27, GCB_LVT},
+  {0xCC28, 0xCC28, GCB_LV},
+  {0xCC29, 0xCC43, GCB_LVT},
+  {0xCC44, 0xCC44, GCB_LV},
+  {0xCC45, 0xCC5F, GCB_LVT},
+  {0xCC60, 0xCC60, GCB_LV},
+  {0xCC61, 0xCC7B, GCB_LVT},
+  {0xCC7C, 0xCC7C, GCB_LV},
+  {0xCC7D, 0xCC97, GCB_LVT},
+  {0xCC98, 0xCC98, GCB_LV},
+  {0xCC99, 0xCCB3, GCB_LVT},
+  {0xCCB4, 0xCCB4, GCB_LV},
+  {0xCCB5, 0xCCCF, GCB_LVT},
+  {0xCCD0, 0xCCD0, GCB_LV},
+  {0xCCD1, 0xCCEB, GCB_LVT},
+  {0xCCEC, 0xCCEC, GCB_LV},
+  {0xCCED, 0xCD07, GCB_LVT},
+  {0xCD08, 0xCD08, GCB_LV},
+  {0xCD09, 0xCD23, GCB_LVT},
+  {0xCD24, 0xCD24, GCB_LV},
+  {0xCD25, 0xCD3F, GCB_LVT},
+  {0xCD40, 0xCD40, GCB_LV},
+  {0xCD41, 0xCD5B, GCB_LVT},
+  {0xCD5C, 0xCD5C, GCB_LV},
+  {0xCD5D, 0xCD77, GCB_LVT},
+  {0xCD78, 0xCD78, GCB_LV},
+  {0xCD79, 0xCD93, GCB_LVT},
+  {0xCD94, 0xCD94, GCB_LV},
+  {0xCD95, 0xCDAF, GCB_LVT},
+  {0xCDB0, 0xCDB0, GCB_LV},
+  {0xCDB1, 0xCDCB, GCB_LVT},
+  {0xCDCC, 0xCDCC, GCB_LV},
+  {0xCDCD, 0xCDE7, GCB_LVT},
+  {0xCDE8, 0xCDE8, GCB_LV},
+  {0xCDE9, 0xCE03, GCB_LVT},
+  {0xCE04, 0xCE04, GCB_LV},
+  {0xCE05, 0xCE1F, GCB_LVT},
+  {0xCE20, 0xCE20, GCB_LV},
+  {0xCE21, 0xCE3B, GCB_LVT},
+  {0xCE3C, 0xCE3C, GCB_LV},
+  {0xCE3D, 0xCE57, GCB_LVT},
+  {0xCE58, 0xCE58, GCB_LV},
+  {0xCE59, 0xCE73, GCB_LVT},
+  {0xCE74, 0xCE74, GCB_LV},
+  {0xCE75, 0xCE8F, GCB_LVT},
+  {0xCE90, 0xCE90, GCB_LV},
+  {0xCE91, 0xCEAB, GCB_LVT},
+  {0xCEAC, 0xCEAC, GCB_LV},
+  {0xCEAD, 0xCEC7, GCB_LVT},
+  {0xCEC8, 0xCEC8, GCB_LV},
+  {0xCEC9, 0xCEE3, GCB_LVT},
+  {0xCEE4, 0xCEE4, GCB_LV},
+  {0xCEE5, 0xCEFF, GCB_LVT},
+  {0xCF00, 0xCF00, GCB_LV},
+  {0xCF01, 0xCF1B, GCB_LVT},
+  {0xCF1C, 0xCF1C, GCB_LV},
+  {0xCF1D, 0xCF37, GCB_LVT},
+  {0xCF38, 0xCF38, GCB_LV},
+  {0xCF39, 0xCF53, GCB_LVT},
+  {0xCF54, 0xCF54, GCB_LV},
+  {0xCF55, 0xCF6F, GCB_LVT},
+  {0xCF70, 0xCF70, GCB_LV},
+  {0xCF71, 0xCF8B, GCB_LVT},
+  {0xCF8C, 0xCF8C, GCB_LV},
+  {0xCF8D, 0xCFA7, GCB_LVT},
+  {0xCFA8, 0xCFA8, GCB_LV},
+  {0xCFA9, 0xCFC3, GCB_LVT},
+  {0xCFC4, 0xCFC4, GCB_LV},
+  {0xCFC5, 0xCFDF, GCB_LVT},
+  {0xCFE0, 0xCFE0, GCB_LV},
+  {0xCFE1, 0xCFFB, GCB_LVT},
+  {0xCFFC, 0xCFFC, GCB_LV},
+  {0xCFFD, 0xD017, GCB_LVT},
+  {0xD018, 0xD018, GCB_LV},
+  {0xD019, 0xD033, GCB_LVT},
+  {0xD034, 0xD034, GCB_LV},
+  {0xD035, 0xD04F, GCB_LVT},
+  {0xD050, 0xD050, GCB_LV},
+  {0xD051, 0xD06B, GCB_LVT},
+  {0xD06C, 0xD06C, GCB_LV},
+  {0xD06D, 0xD087, GCB_LVT},
+  {0xD088, 0xD088, GCB_LV},
+  {0xD089, 0xD0A3, GCB_LVT},
+  {0xD0A4, 0xD0A4, GCB_LV},
+  {0xD0A5, 0xD0BF, GCB_LVT},
+  {0xD0C0, 0xD0C0, GCB_LV},
+  {0xD0C1, 0xD0DB, GCB_LVT},
+  {0xD0DC, 0xD0DC, GCB_LV},
+  {0xD0DD, 0xD0F7, GCB_LVT},
+  {0xD0F8, 0xD0F8, GCB_LV},
+  {0xD0F9, 0xD113, GCB_LVT},
+  {0xD114, 0xD114, GCB_LV},
+  {0xD115, 0xD12F, GCB_LVT},
+  {0xD130, 0xD130, GCB_LV},
+  {0xD131, 0xD14B, GCB_LVT},
+  {0xD14C, 0xD14C, GCB_LV},
+  {0xD14D, 0xD167, GCB_LVT},
+  {0xD168, 0xD168, GCB_LV},
+  {0xD169, 0xD183, GCB_LVT},
+  {0xD184, 0xD184, GCB_LV},
+  {0xD185, 0xD19F, GCB_LVT},
+  {0xD1A0, 0xD1A0, GCB_LV},
+  {0xD1A1, 0xD1BB, GCB_LVT},
+  {0xD1BC, 0xD1BC, GCB_LV},
+  {0xD1BD, 0xD1D7, GCB_LVT},
+  {0xD1D8, 0xD1D8, GCB_LV},
+  {0xD1D9, 0xD1F3, GCB_LVT},
+  {0xD1F4, 0xD1F4, GCB_LV},
+  {0xD1F5, 0xD20F, GCB_LVT},
+  {0xD210, 0xD210, GCB_LV},
+  {0xD211, 0xD22B, GCB_LVT},
+  {0xD22C, 0xD22C, GCB_LV},
+  {0xD22D, 0xD247, GCB_LVT},
+  {0xD248, 0xD248, GCB_LV},
+  {0xD249, 0xD263, GCB_LVT},
+  {0xD264, 0xD264, GCB_LV},
+  {0xD265, 0xD27F, GCB_LVT},
+  {0xD280, 0xD280, GCB_LV},
+  {0xD281, 0xD29B, GCB_LVT},
+  {0xD29C, 0xD29C, GCB_LV},
+  {0xD29D, 0xD2B7, GCB_LVT},
+  {0xD2B8, 0xD2B8, GCB_LV},
+  {0xD2B9, 0xD2D3, GCB_LVT},
+  {0xD2D4, 0xD2D4, GCB_LV},
+  {0xD2D5, 0xD2EF, GCB_LVT},
+  {0xD2F0, 0xD2F0, GCB_LV},
+  {0xD2F1, 0xD30B, GCB_LVT},
+  {0xD30C, 0xD30C, GCB_LV},
+  {0xD30D, 0xD327, GCB_LVT},
+  {0xD328, 0xD328, GCB_LV},
+  {0xD329, 0xD343, GCB_LVT},
+  {0xD344, 0xD344, GCB_LV},
+  {0xD345, 0xD35F, GCB_LVT},
+  {0xD360, 0xD360, GCB_LV},
+  {0xD361, 0xD37B, GCB_LVT},
+  {0xD37C, 0xD37C, GCB_LV},
+  {0xD37D, 0xD397, GCB_LVT},
+  {0xD398, 0xD398, GCB_LV},
+  {0xD399, 0xD3B3, GCB_LVT},
+  {0xD3B4, 0xD3B4, GCB_LV},
+  {0xD3B5, 0xD3CF, GCB_LVT},
+  {0xD3D0, 0xD3D0, GCB_LV},
+  {0xD3D1, 0xD3EB, GCB_LVT},
+  {0xD3EC, 0xD3EC, GCB_LV},
+  {0xD3ED, 0xD407, GCB_LVT},
+  {0xD408, 0xD408, GCB_LV},
+  {0xD409, 0xD423, GCB_LVT},
+  {0xD424, 0xD424, GCB_LV},
+  {0xD425, 0xD43F, GCB_LVT},
+  {0xD440, 0xD440, GCB_LV},
+  {0xD441, 0xD45B, GCB_LVT},
+  {0xD45C, 0xD45C, GCB_LV},
+  {0xD45D, 0xD477, GCB_LVT},
+  {0xD478, 0xD478, GCB_LV},
+  {0xD479, 0xD493, GCB_LVT},
+  {0xD494, 0xD494, GCB_LV},
+  {0xD495, 0xD4AF, GCB_LVT},
+  {0xD4B0, 0xD4B0, GCB_LV},
+  {0xD4B1, 0xD4CB, GCB_LVT},
+  {0xD4CC, 0xD4CC, GCB_LV},
+  {0xD4CD, 0xD4E7, GCB_LVT},
+  {0xD4E8, 0xD4E8, GCB_LV},
+  {0xD4E9, 0xD503, GCB_LVT},
+  {0xD504, 0xD504, GCB_LV},
+  {0xD505, 0xD51F, GCB_LVT},
+  {0xD520, 0xD520, GCB_LV},
+  {0xD521, 0xD53B, GCB_LVT},
+  {0xD53C, 0xD53C, GCB_LV},
+  {0xD53D, 0xD557, GCB_LVT},
+  {0xD558, 0xD558, GCB_LV},
+  {0xD559, 0xD573, GCB_LVT},
+  {0xD574, 0xD574, GCB_LV},
+  {0xD575, 0xD58F, GCB_LVT},
+  {0xD590, 0xD590, GCB_LV},
+  {0xD591, 0xD5AB, GCB_LVT},
+  {0xD5AC, 0xD5AC, GCB_LV},
+  {0xD5AD, 0xD5C7, GCB_LVT},
+  {0xD5C8, 0xD5C8, GCB_LV},
+  {0xD5C9, 0xD5E3, GCB_LVT},
+  {0xD5E4, 0xD5E4, GCB_LV},
+  {0xD5E5, 0xD5FF, GCB_LVT},
+  {0xD600, 0xD600, GCB_LV},
+  {0xD601, 0xD61B, GCB_LVT},
+  {0xD61C, 0xD61C, GCB_LV},
+  {0xD61D, 0xD637, GCB_LVT},
+  {0xD638, 0xD638, GCB_LV},
+  {0xD639, 0xD653, GCB_LVT},
+  {0xD654, 0xD654, GCB_LV},
+  {0xD655, 0xD66F, GCB_LVT},
+  {0xD670, 0xD670, GCB_LV},
+  {0xD671, 0xD68B, GCB_LVT},
+  {0xD68C, 0xD68C, GCB_LV},
+  {0xD68D, 0xD6A7, GCB_LVT},
+  {0xD6A8, 0xD6A8, GCB_LV},
+  {0xD6A9, 0xD6C3, GCB_LVT},
+  {0xD6C4, 0xD6C4, GCB_LV},
+  {0xD6C5, 0xD6DF, GCB_LVT},
+  {0xD6E0, 0xD6E0, GCB_LV},
+  {0xD6E1, 0xD6FB, GCB_LVT},
+  {0xD6FC, 0xD6FC, GCB_LV},
+  {0xD6FD, 0xD717, GCB_LVT},
+  {0xD718, 0xD718, GCB_LV},
+  {0xD719, 0xD733, GCB_LVT},
+  {0xD734, 0xD734, GCB_LV},
+  {0xD735, 0xD74F, GCB_LVT},
+  {0xD750, 0xD750, GCB_LV},
+  {0xD751, 0xD76B, GCB_LVT},
+  {0xD76C, 0xD76C, GCB_LV},
+  {0xD76D, 0xD787, GCB_LVT},
+  {0xD788, 0xD788, GCB_LV},
+  {0xD789, 0xD7A3, GCB_LVT},
+  {0xD7B0, 0xD7C6, GCB_V},
+  {0xD7CB, 0xD7FB, GCB_T},
+  {0xFB1E, 0xFB1E, GCB_Extend},
+  {0xFE00, 0xFE0F, GCB_Extend},
+  {0xFE20, 0xFE2F, GCB_Extend},
+  {0xFEFF, 0xFEFF, GCB_Control},
+  {0xFF9E, 0xFF9F, GCB_Extend},
+  {0xFFF0, 0xFFFB, GCB_Control},
+  {0x101FD, 0x101FD, GCB_Extend},
+  {0x102E0, 0x102E0, GCB_Extend},
+  {0x10376, 0x1037A, GCB_Extend},
+  {0x10A01, 0x10A03, GCB_Extend},
+  {0x10A05, 0x10A06, GCB_Extend},
+  {0x10A0C, 0x10A0F, GCB_Extend},
+  {0x10A38, 0x10A3A, GCB_Extend},
+  {0x10A3F, 0x10A3F, GCB_Extend},
+  {0x10AE5, 0x10AE6, GCB_Extend},
+  {0x10D24, 0x10D27, GCB_Extend},
+  {0x10EAB, 0x10EAC, GCB_Extend},
+  {0x10F46, 0x10F50, GCB_Extend},
+  {0x10F82, 0x10F85, GCB_Extend},
+  {0x11000, 0x11000, GCB_SpacingMark},
+  {0x11001, 0x11001, GCB_Extend},
+  {0x11002, 0x11002, GCB_SpacingMark},
+  {0x11038, 0x11046, GCB_Extend},
+  {0x11070, 0x11070, GCB_Extend},
+  {0x11073, 0x11074, GCB_Extend},
+  {0x1107F, 0x11081, GCB_Extend},
+  {0x11082, 0x11082, GCB_SpacingMark},
+  {0x110B0, 0x110B2, GCB_SpacingMark},
+  {0x110B3, 0x110B6, GCB_Extend},
+  {0x110B7, 0x110B8, GCB_SpacingMark},
+  {0x110B9, 0x110BA, GCB_Extend},
+  {0x110BD, 0x110BD, GCB_Prepend},
+  {0x110C2, 0x110C2, GCB_Extend},
+  {0x110CD, 0x110CD, GCB_Prepend},
+  {0x11100, 0x11102, GCB_Extend},
+  {0x11127, 0x1112B, GCB_Extend},
+  {0x1112C, 0x1112C, GCB_SpacingMark},
+  {0x1112D, 0x11134, GCB_Extend},
+  {0x11145, 0x11146, GCB_SpacingMark},
+  {0x11173, 0x11173, GCB_Extend},
+  {0x11180, 0x11181, GCB_Extend},
+  {0x11182, 0x11182, GCB_SpacingMark},
+  {0x111B3, 0x111B5, GCB_SpacingMark},
+  {0x111B6, 0x111BE, GCB_Extend},
+  {0x111BF, 0x111C0, GCB_SpacingMark},
+  {0x111C2, 0x111C3, GCB_Prepend},
+  {0x111C9, 0x111CC, GCB_Extend},
+  {0x111CE, 0x111CE, GCB_SpacingMark},
+  {0x111CF, 0x111CF, GCB_Extend},
+  {0x1122C, 0x1122E, GCB_SpacingMark},
+  {0x1122F, 0x11231, GCB_Extend},
+  {0x11232, 0x11233, GCB_SpacingMark},
+  {0x11234, 0x11234, GCB_Extend},
+  {0x11235, 0x11235, GCB_SpacingMark},
+  {0x11236, 0x11237, GCB_Extend},
+  {0x1123E, 0x1123E, GCB_Extend},
+  {0x112DF, 0x112DF, GCB_Extend},
+  {0x112E0, 0x112E2, GCB_SpacingMark},
+  {0x112E3, 0x112EA, GCB_Extend},
+  {0x11300, 0x11301, GCB_Extend},
+  {0x11302, 0x11303, GCB_SpacingMark},
+  {0x1133B, 0x1133C, GCB_Extend},
+  {0x1133E, 0x1133E, GCB_Extend},
+  {0x1133F, 0x1133F, GCB_SpacingMark},
+  {0x11340, 0x11340, GCB_Extend},
+  {0x11341, 0x11344, GCB_SpacingMark},
+  {0x11347, 0x11348, GCB_SpacingMark},
+  {0x1134B, 0x1134D, GCB_SpacingMark},
+  {0x11357, 0x11357, GCB_Extend},
+  {0x11362, 0x11363, GCB_SpacingMark},
+  {0x11366, 0x1136C, GCB_Extend},
+  {0x11370, 0x11374, GCB_Extend},
+  {0x11435, 0x11437, GCB_SpacingMark},
+  {0x11438, 0x1143F, GCB_Extend},
+  {0x11440, 0x11441, GCB_SpacingMark},
+  {0x11442, 0x11444, GCB_Extend},
+  {0x11445, 0x11445, GCB_SpacingMark},
+  {0x11446, 0x11446, GCB_Extend},
+  {0x1145E, 0x1145E, GCB_Extend},
+  {0x114B0, 0x114B0, GCB_Extend},
+  {0x114B1, 0x114B2, GCB_SpacingMark},
+  {0x114B3, 0x114B8, GCB_Extend},
+  {0x114B9, 0x114B9, GCB_SpacingMark},
+  {0x114BA, 0x114BA, GCB_Extend},
+  {0x114BB, 0x114BC, GCB_SpacingMark},
+  {0x114BD, 0x114BD, GCB_Extend},
+  {0x114BE, 0x114BE, GCB_SpacingMark},
+  {0x114BF, 0x114C0, GCB_Extend},
+  {0x114C1, 0x114C1, GCB_SpacingMark},
+  {0x114C2, 0x114C3, GCB_Extend},
+  {0x115AF, 0x115AF, GCB_Extend},
+  {0x115B0, 0x115B1, GCB_SpacingMark},
+  {0x115B2, 0x115B5, GCB_Extend},
+  {0x115B8, 0x115BB, GCB_SpacingMark},
+  {0x115BC, 0x115BD, GCB_Extend},
+  {0x115BE, 0x115BE, GCB_SpacingMark},
+  {0x115BF, 0x115C0, GCB_Extend},
+  {0x115DC, 0x115DD, GCB_Extend},
+  {0x11630, 0x11632, GCB_SpacingMark},
+  {0x11633, 0x1163A, GCB_Extend},
+  {0x1163B, 0x1163C, GCB_SpacingMark},
+  {0x1163D, 0x1163D, GCB_Extend},
+  {0x1163E, 0x1163E, GCB_SpacingMark},
+  {0x1163F, 0x11640, GCB_Extend},
+  {0x116AB, 0x116AB, GCB_Extend},
+  {0x116AC, 0x116AC, GCB_SpacingMark},
+  {0x116AD, 0x116AD, GCB_Extend},
+  {0x116AE, 0x116AF, GCB_SpacingMark},
+  {0x116B0, 0x116B5, GCB_Extend},
+  {0x116B6, 0x116B6, GCB_SpacingMark},
+  {0x116B7, 0x116B7, GCB_Extend},
+  {0x1171D, 0x1171F, GCB_Extend},
+  {0x11722, 0x11725, GCB_Extend},
+  {0x11726, 0x11726, GCB_SpacingMark},
+  {0x11727, 0x1172B, GCB_Extend},
+  {0x1182C, 0x1182E, GCB_SpacingMark},
+  {0x1182F, 0x11837, GCB_Extend},
+  {0x11838, 0x11838, GCB_SpacingMark},
+  {0x11839, 0x1183A, GCB_Extend},
+  {0x11930, 0x11930, GCB_Extend},
+  {0x11931, 0x11935, GCB_SpacingMark},
+  {0x11937, 0x11938, GCB_SpacingMark},
+  {0x1193B, 0x1193C, GCB_Extend},
+  {0x1193D, 0x1193D, GCB_SpacingMark},
+  {0x1193E, 0x1193E, GCB_Extend},
+  {0x1193F, 0x1193F, GCB_Prepend},
+  {0x11940, 0x11940, GCB_SpacingMark},
+  {0x11941, 0x11941, GCB_Prepend},
+  {0x11942, 0x11942, GCB_SpacingMark},
+  {0x11943, 0x11943, GCB_Extend},
+  {0x119D1, 0x119D3, GCB_SpacingMark},
+  {0x119D4, 0x119D7, GCB_Extend},
+  {0x119DA, 0x119DB, GCB_Extend},
+  {0x119DC, 0x119DF, GCB_SpacingMark},
+  {0x119E0, 0x119E0, GCB_Extend},
+  {0x119E4, 0x119E4, GCB_SpacingMark},
+  {0x11A01, 0x11A0A, GCB_Extend},
+  {0x11A33, 0x11A38, GCB_Extend},
+  {0x11A39, 0x11A39, GCB_SpacingMark},
+  {0x11A3A, 0x11A3A, GCB_Prepend},
+  {0x11A3B, 0x11A3E, GCB_Extend},
+  {0x11A47, 0x11A47, GCB_Extend},
+  {0x11A51, 0x11A56, GCB_Extend},
+  {0x11A57, 0x11A58, GCB_SpacingMark},
+  {0x11A59, 0x11A5B, GCB_Extend},
+  {0x11A84, 0x11A89, GCB_Prepend},
+  {0x11A8A, 0x11A96, GCB_Extend},
+  {0x11A97, 0x11A97, GCB_SpacingMark},
+  {0x11A98, 0x11A99, GCB_Extend},
+  {0x11C2F, 0x11C2F, GCB_SpacingMark},
+  {0x11C30, 0x11C36, GCB_Extend},
+  {0x11C38, 0x11C3D, GCB_Extend},
+  {0x11C3E, 0x11C3E, GCB_SpacingMark},
+  {0x11C3F, 0x11C3F, GCB_Extend},
+  {0x11C92, 0x11CA7, GCB_Extend},
+  {0x11CA9, 0x11CA9, GCB_SpacingMark},
+  {0x11CAA, 0x11CB0, GCB_Extend},
+  {0x11CB1, 0x11CB1, GCB_SpacingMark},
+  {0x11CB2, 0x11CB3, GCB_Extend},
+  {0x11CB4, 0x11CB4, GCB_SpacingMark},
+  {0x11CB5, 0x11CB6, GCB_Extend},
+  {0x11D31, 0x11D36, GCB_Extend},
+  {0x11D3A, 0x11D3A, GCB_Extend},
+  {0x11D3C, 0x11D3D, GCB_Extend},
+  {0x11D3F, 0x11D45, GCB_Extend},
+  {0x11D46, 0x11D46, GCB_Prepend},
+  {0x11D47, 0x11D47, GCB_Extend},
+  {0x11D8A, 0x11D8E, GCB_SpacingMark},
+  {0x11D90, 0x11D91, GCB_Extend},
+  {0x11D93, 0x11D94, GCB_SpacingMark},
+  {0x11D95, 0x11D95, GCB_Extend},
+  {0x11D96, 0x11D96, GCB_SpacingMark},
+  {0x11D97, 0x11D97, GCB_Extend},
+  {0x11EF3, 0x11EF4, GCB_Extend},
+  {0x11EF5, 0x11EF6, GCB_SpacingMark},
+  {0x13430, 0x13438, GCB_Control},
+  {0x16AF0, 0x16AF4, GCB_Extend},
+  {0x16B30, 0x16B36, GCB_Extend},
+  {0x16F4F, 0x16F4F, GCB_Extend},
+  {0x16F51, 0x16F87, GCB_SpacingMark},
+  {0x16F8F, 0x16F92, GCB_Extend},
+  {0x16FE4, 0x16FE4, GCB_Extend},
+  {0x16FF0, 0x16FF1, GCB_SpacingMark},
+  {0x1BC9D, 0x1BC9E, GCB_Extend},
+  {0x1BCA0, 0x1BCA3, GCB_Control},
+  {0x1CF00, 0x1CF2D, GCB_Extend},
+  {0x1CF30, 0x1CF46, GCB_Extend},
+  {0x1D165, 0x1D165, GCB_Extend},
+  {0x1D166, 0x1D166, GCB_SpacingMark},
+  {0x1D167, 0x1D169, GCB_Extend},
+  {0x1D16D, 0x1D16D, GCB_SpacingMark},
+  {0x1D16E, 0x1D172, GCB_Extend},
+  {0x1D173, 0x1D17A, GCB_Control},
+  {0x1D17B, 0x1D182, GCB_Extend},
+  {0x1D185, 0x1D18B, GCB_Extend},
+  {0x1D1AA, 0x1D1AD, GCB_Extend},
+  {0x1D242, 0x1D244, GCB_Extend},
+  {0x1DA00, 0x1DA36, GCB_Extend},
+  {0x1DA3B, 0x1DA6C, GCB_Extend},
+  {0x1DA75, 0x1DA75, GCB_Extend},
+  {0x1DA84, 0x1DA84, GCB_Extend},
+  {0x1DA9B, 0x1DA9F, GCB_Extend},
+  {0x1DAA1, 0x1DAAF, GCB_Extend},
+  {0x1E000, 0x1E006, GCB_Extend},
+  {0x1E008, 0x1E018, GCB_Extend},
+  {0x1E01B, 0x1E021, GCB_Extend},
+  {0x1E023, 0x1E024, GCB_Extend},
+  {0x1E026, 0x1E02A, GCB_Extend},
+  {0x1E130, 0x1E136, GCB_Extend},
+  {0x1E2AE, 0x1E2AE, GCB_Extend},
+  {0x1E2EC, 0x1E2EF, GCB_Extend},
+  {0x1E8D0, 0x1E8D6, GCB_Extend},
+  {0x1E944, 0x1E94A, GCB_Extend},
+  {0x1F000, 0x1F0FF, GCB_ExtPict},
+  {0x1F10D, 0x1F10F, GCB_ExtPict},
+  {0x1F12F, 0x1F12F, GCB_ExtPict},
+  {0x1F16C, 0x1F171, GCB_ExtPict},
+  {0x1F17E, 0x1F17F, GCB_ExtPict},
+  {0x1F18E, 0x1F18E, GCB_ExtPict},
+  {0x1F191, 0x1F19A, GCB_ExtPict},
+  {0x1F1AD, 0x1F1E5, GCB_ExtPict},
+  {0x1F1E6, 0x1F1FF, GCB_RI},
+  {0x1F201, 0x1F20F, GCB_ExtPict},
+  {0x1F21A, 0x1F21A, GCB_ExtPict},
+  {0x1F22F, 0x1F22F, GCB_ExtPict},
+  {0x1F232, 0x1F23A, GCB_ExtPict},
+  {0x1F23C, 0x1F23F, GCB_ExtPict},
+  {0x1F249, 0x1F3FA, GCB_ExtPict},
+  {0x1F3FB, 0x1F3FF, GCB_Extend},
+  {0x1F400, 0x1F53D, GCB_ExtPict},
+  {0x1F546, 0x1F64F, GCB_ExtPict},
+  {0x1F680, 0x1F6FF, GCB_ExtPict},
+  {0x1F774, 0x1F77F, GCB_ExtPict},
+  {0x1F7D5, 0x1F7FF, GCB_ExtPict},
+  {0x1F80C, 0x1F80F, GCB_ExtPict},
+  {0x1F848, 0x1F84F, GCB_ExtPict},
+  {0x1F85A, 0x1F85F, GCB_ExtPict},
+  {0x1F888, 0x1F88F, GCB_ExtPict},
+  {0x1F8AE, 0x1F8FF, GCB_ExtPict},
+  {0x1F90C, 0x1F93A, GCB_ExtPict},
+  {0x1F93C, 0x1F945, GCB_ExtPict},
+  {0x1F947, 0x1FAFF, GCB_ExtPict},
+  {0x1FC00, 0x1FFFD, GCB_ExtPict},
+  {0xE0000, 0xE001F, GCB_Control},
+  {0xE0020, 0xE007F, GCB_Extend},
+  {0xE0080, 0xE00FF, GCB_Control},
+  {0xE0100, 0xE01EF, GCB_Extend},
+  {0xE01F0, 0xE0FFF, GCB_Control},
@@ -0,0 +1,891 @@
+// headless.c (part of mintty)
+// Licensed under the terms of the GNU General Public License v3 or later.
+
+/*
+ * Headless front end for benchmarking and testing the terminal core on
+ * platforms other than Windows. It implements the win_* interface by
+ * rendering into an in-memory RGBA framebuffer with a built-in bitmap
+ * font, feeds its input files through the terminal in fixed-size chunks,
+ * each followed by a display update, and can dump the final screen as a
+ * PPM image. Time is simulated, so the image only depends on the input
+ * and the options. It drives a single terminal, and its renderer state is
+ * global, so parallel runs use separate processes.
+ */
+
+#include "term.h"
+#include "win.h"
+#include "charset.h"
+#include "child.h"
+#include "print.h"
+#include "glyphcache.h"
+
+#include <getopt.h>
+#include <time.h>
+
+config cfg = {
+  .fg_colour = 0xBFBFBF,
+  .bg_colour = 0x000000,
+  .cursor_colour = 0xBFBFBF,
+  .cursor_type = CUR_BLOCK,
+  .cursor_blinks = false,
+  .bold_as_font = -1,
+  .bold_as_colour = true,
+  .allow_blinking = true,
+  .locale = "",
+  .charset = "",
+  .copy_on_select = false,
+  .right_click_action = RC_MENU,
+  .clicks_target_app = true,
+  .click_target_mod = MDK_SHIFT,
+  .cols = 80,
+  .rows = 24,
+  .scrollback_lines = 10000,
+  .term = "xterm",
+  .answerback = "",
+  .printer = "",
+  .word_chars = "",
+  .ime_cursor_colour = DEFAULT_COLOUR,
+  .latency_log = "",
+  .trace_file = "",
+  .ansi_colours = {
+    [BLACK_I]        = 0x000000,
+    [RED_I]          = 0x0000BF,
+    [GREEN_I]        = 0x00BF00,
+    [YELLOW_I]       = 0x00BFBF,
+    [BLUE_I]         = 0xBF0000,
+    [MAGENTA_I]      = 0xBF00BF,
+    [CYAN_I]         = 0xBFBF00,
+    [WHITE_I]        = 0xBFBFBF,
+    [BOLD_BLACK_I]   = 0x404040,
+    [BOLD_RED_I]     = 0x4040FF,
+    [BOLD_GREEN_I]   = 0x40FF40,
+    [BOLD_YELLOW_I]  = 0x40FFFF,
+    [BOLD_BLUE_I]    = 0xFF6060,
+    [BOLD_MAGENTA_I] = 0xFF40FF,
+    [BOLD_CYAN_I]    = 0xFFFF40,
+    [BOLD_WHITE_I]   = 0xFFFFFF,
+  }
+};
+
+bool
+parse_colour(string s, colour *cp)
+{
+  uint r, g, b;
+  if (sscanf(s, "%u,%u,%u%c", &r, &g, &b, &(char){0}) == 3);
+  else if (sscanf(s, "#%2x%2x%2x%c", &r, &g, &b, &(char){0}) == 3);
+  else if (sscanf(s, "rgb:%2x/%2x/%2x%c", &r, &g, &b, &(char){0}) == 3);
+  else if (sscanf(s, "rgb:%4x/%4x/%4x%c", &r, &g, &b, &(char){0}) == 3)
+    r >>=8, g >>= 8, b >>= 8;
+  else
+    return false;  
+
+  *cp = make_colour(r, g, b);
+  return true;
+}
+
+
+/*
+ * Charset: input is always UTF-8.
+ */
+
+bool font_ambig_wide;
+
+string cs_get_locale(void) { return "C.UTF-8"; }
+void cs_select(cs_mode unused(mode), string unused(locale)) {}
+
+int
+cs_mb1towc(cs_decoder *d, wchar *pwc, char c)
+{
+  if (!pwc) {
+    d->n = 0;
+    return 0;
+  }
+  if (d->n < 0) {
+    // Leftover surrogate
+    *pwc = d->ws[1];
+    d->n = 0;
+    return 1;
+  }
+
+  uchar b = c;
+  if (d->n && (b & 0xC0) != 0x80) {
+    d->n = 0;
+    return -1;
+  }
+  d->s[d->n++] = c;
+
+  uchar b0 = d->s[0];
+  int len =
+    b0 < 0x80 ? 1 :
+    b0 >= 0xC2 && b0 < 0xE0 ? 2 :
+    b0 >= 0xE0 && b0 < 0xF0 ? 3 :
+    b0 >= 0xF0 && b0 < 0xF5 ? 4 : 0;
+  if (!len) {
+    d->n = 0;
+    return -1;
+  }
+  if (d->n < len)
+    return -2;
+
+  xchar xc = len == 1 ? b0 : b0 & (0x7F >> len);
+  for (int i = 1; i < len; i++)
+    xc = xc << 6 | (d->s[i] & 0x3F);
+  d->n = 0;
+
+  if (xc >= 0x110000 || (xc >= 0xD800 && xc < 0xE000))
+    return -1;
+  if (xc >= 0x10000) {
+    *pwc = high_surrogate(xc);
+    d->ws[1] = low_surrogate(xc);
+    d->n = -1;
+    return 0;
+  }
+  *pwc = xc;
+  return 1;
+}
+
+wchar cs_btowc_glyph(char c) { return (uchar)c; }
+
+
+/*
+ * Child process: there isn't one, so responses are counted and dropped.
+ */
+
+static uint child_bytes;
+
+void child_write(const char *unused(buf), uint len) { child_bytes += len; }
+uint child_write_backlog(void) { return 0; }
+uint child_read_backlog(void) { return 0; }
+void child_sendw(const wchar *unused(ws), uint len) { child_bytes += len; }
+
+void
+child_printf(const char *fmt, ...)
+{
+  va_list va;
+  va_start(va, fmt);
+  child_bytes += vsnprintf(0, 0, fmt, va);
+  va_end(va);
+}
+
+void printer_start_job(string unused(printer_name)) {}
+void printer_write(void *unused(data), uint unused(len)) {}
+void printer_finish_job(void) {}
+
+
+/*
+ * Simulated time and timers.
+ */
+
+static int ticks;
+
+int get_tick_count(void) { return ticks; }
+int cursor_blink_ticks(void) { return 500; }
+
+static struct {
+  void_fn cb;
+  int due;
+} timers[8];
+
+void
+win_set_timer(void_fn cb, uint ticks_from_now)
+{
+  uint i = 0;
+  while (i < lengthof(timers) - 1 && timers[i].cb && timers[i].cb != cb)
+    i++;
+  timers[i].cb = cb;
+  timers[i].due = ticks + ticks_from_now;
+}
+
+static void
+run_timers(void)
+{
+  for (uint i = 0; i < lengthof(timers); i++) {
+    void_fn cb = timers[i].cb;
+    if (cb && timers[i].due <= ticks) {
+      timers[i].cb = 0;
+      cb();
+    }
+  }
+}
+
+
+/*
+ * Window management: the window is always exactly the size of the screen.
+ */
+
+enum { CELL_WIDTH = 6, CELL_HEIGHT = 12, GLYPH_TOP = 2, GLYPH_HEIGHT = 9 };
+
+static uint *pixels;
+static int pixels_width, pixels_height;
+static bool update_pending, full_update = true;
+static uint bells, frames;
+
+static colour colours[COLOUR_NUM];
+
+static void
+resize_pixels(int rows, int cols)
+{
+  pixels_width = cols * CELL_WIDTH;
+  pixels_height = rows * CELL_HEIGHT;
+  free(pixels);
+  pixels = newn(uint, pixels_width * pixels_height);
+}
+
+void
+win_set_chars(int rows, int cols)
+{
+  term_resize(rows, cols);
+  resize_pixels(rows, cols);
+  win_invalidate_all();
+}
+
+void
+win_set_pixels(int height, int width)
+{
+  win_set_chars(height / CELL_HEIGHT, width / CELL_WIDTH);
+}
+
+void
+win_get_pixels(int *height_p, int *width_p)
+{
+  *height_p = pixels_height;
+  *width_p = pixels_width;
+}
+
+void
+win_get_screen_chars(int *rows_p, int *cols_p)
+{
+  *rows_p = 1000;
+  *cols_p = 1000;
+}
+
+void win_get_pos(int *xp, int *yp) { *xp = *yp = 0; }
+void win_set_pos(int unused(x), int unused(y)) {}
+void win_maximise(int unused(max)) {}
+void win_set_zorder(bool unused(top)) {}
+void win_set_iconic(bool unused(iconic)) {}
+bool win_is_iconic(void) { return false; }
+void win_update_scrollbar(void) {}
+void win_popup_menu(void) {}
+
+void win_set_title(char *unused(title)) {}
+void win_save_title(void) {}
+void win_restore_title(void) {}
+
+void win_bell(void) { bells++; }
+void win_update_mouse(void) {}
+void win_capture_mouse(void) {}
+
+void win_zoom_font(int unused(zoom)) {}
+void win_set_font_size(int unused(size)) {}
+uint win_get_font_size(void) { return CELL_HEIGHT; }
+
+void win_open(wstring unused(path)) {}
+void win_copy(const wchar *unused(data), uint *unused(attrs), int unused(len)) {}
+void win_get_copy_style(copy_style *unused(style)) {}
+clip_data *
+win_prepare_copy(const wchar *unused(data), uint *unused(attrs), int unused(len),
+                 const copy_style *unused(style), const bool *unused(cancel))
+{ return 0; }
+void win_finish_copy(clip_data *unused(clip), bool unused(to_clipboard)) {}
+void win_paste(void) {}
+
+void win_update(void) { update_pending = full_update = true; }
+void win_update_overlays(void) { update_pending = true; }
+void win_schedule_update(void) { update_pending = full_update = true; }
+
+void
+win_invalidate_all(void)
+{
+  term_invalidate(0, 0, term->cols - 1, term->rows - 1);
+  update_pending = full_update = true;
+}
+
+
+/*
+ * Colours.
+ */
+
+static colour 
+brighten(colour c)
+{
+  uint r = red(c), g = green(c), b = blue(c);   
+  uint s = min(85, 255 - max(max(r, g), b));
+  return make_colour(r + s, g + s, b + s);
+}
+
+void
+win_set_colour(colour_i i, colour c)
+{
+  if (i >= COLOUR_NUM)
+    return;
+  colours[i] = c;
+  switch (i) {
+    when FG_COLOUR_I:
+      colours[BOLD_FG_COLOUR_I] = brighten(c);
+    when BG_COLOUR_I:
+      colours[BOLD_BG_COLOUR_I] = brighten(c);
+    when CURSOR_COLOUR_I: {
+      colour fg = colours[FG_COLOUR_I], bg = colours[BG_COLOUR_I];
+      colours[CURSOR_TEXT_COLOUR_I] =
+        colour_dist(c, fg) > colour_dist(c, bg) ? fg : bg;
+      colours[IME_CURSOR_COLOUR_I] = c;
+    }
+    otherwise:
+      break;
+  }
+  win_invalidate_all();
+}
+
+colour win_get_colour(colour_i i) { return i < COLOUR_NUM ? colours[i] : 0; }
+
+void
+win_reset_colours(void)
+{
+  memcpy(colours, cfg.ansi_colours, sizeof cfg.ansi_colours);
+
+  // Colour cube
+  colour_i i = 16;
+  for (uint r = 0; r < 6; r++)
+    for (uint g = 0; g < 6; g++)
+      for (uint b = 0; b < 6; b++)
+        colours[i++] = make_colour(r ? r * 40 + 55 : 0,
+                                   g ? g * 40 + 55 : 0,
+                                   b ? b * 40 + 55 : 0);
+  
+  // Grayscale
+  for (uint s = 0; s < 24; s++) {
+    uint c = s * 10 + 8;
+    colours[i++] = make_colour(c, c, c);
+  }
+
+  // Foreground, background, cursor
+  win_set_colour(FG_COLOUR_I, cfg.fg_colour);
+  win_set_colour(BG_COLOUR_I, cfg.bg_colour);
+  win_set_colour(CURSOR_COLOUR_I, cfg.cursor_colour);
+}
+
+
+/*
+ * The built-in font: 5x9 pixel glyphs for printable ASCII, in 6x12 cells,
+ * one row per byte with the leftmost pixel in bit 4. The last two rows
+ * are for descenders.
+ */
+
+static const uchar font_glyphs[0x5F][GLYPH_HEIGHT] = {
+  {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},  // space
+  {0x04, 0x04, 0x04, 0x04, 0x04, 0x00, 0x04, 0x00, 0x00},  // !
+  {0x0A, 0x0A, 0x0A, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},  // "
+  {0x0A, 0x0A, 0x1F, 0x0A, 0x1F, 0x0A, 0x0A, 0x00, 0x00},  // #
+  {0x04, 0x0F, 0x14, 0x0E, 0x05, 0x1E, 0x04, 0x00, 0x00},  // $
+  {0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03, 0x00, 0x00},  // %
+  {0x0C, 0x12, 0x14, 0x08, 0x15, 0x12, 0x0D, 0x00, 0x00},  // &
+  {0x04, 0x04, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},  // '
+  {0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02, 0x00, 0x00},  // (
+  {0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08, 0x00, 0x00},  // )
+  {0x00, 0x04, 0x15, 0x0E, 0x15, 0x04, 0x00, 0x00, 0x00},  // *
+  {0x00, 0x04, 0x04, 0x1F, 0x04, 0x04, 0x00, 0x00, 0x00},  // +
+  {0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x04, 0x08, 0x00},  // ,
+  {0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00, 0x00, 0x00},  // -
+  {0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C, 0x00, 0x00},  // .
+  {0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00, 0x00, 0x00},  // /
+  {0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E, 0x00, 0x00},  // 0
+  {0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E, 0x00, 0x00},  // 1
+  {0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F, 0x00, 0x00},  // 2
+  {0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E, 0x00, 0x00},  // 3
+  {0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02, 0x00, 0x00},  // 4
+  {0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E, 0x00, 0x00},  // 5
+  {0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E, 0x00, 0x00},  // 6
+  {0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08, 0x00, 0x00},  // 7
+  {0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E, 0x00, 0x00},  // 8
+  {0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C, 0x00, 0x00},  // 9
+  {0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00, 0x00, 0x00},  // :
+  {0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x04, 0x08, 0x00, 0x00},  // ;
+  {0x02, 0x04, 0x08, 0x10, 0x08, 0x04, 0x02, 0x00, 0x00},  // <
+  {0x00, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x00, 0x00, 0x00},  // =
+  {0x08, 0x04, 0x02, 0x01, 0x02, 0x04, 0x08, 0x00, 0x00},  // >
+  {0x0E, 0x11, 0x01, 0x02, 0x04, 0x00, 0x04, 0x00, 0x00},  // ?
+  {0x0E, 0x11, 0x01, 0x0D, 0x15, 0x15, 0x0E, 0x00, 0x00},  // @
+  {0x0E, 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x00, 0x00},  // A
+  {0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E, 0x00, 0x00},  // B
+  {0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E, 0x00, 0x00},  // C
+  {0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C, 0x00, 0x00},  // D
+  {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F, 0x00, 0x00},  // E
+  {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10, 0x00, 0x00},  // F
+  {0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F, 0x00, 0x00},  // G
+  {0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11, 0x00, 0x00},  // H
+  {0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E, 0x00, 0x00},  // I
+  {0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C, 0x00, 0x00},  // J
+  {0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11, 0x00, 0x00},  // K
+  {0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F, 0x00, 0x00},  // L
+  {0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11, 0x00, 0x00},  // M
+  {0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11, 0x00, 0x00},  // N
+  {0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E, 0x00, 0x00},  // O
+  {0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10, 0x00, 0x00},  // P
+  {0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D, 0x00, 0x00},  // Q
+  {0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11, 0x00, 0x00},  // R
+  {0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E, 0x00, 0x00},  // S
+  {0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x00, 0x00},  // T
+  {0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E, 0x00, 0x00},  // U
+  {0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04, 0x00, 0x00},  // V
+  {0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A, 0x00, 0x00},  // W
+  {0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11, 0x00, 0x00},  // X
+  {0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04, 0x00, 0x00},  // Y
+  {0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F, 0x00, 0x00},  // Z
+  {0x0E, 0x08, 0x08, 0x08, 0x08, 0x08, 0x0E, 0x00, 0x00},  // [
+  {0x00, 0x10, 0x08, 0x04, 0x02, 0x01, 0x00, 0x00, 0x00},  // backslash
+  {0x0E, 0x02, 0x02, 0x02, 0x02, 0x02, 0x0E, 0x00, 0x00},  // ]
+  {0x04, 0x0A, 0x11, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},  // ^
+  {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F},  // _
+  {0x08, 0x04, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},  // `
+  {0x00, 0x00, 0x0E, 0x01, 0x0F, 0x11, 0x0F, 0x00, 0x00},  // a
+  {0x10, 0x10, 0x16, 0x19, 0x11, 0x11, 0x1E, 0x00, 0x00},  // b
+  {0x00, 0x00, 0x0E, 0x10, 0x10, 0x11, 0x0E, 0x00, 0x00},  // c
+  {0x01, 0x01, 0x0D, 0x13, 0x11, 0x11, 0x0F, 0x00, 0x00},  // d
+  {0x00, 0x00, 0x0E, 0x11, 0x1F, 0x10, 0x0E, 0x00, 0x00},  // e
+  {0x06, 0x09, 0x08, 0x1C, 0x08, 0x08, 0x08, 0x00, 0x00},  // f
+  {0x00, 0x00, 0x0F, 0x11, 0x11, 0x11, 0x0F, 0x01, 0x0E},  // g
+  {0x10, 0x10, 0x16, 0x19, 0x11, 0x11, 0x11, 0x00, 0x00},  // h
+  {0x04, 0x00, 0x0C, 0x04, 0x04, 0x04, 0x0E, 0x00, 0x00},  // i
+  {0x02, 0x00, 0x06, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C},  // j
+  {0x10, 0x10, 0x12, 0x14, 0x18, 0x14, 0x12, 0x00, 0x00},  // k
+  {0x0C, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E, 0x00, 0x00},  // l
+  {0x00, 0x00, 0x1A, 0x15, 0x15, 0x11, 0x11, 0x00, 0x00},  // m
+  {0x00, 0x00, 0x16, 0x19, 0x11, 0x11, 0x11, 0x00, 0x00},  // n
+  {0x00, 0x00, 0x0E, 0x11, 0x11, 0x11, 0x0E, 0x00, 0x00},  // o
+  {0x00, 0x00, 0x1E, 0x11, 0x11, 0x11, 0x1E, 0x10, 0x10},  // p
+  {0x00, 0x00, 0x0F, 0x11, 0x11, 0x11, 0x0F, 0x01, 0x01},  // q
+  {0x00, 0x00, 0x16, 0x19, 0x10, 0x10, 0x10, 0x00, 0x00},  // r
+  {0x00, 0x00, 0x0E, 0x10, 0x0E, 0x01, 0x1E, 0x00, 0x00},  // s
+  {0x08, 0x08, 0x1C, 0x08, 0x08, 0x09, 0x06, 0x00, 0x00},  // t
+  {0x00, 0x00, 0x11, 0x11, 0x11, 0x13, 0x0D, 0x00, 0x00},  // u
+  {0x00, 0x00, 0x11, 0x11, 0x11, 0x0A, 0x04, 0x00, 0x00},  // v
+  {0x00, 0x00, 0x11, 0x11, 0x15, 0x15, 0x0A, 0x00, 0x00},  // w
+  {0x00, 0x00, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x00, 0x00},  // x
+  {0x00, 0x00, 0x11, 0x11, 0x11, 0x11, 0x0F, 0x01, 0x0E},  // y
+  {0x00, 0x00, 0x1F, 0x02, 0x04, 0x08, 0x1F, 0x00, 0x00},  // z
+  {0x02, 0x04, 0x04, 0x08, 0x04, 0x04, 0x02, 0x00, 0x00},  // {
+  {0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x00, 0x00},  // |
+  {0x08, 0x04, 0x04, 0x02, 0x04, 0x04, 0x08, 0x00, 0x00},  // }
+  {0x00, 0x00, 0x08, 0x15, 0x02, 0x00, 0x00, 0x00, 0x00},  // ~
+};
+
+wchar win_linedraw_chars[31] = {
+  0x25C6, 0x2592, 0x2409, 0x240C, 0x240D, 0x240A, 0x00B0, 0x00B1,
+  0x2424, 0x240B, 0x2518, 0x2510, 0x250C, 0x2514, 0x253C, 0x23BA,
+  0x23BB, 0x2500, 0x23BC, 0x23BF, 0x251C, 0x2524, 0x2534, 0x252C,
+  0x2502, 0x2264, 0x2265, 0x03C0, 0x2260, 0x00A3, 0x00B7
+};
+
+/*
+ * Box drawing characters are drawn as lines. For the ones supported here,
+ * the bits say which of the left, right, up and down arms are present.
+ */
+enum { BOX_L = 1, BOX_R = 2, BOX_U = 4, BOX_D = 8 };
+
+static uchar
+box_arms(xchar c)
+{
+  switch (c) {
+    when 0x2500: return BOX_L | BOX_R;
+    when 0x2502: return BOX_U | BOX_D;
+    when 0x250C: return BOX_R | BOX_D;
+    when 0x2510: return BOX_L | BOX_D;
+    when 0x2514: return BOX_R | BOX_U;
+    when 0x2518: return BOX_L | BOX_U;
+    when 0x251C: return BOX_U | BOX_D | BOX_R;
+    when 0x2524: return BOX_U | BOX_D | BOX_L;
+    when 0x252C: return BOX_L | BOX_R | BOX_D;
+    when 0x2534: return BOX_L | BOX_R | BOX_U;
+    when 0x253C: return BOX_L | BOX_R | BOX_U | BOX_D;
+    otherwise: return 0;
+  }
+}
+
+static bool
+has_glyph(xchar c)
+{
+  return (c >= 0x20 && c < 0x7F) || box_arms(c) || c == 0x2592;
+}
+
+/*
+ * The built-in font goes through the same glyph cache as the Windows
+ * fonts, with a measurer that answers from the font table.
+ */
+static void
+measure_widths(void *unused(ctx), xchar unused(first), uint num,
+               uchar *widths)
+{ memset(widths, 1, num); }
+
+static void
+measure_coverage(void *unused(ctx), const wchar *wcs, uint num, bool *has)
+{
+  for (uint i = 0; i < num; i++)
+    has[i] = has_glyph(wcs[i]);
+}
+
+static glyph_cache *
+get_glyph_cache(void)
+{
+  static glyph_cache *gc;
+  if (!gc) {
+    glyph_measurer measurer = {
+      .widths = measure_widths, .coverage = measure_coverage
+    };
+    gc = glyph_cache_new(measurer, "headless", CELL_HEIGHT);
+  }
+  return gc;
+}
+
+int win_char_width(xchar c) { return glyph_cache_width(get_glyph_cache(), c); }
+
+void
+win_check_glyphs(wchar *wcs, uint num)
+{
+  glyph_cache_check(get_glyph_cache(), wcs, num);
+}
+
+
+/*
+ * Rendering.
+ */
+
+static void
+fill_rect(int x0, int y0, int x1, int y1, colour c)
+{
+  x0 = max(x0, 0);
+  y0 = max(y0, 0);
+  x1 = min(x1, pixels_width);
+  y1 = min(y1, pixels_height);
+  uint p = c | 0xFF000000;
+  for (int y = y0; y < y1; y++)
+    for (int x = x0; x < x1; x++)
+      pixels[y * pixels_width + x] = p;
+}
+
+/*
+ * Draw a character into a cell box, scaled by sx and sy, with the glyph
+ * shifted up by yoff pixels (for the bottom half of double-height lines).
+ */
+static void
+draw_glyph(xchar c, int bx, int by, int bw, int sx, int sy, int yoff,
+           colour fg, bool bold)
+{
+  int y0 = by, y1 = by + CELL_HEIGHT;
+  void pixel(int x, int y, int w, int h) {
+    y = by + y - yoff;
+    fill_rect(bx + x, max(y, y0), bx + x + w, min(y + h, y1), fg);
+  }
+
+  if (c >= 0x20 && c < 0x7F) {
+    const uchar *glyph = font_glyphs[c - 0x20];
+    for (int r = 0; r < GLYPH_HEIGHT; r++) {
+      for (int col = 0; col < 5; col++) {
+        if (glyph[r] & (0x10 >> col)) {
+          int w = sx + bold;
+          pixel(col * sx, (GLYPH_TOP + r) * sy, w, sy);
+        }
+      }
+    }
+  }
+  else if (box_arms(c)) {
+    uchar arms = box_arms(c);
+    int cx = bw / 2, cy = CELL_HEIGHT * sy / 2, h = CELL_HEIGHT * sy;
+    int t = sx + bold;
+    if (arms & BOX_L)
+      pixel(0, cy, cx + t, sy);
+    if (arms & BOX_R)
+      pixel(cx, cy, bw - cx, sy);
+    if (arms & BOX_U)
+      pixel(cx, 0, t, cy + sy);
+    if (arms & BOX_D)
+      pixel(cx, cy, t, h - cy);
+  }
+  else if (c == 0x2592) {
+    for (int y = 0; y < CELL_HEIGHT * sy; y++)
+      for (int x = y & 1; x < bw; x += 2)
+        pixel(x, y, 1, 1);
+  }
+  else if (c != ' ') {
+   /* Missing glyph: draw an empty box. */
+    int h = (GLYPH_TOP + 7) * sy;
+    pixel(sx, GLYPH_TOP * sy, bw - 2 * sx, sy);
+    pixel(sx, h - sy, bw - 2 * sx, sy);
+    pixel(sx, GLYPH_TOP * sy, sx, h - GLYPH_TOP * sy);
+    pixel(bw - 2 * sx, GLYPH_TOP * sy, sx, h - GLYPH_TOP * sy);
+  }
+}
+
+static void
+draw_text(int x, int y, wchar *text, int len, uint attr, int lattr)
+{
+  int sx = 1 + (lattr != LATTR_NORM), sy = 1 + (lattr >= LATTR_TOP);
+  int yoff = lattr == LATTR_BOT ? CELL_HEIGHT : 0;
+  int cw = CELL_WIDTH * sx * (attr & ATTR_WIDE ? 2 : 1);
+  int px = x * CELL_WIDTH * sx, py = y * CELL_HEIGHT;
+
+ /* Only want the left half of double width lines */
+  if (lattr != LATTR_NORM && x * 2 >= term->cols)
+    return;
+
+  text_colours tc =
+    term_text_colours(attr, colours, term->rvideo, CURSOR_COLOUR_I,
+                      term_cursor_type());
+  colour fg = tc.fg, bg = tc.bg, cursor_colour = tc.cursor;
+  bool has_cursor = attr & (TATTR_ACTCURS | TATTR_PASCURS);
+
+ /* Combined characters occupy a single cell, showing the base character. */
+  int cells = len;
+  if (attr & TATTR_COMBINING) {
+    cells = 1;
+    if (len > 1 && is_high_surrogate(text[0]) && is_low_surrogate(text[1]))
+      text[0] = 0xFFFD;
+  }
+
+  int right = min(px + cw * cells, pixels_width);
+  fill_rect(px, py, right, py + CELL_HEIGHT, bg);
+  for (int i = 0; i < cells; i++)
+    draw_glyph(text[i], px + i * cw, py, cw, sx, sy, yoff, fg,
+               attr & ATTR_BOLD);
+
+  if (lattr != LATTR_TOP && (attr & ATTR_UNDER)) {
+    int uy = py + (GLYPH_TOP + GLYPH_HEIGHT - 1) * sy - yoff;
+    if (uy >= py && uy < py + CELL_HEIGHT)
+      fill_rect(px, uy, right, uy + 1, fg);
+  }
+
+  if (has_cursor) {
+    switch (term_cursor_type()) {
+      when CUR_BLOCK:
+        if (attr & TATTR_PASCURS) {
+          fill_rect(px, py, px + cw, py + 1, cursor_colour);
+          fill_rect(px, py + CELL_HEIGHT - 1, px + cw, py + CELL_HEIGHT,
+                    cursor_colour);
+          fill_rect(px, py, px + 1, py + CELL_HEIGHT, cursor_colour);
+          fill_rect(px + cw - 1, py, px + cw, py + CELL_HEIGHT,
+                    cursor_colour);
+        }
+      when CUR_LINE: {
+        int cx = attr & TATTR_RIGHTCURS ? px + cw - 1 : px;
+        fill_rect(cx, py, cx + 1, py + CELL_HEIGHT, cursor_colour);
+      }
+      when CUR_UNDERSCORE:
+        fill_rect(px, py + CELL_HEIGHT - 2, px + cw, py + CELL_HEIGHT,
+                  cursor_colour);
+    }
+  }
+}
+
+void
+win_draw(draw_list *dl)
+{
+  for (uint i = 0; i < dl->num_runs; i++) {
+    draw_run *r = &dl->runs[i];
+    draw_text(r->x, r->y, dl->text + r->text, r->len, r->attr, r->lattr);
+  }
+}
+
+void
+win_scroll_rect(int top, int bottom, int lines)
+{
+  int src = max(top, top + lines), dst = max(top, top - lines);
+  int n = bottom - top - abs(lines);
+  memmove(pixels + dst * CELL_HEIGHT * pixels_width,
+          pixels + src * CELL_HEIGHT * pixels_width,
+          n * CELL_HEIGHT * pixels_width * sizeof *pixels);
+}
+
+
+/*
+ * Driver.
+ */
+
+static void
+update(void)
+{
+  if (update_pending) {
+    update_pending = false;
+    if (full_update)
+      term_paint();
+    else
+      term_paint_overlays();
+    full_update = false;
+    frames++;
+  }
+}
+
+static bool
+write_ppm(string filename)
+{
+  FILE *file = fopen(filename, "wb");
+  if (!file)
+    return false;
+  fprintf(file, "P6\n%d %d\n255\n", pixels_width, pixels_height);
+  for (int i = 0; i < pixels_width * pixels_height; i++) {
+    colour c = pixels[i];
+    fputc(red(c), file);
+    fputc(green(c), file);
+    fputc(blue(c), file);
+  }
+  return !fclose(file);
+}
+
+static char *
+read_file(FILE *file, char *data, uint *len)
+{
+  uint size = *len;
+  for (;;) {
+    if (*len == size) {
+      size = size * 2 + 65536;
+      data = renewn(data, size);
+    }
+    uint n = fread(data + *len, 1, size - *len, file);
+    if (!n)
+      return data;
+    *len += n;
+  }
+}
+
+static double
+now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static no_return
+usage(int status)
+{
+  fprintf(status ? stderr : stdout,
+    "Usage: mintty-headless [OPTION]... [FILE]...\n"
+    "Feed FILEs (or standard input) through the terminal and its renderer.\n"
+    "\n"
+    "  -s, --size=COLSxROWS  Set screen size (default 80x24)\n"
+    "  -c, --chunk=BYTES     Bytes written between updates (default 4096)\n"
+    "  -r, --repeat=COUNT    Feed the input COUNT times (default 1)\n"
+    "  -i, --idle=MS         Keep running for MS milliseconds after the input\n"
+    "  -b, --cursor-blinks   Make the cursor blink\n"
+    "  -f, --flash           Flash the screen on bell\n"
+    "  -S, --select=X,Y,X,Y  Select from the first cell up to the second one\n"
+    "                        once the input has been processed\n"
+    "  -B, --block=X,Y,X,Y   Same, but selecting a rectangle\n"
+    "  -o, --output=FILE     Dump final screen to FILE in PPM format\n"
+    "  -q, --quiet           Don't print statistics\n"
+    "  -h, --help            Display this help and exit\n"
+  );
+  exit(status);
+}
+
+int
+main(int argc, char *argv[])
+{
+  static const struct option opts[] = {
+    {"size",   required_argument, 0, 's'},
+    {"chunk",  required_argument, 0, 'c'},
+    {"repeat", required_argument, 0, 'r'},
+    {"idle",   required_argument, 0, 'i'},
+    {"cursor-blinks", no_argument, 0, 'b'},
+    {"flash",  no_argument,       0, 'f'},
+    {"select", required_argument, 0, 'S'},
+    {"block",  required_argument, 0, 'B'},
+    {"output", required_argument, 0, 'o'},
+    {"quiet",  no_argument,       0, 'q'},
+    {"help",   no_argument,       0, 'h'},
+    {0, 0, 0, 0}
+  };
+
+  uint chunk = 4096, repeat = 1, idle = 0;
+  string output = 0;
+  bool quiet = false;
+  bool select = false, select_rect = false;
+  pos sel_start, sel_end;
+
+  for (int opt;
+       (opt = getopt_long(argc, argv, "s:c:r:i:bfS:B:o:qh", opts, 0)) != -1;) {
+    switch (opt) {
+      when 's':
+        if (sscanf(optarg, "%dx%d%c", &cfg.cols, &cfg.rows, &(char){0}) != 2 ||
+            cfg.cols <= 0 || cfg.rows <= 0)
+          usage(2);
+      when 'c': chunk = max(1, atoi(optarg));
+      when 'r': repeat = max(1, atoi(optarg));
+      when 'i': idle = max(0, atoi(optarg));
+      when 'b': cfg.cursor_blinks = true;
+      when 'f': cfg.bell_flash = true;
+      when 'S' or 'B':
+        if (sscanf(optarg, "%d,%d,%d,%d%c", &sel_start.x, &sel_start.y,
+                   &sel_end.x, &sel_end.y, &(char){0}) != 4)
+          usage(2);
+        select = true;
+        select_rect = opt == 'B';
+      when 'o': output = optarg;
+      when 'q': quiet = true;
+      when 'h': usage(0);
+      otherwise: usage(2);
+    }
+  }
+
+  char *data = 0;
+  uint len = 0;
+  if (optind == argc)
+    data = read_file(stdin, data, &len);
+  for (int i = optind; i < argc; i++) {
+    FILE *file = fopen(argv[i], "rb");
+    if (!file) {
+      fprintf(stderr, "mintty-headless: %s: %s\n", argv[i], strerror(errno));
+      return 1;
+    }
+    data = read_file(file, data, &len);
+    fclose(file);
+  }
+
+  cs_cur_max = 4;
+  term = term_new();
+  win_reset_colours();
+  term_reset();
+  term_resize(cfg.rows, cfg.cols);
+  resize_pixels(cfg.rows, cfg.cols);
+  term_set_focus(true);
+  win_invalidate_all();
+  update();
+
+  double start = now();
+  for (uint r = 0; r < repeat; r++) {
+    for (uint pos = 0; pos < len; pos += chunk) {
+      term_write(data + pos, min(chunk, len - pos));
+      ticks += 16;
+      run_timers();
+      update();
+    }
+  }
+  if (select) {
+    term->selected = true;
+    term->sel_rect = select_rect;
+    term->sel_start = term->sel_anchor = sel_start;
+    term->sel_end = sel_end;
+    win_update_overlays();
+  }
+  update();
+  for (uint t = 0; t < idle; t += 16) {
+    ticks += 16;
+    run_timers();
+    update();
+  }
+  double elapsed = now() - start;
+
+  if (!quiet) {
+    double total = (double)len * repeat;
+    fprintf(stderr,
+      "%.0f bytes, %u frames, %.3f s, %.1f MB/s, %.1f us/frame, "
+      "%u bytes to child, %u bells\n",
+      total, frames, elapsed, total / elapsed / 1e6,
+      frames ? elapsed / frames * 1e6 : 0, child_bytes, bells);
+  }
+
+  if (output && !write_ppm(output)) {
+    fprintf(stderr, "mintty-headless: %s: %s\n", output, strerror(errno));
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,218 @@
+// latency.c (part of mintty)
+// Licensed under the terms of the GNU General Public License v3 or later.
+
+#include "latency.h"
+
+#include "term.h"
+
+#include <time.h>
+
+bool latency_tracing;
+
+// Keystrokes whose echo doesn't turn up within a couple of seconds are
+// dropped.
+enum { TIMEOUT_US = 2000000 };
+
+/*
+ * Histograms of the time from one stage to the next, indexed by the later
+ * stage, with index 0 used for the total. Buckets are 100us wide, and the
+ * last one collects everything from 100ms up.
+ */
+enum { BUCKET_US = 100, NUM_BUCKETS = 1001 };
+
+typedef uint histogram[NUM_BUCKETS];
+static histogram *hists;
+static uint count;
+
+static const char *stage_names[LAT_STAGES] = {
+  "total", "send", "read", "parse", "paint", "draw"
+};
+
+static long long
+now_us(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+}
+
+static void
+add_sample(uint i, long long us)
+{
+  hists[i][min(max(us, 0) / BUCKET_US, NUM_BUCKETS - 1)]++;
+}
+
+static void
+remove_pending(latency_pending *lp, uint i)
+{
+  lp->num--;
+  memmove(lp->keys + i, lp->keys + i + 1, (lp->num - i) * sizeof *lp->keys);
+}
+
+static void
+complete(latency_pending *lp, uint i, long long now)
+{
+  latency_keystroke *k = &lp->keys[i];
+  k->t[LAT_DRAW] = now;
+  for (uint s = LAT_SEND; s < LAT_STAGES; s++)
+    add_sample(s, k->t[s] - k->t[s - 1]);
+  add_sample(0, now - k->t[LAT_KEY]);
+  count++;
+  remove_pending(lp, i);
+}
+
+/* Does the draw list include the given screen cell? */
+static bool
+drawn(int x, int y)
+{
+  y -= term->disptop;
+  for (uint i = 0; i < term->draw.num_runs; i++) {
+    draw_run *run = &term->draw.runs[i];
+    if (run->y == y && run->x <= x && x < run->x + run->len)
+      return true;
+  }
+  return false;
+}
+
+void
+latency_record(latency_stage stage)
+{
+  long long now = now_us();
+  latency_pending *lp = &term->latency;
+
+  for (uint i = 0; i < lp->num;) {
+    if (now - lp->keys[i].t[LAT_KEY] > TIMEOUT_US)
+      remove_pending(lp, i);
+    else
+      i++;
+  }
+
+  switch (stage) {
+    when LAT_KEY:
+      lp->key_time = now;
+    when LAT_SEND: {
+      // Only input caused by a keypress is of interest.
+      if (!lp->key_time)
+        return;
+      if (lp->num == LAT_MAX_PENDING)
+        remove_pending(lp, 0);
+      latency_keystroke *k = &lp->keys[lp->num++];
+      *k = (latency_keystroke){.x = term->curs.x, .y = term->curs.y};
+      k->t[LAT_KEY] = lp->key_time;
+      k->t[LAT_SEND] = now;
+      lp->key_time = 0;
+    }
+    when LAT_READ:
+      // Keep the last read before the echo is found.
+      for (uint i = 0; i < lp->num; i++) {
+        if (!lp->keys[i].t[LAT_PARSE])
+          lp->keys[i].t[LAT_READ] = now;
+      }
+    when LAT_PARSE:
+      // Assume that the echo has arrived once the cursor has moved.
+      for (uint i = 0; i < lp->num; i++) {
+        latency_keystroke *k = &lp->keys[i];
+        if (k->t[LAT_READ] && !k->t[LAT_PARSE] &&
+            (term->curs.x != k->x || term->curs.y != k->y))
+          k->t[LAT_PARSE] = now;
+      }
+    when LAT_PAINT:
+      for (uint i = 0; i < lp->num; i++) {
+        if (lp->keys[i].t[LAT_PARSE] && !lp->keys[i].t[LAT_PAINT])
+          lp->keys[i].t[LAT_PAINT] = now;
+      }
+    when LAT_DRAW:
+      // The echo is done once its cell or the cursor's cell has been drawn.
+      // Otherwise wait for the next paint.
+      for (uint i = 0; i < lp->num;) {
+        latency_keystroke *k = &lp->keys[i];
+        if (!k->t[LAT_PAINT])
+          i++;
+        else if (drawn(k->x, k->y) || drawn(term->curs.x, term->curs.y))
+          complete(lp, i, now);
+        else
+          k->t[LAT_PAINT] = 0, i++;
+      }
+    otherwise:
+      break;
+  }
+}
+
+static void
+dump_at_exit(void)
+{
+  latency_dump(cfg.latency_log);
+}
+
+void
+latency_enable(bool enable)
+{
+  if (enable) {
+    if (!hists) {
+      hists = newn(histogram, LAT_STAGES);
+      if (*cfg.latency_log)
+        atexit(dump_at_exit);
+    }
+    memset(hists, 0, LAT_STAGES * sizeof *hists);
+    count = 0;
+    // Other terminals' keystrokes from before are dropped by the timeout.
+    if (term)
+      term->latency = (latency_pending){.num = 0};
+  }
+  latency_tracing = enable;
+}
+
+static uint
+percentile(uint *hist, uint percent)
+{
+  uint target = (count * percent + 99) / 100, sum = 0;
+  for (uint i = 0; i < NUM_BUCKETS; i++) {
+    if ((sum += hist[i]) >= target && sum)
+      return (i + 1) * BUCKET_US;
+  }
+  return 0;
+}
+
+char *
+latency_report(void)
+{
+  char *report = newn(char, 32 + LAT_STAGES * 40), *p = report;
+  p += sprintf(p, "n=%u", count);
+  for (uint s = 0; s < LAT_STAGES && hists; s++) {
+    uint *h = hists[s];
+    p += sprintf(p, ";%s=%u/%u/%u", stage_names[s],
+                 percentile(h, 50), percentile(h, 95), percentile(h, 99));
+  }
+  return report;
+}
+
+bool
+latency_dump(string filename)
+{
+  if (!*filename || !hists)
+    return false;
+  FILE *file = fopen(filename, "w");
+  if (!file)
+    return false;
+
+  char *report = latency_report();
+  fprintf(file, "# %s\n", report);
+  free(report);
+
+  fputs("us", file);
+  for (uint s = 0; s < LAT_STAGES; s++)
+    fprintf(file, ",%s", stage_names[s]);
+  fputc('\n', file);
+  for (uint i = 0; i < NUM_BUCKETS; i++) {
+    bool any = false;
+    for (uint s = 0; s < LAT_STAGES; s++)
+      any |= hists[s][i] != 0;
+    if (any) {
+      fprintf(file, "%u", i * BUCKET_US);
+      for (uint s = 0; s < LAT_STAGES; s++)
+        fprintf(file, ",%u", hists[s][i]);
+      fputc('\n', file);
+    }
+  }
+  return !fclose(file);
+}
@@ -0,0 +1,60 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+/*
+ * Keystroke latency tracer.
+ *
+ * When enabled, each keypress is followed through the stages below.
+ * Echoes are matched to keypresses by the cursor cell the key was sent
+ * from, and the time taken by each stage is collected in histograms,
+ * which are shared by all terminals in the process.
+ */
+
+typedef enum {
+  LAT_KEY,    // key pressed
+  LAT_SEND,   // input sent to the child
+  LAT_READ,   // output read from the child
+  LAT_PARSE,  // echo processed by the terminal
+  LAT_PAINT,  // terminal repainted
+  LAT_DRAW,   // echoed cell drawn
+  LAT_STAGES
+} latency_stage;
+
+/*
+ * Keystrokes whose echo hasn't been drawn yet. They're kept for each
+ * terminal, as echoes are matched by the terminal's cursor position.
+ */
+enum { LAT_MAX_PENDING = 16 };
+
+typedef struct {
+  long long t[LAT_STAGES];  // microseconds, or 0 if not reached yet
+  int x, y;                 // cursor position when the key was sent
+} latency_keystroke;
+
+typedef struct {
+  latency_keystroke keys[LAT_MAX_PENDING];
+  uint num;
+  long long key_time;  // time of a keypress not sent yet
+} latency_pending;
+
+extern bool latency_tracing;
+
+void latency_record(latency_stage);
+
+static inline void
+trace_latency(latency_stage stage)
+{
+  if (latency_tracing)
+    latency_record(stage);
+}
+
+// Enabling starts afresh; disabling keeps the results.
+void latency_enable(bool);
+
+// Percentiles in microseconds, as "n=COUNT;STAGE=P50/P95/P99;...".
+char *latency_report(void);
+
+// Write the report and the histograms to a file.
+bool latency_dump(string filename);
+
+#endif
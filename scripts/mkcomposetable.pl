@@ -0,0 +1,55 @@
+#! /usr/bin/perl
+# Generate the canonical composition table used by termout.c
+# from the Unicode database that comes with perl.
+# Usage: scripts/mkcomposetable.pl > compose.t
+#
+# The output is an open-addressed hash table of primary composites,
+# indexed by the hash function compose_hash() in termout.c, which
+# must be kept in sync with the one below. Hangul syllables are
+# composed algorithmically and therefore not included.
+
+use strict;
+use warnings;
+use Unicode::UCD qw(prop_invmap);
+use Unicode::Normalize qw(NFC);
+
+my $size = 2048;
+
+sub hash {
+  my ($c, $cc) = @_;
+  return ((($c * 31 + $cc) * 2654435761) & 0xFFFFFFFF) >> 21 & ($size - 1);
+}
+
+no warnings 'utf8';
+my ($list, $map, $format) = prop_invmap('Decomposition_Mapping');
+die "unexpected format $format" unless $format eq 'ad';
+my @pairs;
+for my $i (0 .. $#$list - 1) {
+  my $m = $map->[$i];
+  next unless ref $m eq 'ARRAY' && @$m == 2;
+  for my $c ($list->[$i] .. $list->[$i + 1] - 1) {
+    next if $c >= 0xAC00 && $c <= 0xD7A3;
+    next unless NFC(chr($m->[0]) . chr($m->[1])) eq chr($c);
+    push @pairs, [@$m, $c];
+  }
+}
+die "table too small" if @pairs * 2 > $size;
+
+my @table;
+for (@pairs) {
+  my $h = hash($_->[0], $_->[1]);
+  $h = ($h + 1) & ($size - 1) while $table[$h];
+  $table[$h] = $_;
+}
+
+printf "// Generated by scripts/mkcomposetable.pl from Unicode %s data.\n",
+       Unicode::UCD::UnicodeVersion();
+print "// Canonical composition pairs, hashed by compose_hash().\n";
+for (@table) {
+  if ($_) {
+    printf "  {0x%04X, 0x%04X, 0x%04X},\n", @$_;
+  }
+  else {
+    print "  {0, 0, 0},\n";
+  }
+}
@@ -0,0 +1,48 @@
+#! /usr/bin/perl
+# Generate the grapheme cluster break property table used by termout.c
+# from the Unicode database that comes with perl.
+# Usage: scripts/mkgcbtable.pl > graphemes.t
+
+use strict;
+use warnings;
+
+my @props = (
+  [CR => qr/\p{GCB=CR}/],
+  [LF => qr/\p{GCB=LF}/],
+  [Control => qr/\p{GCB=Control}/],
+  [Extend => qr/\p{GCB=Extend}/],
+  [ZWJ => qr/\p{GCB=ZWJ}/],
+  [RI => qr/\p{GCB=Regional_Indicator}/],
+  [Prepend => qr/\p{GCB=Prepend}/],
+  [SpacingMark => qr/\p{GCB=SpacingMark}/],
+  [L => qr/\p{GCB=L}/],
+  [V => qr/\p{GCB=V}/],
+  [T => qr/\p{GCB=T}/],
+  [LV => qr/\p{GCB=LV}/],
+  [LVT => qr/\p{GCB=LVT}/],
+  [ExtPict => qr/\p{Extended_Pictographic}/],
+);
+
+sub prop {
+  my $c = chr(shift);
+  for (@props) {
+    return $_->[0] if $c =~ $_->[1];
+  }
+  return '';
+}
+
+require Unicode::UCD;
+printf "// Generated by scripts/mkgcbtable.pl from Unicode %s data.\n",
+       Unicode::UCD::UnicodeVersion();
+print "// Grapheme cluster break properties of non-ASCII characters,\n";
+print "// as ranges sorted by code point. Unlisted characters are GCB_Other.\n";
+
+no warnings 'utf8';
+my ($first, $prop) = (0x80, '');
+for my $i (0x80 .. 0x110000) {
+  my $p = $i < 0x110000 ? prop($i) : '';
+  if ($p ne $prop) {
+    printf "  {0x%04X, 0x%04X, GCB_%s},\n", $first, $i - 1, $prop if $prop;
+    ($first, $prop) = ($i, $p);
+  }
+}
@@ -10,7 +10,7 @@ strset(string *sp, string s)
 }
 
 
-#if CYGWIN_VERSION_API_MINOR < 70
+#if !defined HEADLESS && CYGWIN_VERSION_API_MINOR < 70
 
 int
 vasprintf(char **buf, const char *fmt, va_list va)
@@ -53,14 +53,14 @@ asform(const char *fmt, ...)
 }
 
 
-#if CYGWIN_VERSION_API_MINOR < 74
+#if !defined HEADLESS && CYGWIN_VERSION_API_MINOR < 74
 int iswalnum(wint_t wc) { return wc < 0x100 && isalnum(wc); }
 int iswalpha(wint_t wc) { return wc < 0x100 && isalpha(wc); }
 int iswspace(wint_t wc) { return wc < 0x100 && isspace(wc); }
 #endif
 
 
-#if CYGWIN_VERSION_API_MINOR < 91
+#if !defined HEADLESS && CYGWIN_VERSION_API_MINOR < 91
 
 /* Copyright (C) 2002 by  Red Hat, Incorporated. All rights reserved.
  *
@@ -119,7 +119,7 @@ argz_stringify(char *argz, size_t argz_len, int sep)
 }
 #endif
 
-#if CYGWIN_VERSION_API_MINOR < 93
+#if !defined HEADLESS && CYGWIN_VERSION_API_MINOR < 93
 
 /*-
  * Copyright (c) 1990, 1993
@@ -1,7 +1,11 @@
 #ifndef STD_H
 #define STD_H
 
+// HEADLESS builds the terminal core with the offscreen renderer in
+// headless.c instead of the Windows front end, for use on other platforms.
+#ifndef HEADLESS
 #include <cygwin/version.h>
+#endif
 
 #include <assert.h>
 #include <limits.h>
@@ -15,14 +19,14 @@
 #include <wchar.h>
 #include <errno.h>
 
-#if CYGWIN_VERSION_API_MINOR >= 91
+#if defined HEADLESS || CYGWIN_VERSION_API_MINOR >= 91
 #include <argz.h>
 #else
 int argz_create (char *const argv[], char **argz, size_t *argz_len);
 void argz_stringify (char *argz, size_t argz_len, int sep);
 #endif
 
-#if CYGWIN_VERSION_API_MINOR >= 74
+#if defined HEADLESS || CYGWIN_VERSION_API_MINOR >= 74
 #include <wctype.h>
 #else
 int iswalnum(wint_t);
@@ -30,22 +34,27 @@ int iswalpha(wint_t);
 int iswspace(wint_t);
 #endif
 
-#if CYGWIN_VERSION_API_MINOR < 53
+#if !defined HEADLESS && CYGWIN_VERSION_API_MINOR < 53
 #define strlcpy(dst, src, len) snprintf(dst, len, "%s", src)
 #endif
 
-#if CYGWIN_VERSION_API_MINOR < 70
+#if !defined HEADLESS && CYGWIN_VERSION_API_MINOR < 70
 int asprintf(char **, const char *, ...);
 int vasprintf(char **, const char *, va_list);
 #endif
 
 char *asform(const char *fmt, ...);
 
+#ifdef HEADLESS
+#define min(a, b) ((a) < (b) ? (a) : (b))
+#define max(a, b) ((a) > (b) ? (a) : (b))
+#else
 #define WINVER 0x500  // Windows 2000
 #define _WIN32_WINNT WINVER
 #define _WIN32_IE WINVER
 
 #include <windef.h>
+#endif
 
 #ifdef DMALLOC
 #include <dmalloc.h>
@@ -63,7 +72,11 @@ typedef unsigned int uint;
 typedef void (*void_fn)(void);
 
 typedef uint xchar;     // UTF-32
+#ifdef HEADLESS
+typedef ushort wchar;   // UTF-16
+#else
 typedef wchar_t wchar;  // UTF-16
+#endif
 
 typedef const char *string;
 typedef const wchar *wstring;
@@ -8,11 +8,14 @@
 #include "win.h"
 #include "charset.h"
 #include "child.h"
+#include "latency.h"
+#include "counters.h"
+#include "trace.h"
 
-struct term term;
+term_t *term;
 
 const termchar
-basic_erase_char = { .cc_next = 0, .chr = ' ', .attr = ATTR_DEFAULT };
+basic_erase_char = { .chr = ' ', .cc = 0, .attr = ATTR_DEFAULT };
 
 /*
  * Call when the terminal's blinking-text settings change, or when
@@ -21,18 +24,23 @@ basic_erase_char = { .cc_next = 0, .chr = ' ', .attr = ATTR_DEFAULT };
 static void
 tblink_cb(void)
 {
-  term.tblinker = !term.tblinker;
+  term->tblinker = !term->tblinker;
   term_schedule_tblink();
-  win_update();
+  for (int i = 0; i < term->rows; i++) {
+    if (term->displines[i]->blinks) {
+      win_update_overlays();
+      break;
+    }
+  }
 }
 
 void
 term_schedule_tblink(void)
 {
-  if (term.blink_is_real)
+  if (term->blink_is_real)
     win_set_timer(tblink_cb, 500);
   else
-    term.tblinker = 1;  /* reset when not in use */
+    term->tblinker = 1;  /* reset when not in use */
 }
 
 /*
@@ -41,25 +49,25 @@ term_schedule_tblink(void)
 static void
 cblink_cb(void)
 {
-  term.cblinker = !term.cblinker;
+  term->cblinker = !term->cblinker;
   term_schedule_cblink();
-  win_update();
+  win_update_overlays();
 }
 
 void
 term_schedule_cblink(void)
 {
-  if (term_cursor_blinks() && term.has_focus)
+  if (term_cursor_blinks() && term->has_focus)
     win_set_timer(cblink_cb, cursor_blink_ticks());
   else
-    term.cblinker = 1;  /* reset when not in use */
+    term->cblinker = 1;  /* reset when not in use */
 }
 
 static void
 vbell_cb(void)
 {
-  term.in_vbell = false;
-  win_update();
+  term->in_vbell = false;
+  win_update_overlays();
 }
 
 void
@@ -67,7 +75,7 @@ term_schedule_vbell(int already_started, int startpoint)
 {
   int ticks_gone = already_started ? get_tick_count() - startpoint : 0;
   int ticks = 100 - ticks_gone;
-  if ((term.in_vbell = ticks > 0))
+  if ((term->in_vbell = ticks > 0))
     win_set_timer(vbell_cb, ticks);
 }
 
@@ -78,11 +86,11 @@ term_schedule_vbell(int already_started, int startpoint)
 int
 term_last_nonempty_line(void)
 {
-  for (int i = term.rows - 1; i >= 0; i--) {
-    termline *line = term.lines[i];
+  for (int i = term->rows - 1; i >= 0; i--) {
+    termline *line = term->lines[i];
     if (line) {
       for (int j = 0; j < line->cols; j++)
-        if (!termchars_equal(&line->chars[j], &term.erase_char))
+        if (!termchars_equal(&line->chars[j], &term->erase_char))
           return i;
     }
   }
@@ -97,74 +105,79 @@ term_cursor_reset(term_cursor *curs)
   curs->autowrap = true;
 }
 
+/*
+ * Reset the current terminal. The colour palette is shared by all panes,
+ * so it is left to the callers that reset the whole window.
+ */
 void
 term_reset(void)
 {
-  term.state = NORMAL;
+  term->state = NORMAL;
 
-  term_cursor_reset(&term.curs);
-  term_cursor_reset(&term.saved_cursors[0]);
-  term_cursor_reset(&term.saved_cursors[1]);
+  term_cursor_reset(&term->curs);
+  term_cursor_reset(&term->saved_cursors[0]);
+  term_cursor_reset(&term->saved_cursors[1]);
   
-  term.backspace_sends_bs = cfg.backspace_sends_bs;
-  if (term.tabs) {
-    for (int i = 0; i < term.cols; i++)
-      term.tabs[i] = (i % 8 == 0);
-  }
-  term.rvideo = 0;
-  term.in_vbell = false;
-  term.cursor_on = true;
-  term.echoing = false;
-  term.insert = false;
-  term.shortcut_override = term.escape_sends_fs = term.app_escape_key = false;
-  term.vt220_keys = strstr(cfg.term, "vt220");
-  term.app_keypad = term.app_cursor_keys = term.app_wheel = false;
-  term.mouse_mode = MM_NONE;
-  term.mouse_enc = ME_X10;
-  term.wheel_reporting = true;
-  term.modify_other_keys = 0;
-  term.report_focus = term.report_ambig_width = 0;
-  term.bracketed_paste = false;
-  term.show_scrollbar = true;
-
-  term.marg_top = 0;
-  term.marg_bot = term.rows - 1;
-
-  term.cursor_type = -1;
-  term.cursor_blinks = -1;
-  term.blink_is_real = cfg.allow_blinking;
-  term.erase_char = basic_erase_char;
-  term.on_alt_screen = false;
+  term->backspace_sends_bs = cfg.backspace_sends_bs;
+  if (term->tabs) {
+    for (int i = 0; i < term->cols; i++)
+      term->tabs[i] = (i % 8 == 0);
+  }
+  term->rvideo = 0;
+  term->in_vbell = false;
+  term->cursor_on = true;
+  term->echoing = false;
+  term->insert = false;
+  term->shortcut_override = term->escape_sends_fs = term->app_escape_key = false;
+  term->vt220_keys = strstr(cfg.term, "vt220");
+  term->app_keypad = term->app_cursor_keys = term->app_wheel = false;
+  term->mouse_mode = MM_NONE;
+  term->motion.pending = false;
+  term->mouse_enc = ME_X10;
+  term->wheel_reporting = true;
+  term->modify_other_keys = 0;
+  term->report_focus = term->report_ambig_width = 0;
+  term->bracketed_paste = false;
+  term->show_scrollbar = true;
+  term->sync_output = false;
+
+  term->marg_top = 0;
+  term->marg_bot = term->rows - 1;
+
+  term->cursor_type = -1;
+  term->cursor_blinks = -1;
+  term->blink_is_real = cfg.allow_blinking;
+  term->erase_char = basic_erase_char;
+  term->on_alt_screen = false;
   term_print_finish();
-  if (term.lines) {
+  if (term->lines) {
     term_switch_screen(1, false);
     term_erase(false, false, true, true);
     term_switch_screen(0, false);
     term_erase(false, false, true, true);
-    term.curs.y = term_last_nonempty_line() + 1;
-    if (term.curs.y == term.rows) {
-      term.curs.y--;
-      term_do_scroll(0, term.rows - 1, 1, true);
+    term->curs.y = term_last_nonempty_line() + 1;
+    if (term->curs.y == term->rows) {
+      term->curs.y--;
+      term_do_scroll(0, term->rows - 1, 1, true);
     }
   }
-  term.selected = false;
+  term->selected = false;
   term_schedule_tblink();
   term_schedule_cblink();
   term_clear_scrollback();
-  
-  win_reset_colours();
+  cc_collect(true);
 }
 
 static void
 show_screen(bool other_screen)
 {
-  term.show_other_screen = other_screen;
-  term.disptop = 0;
-  term.selected = false;
+  term->show_other_screen = other_screen;
+  term->disptop = 0;
+  term->selected = false;
 
   // Reset cursor blinking.
   if (!other_screen) {
-    term.cblinker = 1;
+    term->cblinker = 1;
     term_schedule_cblink();
   }
 
@@ -182,7 +195,7 @@ term_reset_screen(void)
 void
 term_flip_screen(void)
 {
-  show_screen(!term.show_other_screen);
+  show_screen(!term->show_other_screen);
 }
 
 /* Apply changed settings */
@@ -191,55 +204,123 @@ term_reconfig(void)
 {
   if (!*cfg.printer)
     term_print_finish();
-  term.blink_is_real = cfg.allow_blinking;
+  term->blink_is_real = cfg.allow_blinking;
   term_schedule_tblink();
   term_schedule_cblink();
-  term.backspace_sends_bs = cfg.backspace_sends_bs;
-  term.vt220_keys = strstr(cfg.term, "vt220");
+  term->backspace_sends_bs = cfg.backspace_sends_bs;
+  term->vt220_keys = strstr(cfg.term, "vt220");
+}
+
+/*
+ * Compressed scrollback lines never change, so they can be shared with
+ * background tasks such as copying. While any such task is running,
+ * lines dropped from the scrollback are kept around until it finishes.
+ */
+void
+term_retain_scrollback(void)
+{
+  term->sb_retained++;
+  term->sb_retain_num = max(term->sb_retain_num, term->sblines);
+  term->sb_fresh = 0;
 }
 
+void
+term_release_scrollback(void)
+{
+  assert(term->sb_retained > 0);
+  if (!--term->sb_retained) {
+    for (int i = 0; i < term->sb_retired_num; i++)
+      free(term->sb_retired[i]);
+    free(term->sb_retired);
+    term->sb_retired = 0;
+    term->sb_retired_num = term->sb_retired_size = 0;
+    term->sb_retain_num = term->sb_fresh = 0;
+  }
+}
+
+/*
+ * Dispose of a line taken off the oldest or the newest end of the
+ * scrollback. Only lines that were there when the scrollback was last
+ * retained might be in use, which keeps the number of retired lines
+ * bounded by the scrollback size.
+ */
 static void
-scrollback_push(uchar *line)
+free_sbline(uchar *line, bool oldest)
 {
-  if (term.sblines == term.sblen) {
+  bool in_use = 
+    term->sb_retained && (oldest ? term->sb_retain_num > 0 : !term->sb_fresh);
+  if (!in_use) {
+    if (!oldest && term->sb_fresh)
+      term->sb_fresh--;
+    free(line);
+    return;
+  }
+  if (term->sb_retain_num)
+    term->sb_retain_num--;
+  if (term->sb_retired_num == term->sb_retired_size) {
+    term->sb_retired_size = term->sb_retired_size * 2 + 256;
+    term->sb_retired = renewn(term->sb_retired, term->sb_retired_size);
+  }
+  term->sb_retired[term->sb_retired_num++] = line;
+}
+
+static void
+scrollback_push(termline *tline)
+{
+  int size;
+  uchar *line = compressline(tline, &size);
+  if (term->sblines == term->sblen) {
     // Need to make space for the new line.
-    if (term.sblen < cfg.scrollback_lines) {
+    if (term->sblen < cfg.scrollback_lines) {
       // Expand buffer
-      assert(term.sbpos == 0);
-      int new_sblen = min(cfg.scrollback_lines, term.sblen * 3 + 1024);
-      term.scrollback = renewn(term.scrollback, new_sblen);
-      term.sbpos = term.sblen;
-      term.sblen = new_sblen;
+      assert(term->sbpos == 0);
+      int new_sblen = min(cfg.scrollback_lines, term->sblen * 3 + 1024);
+      term->scrollback = renewn(term->scrollback, new_sblen);
+      term->sbsizes = renewn(term->sbsizes, new_sblen);
+      term->sbpos = term->sblen;
+      term->sblen = new_sblen;
     }
-    else if (term.sblines) {
+    else if (term->sblines) {
       // Throw away the oldest line
-      free(term.scrollback[term.sbpos]);
-      term.sblines--;
+      free_sbline(term->scrollback[term->sbpos], true);
+      term->sbbytes -= term->sbsizes[term->sbpos];
+      term->sblines--;
+      term->sb_fresh = min(term->sb_fresh, term->sblines);
     }
-    else
+    else {
+      free(line);
       return;
+    }
   }
-  assert(term.sblines < term.sblen);
-  assert(term.sbpos < term.sblen);
-  term.scrollback[term.sbpos++] = line;
-  if (term.sbpos == term.sblen)
-    term.sbpos = 0;
-  term.sblines++;
-  if (term.tempsblines < term.sblines)
-    term.tempsblines++;
+  assert(term->sblines < term->sblen);
+  assert(term->sbpos < term->sblen);
+  term->sbbytes += size;
+  term->sbsizes[term->sbpos] = size;
+  term->scrollback[term->sbpos++] = line;
+  if (term->sbpos == term->sblen)
+    term->sbpos = 0;
+  term->sblines++;
+  if (term->tempsblines < term->sblines)
+    term->tempsblines++;
+  if (term->sb_retained)
+    term->sb_fresh++;
+  if (term->frozen.on)
+    term->frozen.pushed++;
 }
 
 static uchar *
 scrollback_pop(void)
 {
-  assert(term.sblines > 0);
-  assert(term.sbpos < term.sblen);
-  term.sblines--;
-  if (term.tempsblines)
-    term.tempsblines--;
-  if (term.sbpos == 0)
-    term.sbpos = term.sblen;
-  return term.scrollback[--term.sbpos];
+  assert(term->sblines > 0);
+  assert(term->sbpos < term->sblen);
+  term->sblines--;
+  if (term->tempsblines)
+    term->tempsblines--;
+  if (term->sbpos == 0)
+    term->sbpos = term->sblen;
+  term->sbpos--;
+  term->sbbytes -= term->sbsizes[term->sbpos];
+  return term->scrollback[term->sbpos];
 }
 
 /*
@@ -248,13 +329,142 @@ scrollback_pop(void)
 void
 term_clear_scrollback(void)
 {
-  while (term.sblines)
-    free(scrollback_pop());
-  free(term.scrollback);
-  term.scrollback = 0;
-  term.sblen = term.sblines = term.sbpos = 0;
-  term.tempsblines = 0;
-  term.disptop = 0;
+  while (term->sblines)
+    free_sbline(scrollback_pop(), false);
+  free(term->scrollback);
+  free(term->sbsizes);
+  term->scrollback = 0;
+  term->sbsizes = 0;
+  term->sbbytes = 0;
+  term->sblen = term->sblines = term->sbpos = 0;
+  term->tempsblines = 0;
+  term->disptop = 0;
+}
+
+/*
+ * During drag-selects, the view holds still so that the text doesn't move
+ * under the mouse, while output processing carries on behind it. When
+ * output arrives, the view is frozen: the screen lines are copied, and
+ * the scrollback lines are shared with the scrollback, which is retained.
+ */
+void
+term_freeze(void)
+{
+  if (term->frozen.on)
+    return;
+
+  int n = sblines();
+  uchar **sb = newn(uchar *, max(n, 1));
+  for (int i = 0; i < n; i++)
+    sb[i] = fetch_compressed_line(i - n);
+  term_retain_scrollback();
+
+  termlines *lines = term->show_other_screen ? term->other_lines : term->lines;
+  termlines *copies = newn(termline *, term->rows);
+  for (int i = 0; i < term->rows; i++) {
+    uchar *cline = compressline(lines[i], null);
+    copies[i] = decompressline(cline, null);
+    copies[i]->temporary = false;
+    free(cline);
+  }
+
+  term->frozen.on = true;
+  term->frozen.deselected = false;
+  term->frozen.sblines = n;
+  term->frozen.sb = sb;
+  term->frozen.lines = copies;
+  term->frozen.curs = term->curs;
+  term->frozen.cursor_on = term->cursor_on && !term->show_other_screen;
+  term->frozen.pushed = 0;
+}
+
+/*
+ * Let the view catch up with the output processed while it was frozen.
+ * The selection and scroll position are moved up by the number of lines
+ * that have gone into the scrollback in the meantime.
+ */
+void
+term_thaw(void)
+{
+  if (!term->frozen.on)
+    return;
+
+  for (int i = 0; i < term->rows; i++)
+    freeline(term->frozen.lines[i]);
+  free(term->frozen.lines);
+  free(term->frozen.sb);
+  term->frozen.on = false;
+  term_release_scrollback();
+
+  int pushed = term->frozen.pushed, sbtop = -sblines();
+  void move_pos(pos *p) {
+    if ((p->y -= pushed) < sbtop)
+      *p = (pos){.y = sbtop, .x = 0};
+  }
+  if (term->frozen.deselected)
+    term->selected = false;
+  else if (pushed) {
+    move_pos(&term->sel_start);
+    move_pos(&term->sel_end);
+    move_pos(&term->sel_anchor);
+    if (!poslt(term->sel_start, term->sel_end))
+      term->selected = false;
+  }
+  if (term->disptop < 0)
+    term->disptop = min(max(term->disptop - pushed, sbtop), 0);
+  win_update();
+}
+
+/*
+ * Create a terminal. It needs to be made current, reset and given a size
+ * before use.
+ */
+term_t *
+term_new(void)
+{
+  term_t *t = new(term_t);
+  memset(t, 0, sizeof *t);
+  return t;
+}
+
+void
+term_free(term_t *t)
+{
+  term_t *cur = term;
+  term = t;
+
+  term_cancel_copy();
+  term_thaw();
+  term_clear_scrollback();
+  for (int i = 0; i < term->rows; i++) {
+    freeline(term->lines[i]);
+    freeline(term->other_lines[i]);
+    freeline(term->displines[i]);
+  }
+  free(term->lines);
+  free(term->other_lines);
+  free(term->displines);
+  free(term->tabs);
+  free(term->draw.runs);
+  free(term->draw.text);
+  free(term->printbuf);
+  free(term->paste_buffer);
+  delete(term->charset_locale);
+  cc_pool_free(&term->ccs);
+  free(term->ltemp);
+  free(term->wcFrom);
+  free(term->wcTo);
+  for (int i = 0; i < term->bidi_cache_size; i++) {
+    free(term->pre_bidi_cache[i].chars);
+    free(term->post_bidi_cache[i].chars);
+    free(term->post_bidi_cache[i].forward);
+    free(term->post_bidi_cache[i].backward);
+  }
+  free(term->pre_bidi_cache);
+  free(term->post_bidi_cache);
+  free(term);
+
+  term = cur == t ? 0 : cur;
 }
 
 /*
@@ -263,13 +473,16 @@ term_clear_scrollback(void)
 void
 term_resize(int newrows, int newcols)
 {
-  bool on_alt_screen = term.on_alt_screen;
+  long long start = trace_begin();
+  term_thaw();
+
+  bool on_alt_screen = term->on_alt_screen;
   term_switch_screen(0, false);
 
-  term.selected = false;
+  term->selected = false;
 
-  term.marg_top = 0;
-  term.marg_bot = newrows - 1;
+  term->marg_top = 0;
+  term->marg_bot = newrows - 1;
 
  /*
   * Resize the screen and scrollback. We only need to shift
@@ -291,20 +504,20 @@ term_resize(int newrows, int newcols)
   *    away.
   */
 
-  termlines *lines = term.lines;
-  term_cursor *curs = &term.curs;
-  term_cursor *saved_curs = &term.saved_cursors[term.on_alt_screen];
+  termlines *lines = term->lines;
+  term_cursor *curs = &term->curs;
+  term_cursor *saved_curs = &term->saved_cursors[term->on_alt_screen];
 
   // Shrink the screen if newrows < rows
-  if (newrows < term.rows) {
-    int removed = term.rows - newrows;
-    int destroy = min(removed, term.rows - (curs->y + 1));
+  if (newrows < term->rows) {
+    int removed = term->rows - newrows;
+    int destroy = min(removed, term->rows - (curs->y + 1));
     int store = removed - destroy;
     
     // Push removed lines into scrollback
     for (int i = 0; i < store; i++) {
       termline *line = lines[i];
-      scrollback_push(compressline(line));
+      scrollback_push(line);
       freeline(line);
     }
 
@@ -312,7 +525,7 @@ term_resize(int newrows, int newcols)
     memmove(lines, lines + store, newrows * sizeof(termline *));
     
     // Destroy removed lines below the cursor
-    for (int i = term.rows - destroy; i < term.rows; i++)
+    for (int i = term->rows - destroy; i < term->rows; i++)
       freeline(lines[i]);
     
     // Adjust cursor position
@@ -320,12 +533,12 @@ term_resize(int newrows, int newcols)
     saved_curs->y = max(0, saved_curs->y - store);
   }
 
-  term.lines = lines = renewn(lines, newrows);
+  term->lines = lines = renewn(lines, newrows);
   
   // Expand the screen if newrows > rows
-  if (newrows > term.rows) {
-    int added = newrows - term.rows;
-    int restore = min(added, term.tempsblines);
+  if (newrows > term->rows) {
+    int added = newrows - term->rows;
+    int restore = min(added, term->tempsblines);
     int create = added - restore;
     
     // Fill bottom of screen with blank lines
@@ -333,13 +546,13 @@ term_resize(int newrows, int newcols)
       lines[i] = newline(newcols, false);
     
     // Move existing lines down
-    memmove(lines + restore, lines, term.rows * sizeof(termline *));
+    memmove(lines + restore, lines, term->rows * sizeof(termline *));
     
     // Restore lines from scrollback
     for (int i = restore; i--;) {
       uchar *cline = scrollback_pop();
       termline *line = decompressline(cline, null);
-      free(cline);
+      free_sbline(cline, false);
       line->temporary = false;  /* reconstituted line is now real */
       lines[i] = line;
     }
@@ -354,32 +567,32 @@ term_resize(int newrows, int newcols)
     resizeline(lines[i], newcols);
   
   // Make a new displayed text buffer.
-  if (term.displines) {
-    for (int i = 0; i < term.rows; i++)
-      freeline(term.displines[i]);
+  if (term->displines) {
+    for (int i = 0; i < term->rows; i++)
+      freeline(term->displines[i]);
   }
-  term.displines = renewn(term.displines, newrows);
+  term->displines = renewn(term->displines, newrows);
   for (int i = 0; i < newrows; i++) {
     termline *line = newline(newcols, false);
-    term.displines[i] = line;
+    term->displines[i] = line;
     for (int j = 0; j < newcols; j++)
       line->chars[j].attr = ATTR_INVALID;
   }
 
   // Make a new alternate screen.
-  lines = term.other_lines;
+  lines = term->other_lines;
   if (lines) {
-    for (int i = 0; i < term.rows; i++)
+    for (int i = 0; i < term->rows; i++)
       freeline(lines[i]);
   }
-  term.other_lines = lines = renewn(lines, newrows);
+  term->other_lines = lines = renewn(lines, newrows);
   for (int i = 0; i < newrows; i++)
     lines[i] = newline(newcols, true);
 
   // Reset tab stops
-  term.tabs = renewn(term.tabs, newcols);
-  for (int i = (term.cols > 0 ? term.cols : 0); i < newcols; i++)
-    term.tabs[i] = (i % 8 == 0);
+  term->tabs = renewn(term->tabs, newcols);
+  for (int i = (term->cols > 0 ? term->cols : 0); i < newcols; i++)
+    term->tabs[i] = (i % 8 == 0);
 
   // Check that the cursor positions are still valid.
   assert(0 <= curs->y && curs->y < newrows);
@@ -388,12 +601,13 @@ term_resize(int newrows, int newcols)
 
   curs->wrapnext = false;
 
-  term.disptop = 0;
+  term->disptop = 0;
 
-  term.rows = newrows;
-  term.cols = newcols;
+  term->rows = newrows;
+  term->cols = newcols;
 
   term_switch_screen(on_alt_screen, false);
+  trace_end("term_resize", start, newrows * newcols);
 }
 
 /*
@@ -405,14 +619,14 @@ term_resize(int newrows, int newcols)
 void
 term_switch_screen(bool to_alt, bool reset)
 {
-  if (to_alt == term.on_alt_screen)
+  if (to_alt == term->on_alt_screen)
     return;
 
-  term.on_alt_screen = to_alt;
+  term->on_alt_screen = to_alt;
 
-  termlines *oldlines = term.lines;
-  term.lines = term.other_lines;
-  term.other_lines = oldlines;
+  termlines *oldlines = term->lines;
+  term->lines = term->other_lines;
+  term->other_lines = oldlines;
   
   if (to_alt && reset)
     term_erase(false, false, true, true);
@@ -441,16 +655,15 @@ void
 term_check_boundary(int x, int y)
 {
  /* Validate input coordinates, just in case. */
-  if (x == 0 || x > term.cols)
+  if (x == 0 || x > term->cols)
     return;
 
-  termline *line = term.lines[y];
-  if (x == term.cols)
+  termline *line = term->lines[y];
+  if (x == term->cols)
     line->attr &= ~LATTR_WRAPPED2;
   else if (line->chars[x].chr == UCSWIDE) {
-    clear_cc(line, x - 1);
-    clear_cc(line, x);
     line->chars[x - 1].chr = ' ';
+    line->chars[x - 1].cc = 0;
     line->chars[x] = line->chars[x - 1];
   }
 }
@@ -473,14 +686,15 @@ term_do_scroll(int topline, int botline, int lines, bool sb)
   // Don't try to scroll more than the number of lines in the scroll region.
   int lines_in_region = botline - topline;
   lines = min(lines, lines_in_region);
+  count(CNT_SCROLLED, lines);
   
   // Number of lines that are moved up or down as they are.
   // The rest are scrolled out of the region and replaced by empty lines.
   int moved_lines = lines_in_region - lines;
   
   // Useful pointers to the top and (one below the) bottom lines.
-  termline **top = term.lines + topline;
-  termline **bot = term.lines + botline;
+  termline **top = term->lines + topline;
+  termline **bot = term->lines + botline;
   
   // Reuse lines that are being scrolled out of the scroll region,
   // clearing their content.
@@ -499,29 +713,31 @@ term_do_scroll(int topline, int botline, int lines, bool sb)
 
     // Move selection markers if they're within the scroll region
     void scroll_pos(pos *p) {
-      if (!term.show_other_screen && p->y >= topline && p->y < botline) {
+      if (!term->show_other_screen && p->y >= topline && p->y < botline) {
         if ((p->y += lines) >= botline)
           *p = (pos){.y = botline, .x = 0};
       }
     }
-    scroll_pos(&term.sel_start);
-    scroll_pos(&term.sel_anchor);
-    scroll_pos(&term.sel_end);
+    scroll_pos(&term->sel_start);
+    scroll_pos(&term->sel_anchor);
+    scroll_pos(&term->sel_end);
   }
   else {
     int seltop = topline;
 
     // Only push lines into the scrollback when scrolling off the top of the
     // normal screen and scrollback is actually enabled.
-    if (sb && topline == 0 && !term.on_alt_screen && cfg.scrollback_lines) {
+    if (sb && topline == 0 && !term->on_alt_screen && cfg.scrollback_lines) {
+      long long start = trace_begin();
       for (int i = 0; i < lines; i++)
-        scrollback_push(compressline(term.lines[i]));
+        scrollback_push(term->lines[i]);
+      trace_end("scrollback_push", start, lines);
  
       // Shift viewpoint accordingly if user is looking at scrollback
-      if (term.disptop < 0)
-        term.disptop = max(term.disptop - lines, -term.sblines);
+      if (term->disptop < 0)
+        term->disptop = max(term->disptop - lines, -term->sblines);
 
-      seltop = -term.sblines;
+      seltop = -term->sblines;
     }
     
     // Move up remaining lines and push in the recycled lines
@@ -531,14 +747,14 @@ term_do_scroll(int topline, int botline, int lines, bool sb)
 
     // Move selection markers if they're within the scroll region
     void scroll_pos(pos *p) {
-      if (!term.show_other_screen && p->y >= seltop && p->y < botline) {
+      if (!term->show_other_screen && p->y >= seltop && p->y < botline) {
         if ((p->y -= lines) < seltop)
           *p = (pos){.y = seltop, .x = 0};
       }
     }
-    scroll_pos(&term.sel_start);
-    scroll_pos(&term.sel_anchor);
-    scroll_pos(&term.sel_end);
+    scroll_pos(&term->sel_start);
+    scroll_pos(&term->sel_anchor);
+    scroll_pos(&term->sel_end);
   }
 }
 
@@ -550,7 +766,7 @@ term_do_scroll(int topline, int botline, int lines, bool sb)
 void
 term_erase(bool selective, bool line_only, bool from_begin, bool to_end)
 {
-  term_cursor *curs = &term.curs;
+  term_cursor *curs = &term->curs;
   pos start, end;
 
   if (from_begin)
@@ -559,7 +775,7 @@ term_erase(bool selective, bool line_only, bool from_begin, bool to_end)
     start = (pos){.y = curs->y, .x = curs->x};
 
   if (to_end)
-    end = (pos){.y = line_only ? curs->y + 1 : term.rows, .x = 0};
+    end = (pos){.y = line_only ? curs->y + 1 : term->rows, .x = 0};
   else
     end = (pos){.y = curs->y, .x = curs->x}, incpos(end);
   
@@ -575,7 +791,7 @@ term_erase(bool selective, bool line_only, bool from_begin, bool to_end)
     * we're fully erasing them, erase by scrolling and keep the
     * lines in the scrollback. */
     int scrolllines = end.y;
-    if (end.y == term.rows) {
+    if (end.y == term->rows) {
      /* Shrink until we find a non-empty row. */
       scrolllines = term_last_nonempty_line() + 1;
     }
@@ -585,57 +801,254 @@ term_erase(bool selective, bool line_only, bool from_begin, bool to_end)
    /* After an erase of lines from the top of the screen, we shouldn't
     * bring the lines back again if the terminal enlarges (since the user or
     * application has explictly thrown them away). */
-    if (!term.on_alt_screen)
-      term.tempsblines = 0;
+    if (!term->on_alt_screen)
+      term->tempsblines = 0;
   }
   else {
-    termline *line = term.lines[start.y];
+    termline *line = term->lines[start.y];
     while (poslt(start, end)) {
-      if (start.x == term.cols) {
+      if (start.x == term->cols) {
         if (line_only)
           line->attr &= ~(LATTR_WRAPPED | LATTR_WRAPPED2);
         else
           line->attr = LATTR_NORM;
       }
       else if (!selective || !(line->chars[start.x].attr & ATTR_PROTECTED))
-        line->chars[start.x] = term.erase_char;
-      if (incpos(start) && start.y < term.rows)
-        line = term.lines[start.y];
+        line->chars[start.x] = term->erase_char;
+      if (incpos(start) && start.y < term->rows)
+        line = term->lines[start.y];
     }
   }
 }
 
-void
-term_paint(void)
+static void
+draw_text(int x, int y, wchar *text, int len, uint attr, int lattr)
+{
+  draw_list *dl = &term->draw;
+  if (dl->num_runs == dl->runs_size) {
+    dl->runs_size = dl->runs_size * 2 + 64;
+    dl->runs = renewn(dl->runs, dl->runs_size);
+  }
+  if (dl->text_len + len > dl->text_size) {
+    dl->text_size = (dl->text_len + len) * 2;
+    dl->text = renewn(dl->text, dl->text_size);
+  }
+  dl->runs[dl->num_runs++] = (draw_run){
+    .x = x, .y = y, .lattr = lattr & LATTR_MODE, .len = len,
+    .attr = attr, .text = dl->text_len
+  };
+  memcpy(dl->text + dl->text_len, text, len * sizeof(wchar));
+  dl->text_len += len;
+}
+
+static uint
+line_hash(termline *line)
 {
+  uint h = 2166136261u ^ line->attr;
+  for (int j = 0; j < term->cols; j++) {
+    termchar *c = &line->chars[j];
+    h = (h ^ c->chr) * 16777619u;
+    h = (h ^ c->cc) * 16777619u;
+    h = (h ^ c->attr) * 16777619u;
+  }
+  return h;
+}
+
+/*
+ * Find out whether the display has moved up (positive result) or down
+ * (negative result) since the last update, by comparing line hashes.
+ * Only accept a shift if it brings more lines into place than leaving
+ * the display as it is. The range of lines in the new display that
+ * came from the old one is returned in *top and *bottom.
+ */
+static int
+find_scroll(uint *hashes, int *top, int *bottom)
+{
+  int rows = term->rows;
+  int best_n = 0, best_matches = 0;
+  for (int n = 1 - rows; n < rows; n++) {
+    int matches = 0;
+    for (int i = max(0, -n); i < min(rows, rows - n); i++)
+      matches += hashes[i] == term->displines[i + n]->hash;
+    if (matches > best_matches || (matches == best_matches && !n)) {
+      best_n = n;
+      best_matches = matches;
+    }
+  }
+  if (!best_n)
+    return 0;
+
+  int i = max(0, -best_n), end = min(rows, rows - best_n);
+  while (hashes[i] != term->displines[i + best_n]->hash)
+    i++;
+  while (hashes[end - 1] != term->displines[end - 1 + best_n]->hash)
+    end--;
+  *top = i;
+  *bottom = end;
+  return best_n;
+}
+
+/*
+ * Move display lines [top, bottom) to where they will be after scrolling
+ * by n lines, and tell the front end to do the same with the pixels.
+ * Lines scrolling into the region are invalidated.
+ */
+static void
+scroll_display(int top, int bottom, int n)
+{
+  int lines = abs(n);
+  if (n > 0)
+    bottom += n;
+  else
+    top += n;
+
+  termline *exposed[lines];
+  termline **region = term->displines + top;
+  int moved = bottom - top - lines;
+  if (n > 0) {
+    memcpy(exposed, region, sizeof exposed);
+    memmove(region, region + lines, moved * sizeof(termline *));
+    memcpy(region + moved, exposed, sizeof exposed);
+  }
+  else {
+    memcpy(exposed, region + moved, sizeof exposed);
+    memmove(region + lines, region, moved * sizeof(termline *));
+    memcpy(region, exposed, sizeof exposed);
+  }
+  for (int i = 0; i < lines; i++) {
+    exposed[i]->hash = 0;
+    for (int j = 0; j < term->cols; j++)
+      exposed[i]->chars[j].attr |= ATTR_INVALID;
+  }
+
+  win_scroll_rect(top, bottom, n);
+}
+
+/*
+ * Work out the highlights overlaid on display line y. Spans are XORed, so
+ * the visual bell, which reverses whole lines, shows the selection as
+ * unreversed text.
+ */
+static int
+get_overlays(int y, overlay_span *spans)
+{
+  int n = 0;
+  if (term->in_vbell)
+    spans[n++] = (overlay_span){.start = 0, .end = term->cols,
+                                .attr = ATTR_REVERSE};
+
+  pos start = term->sel_start, end = term->sel_end;
+  y += term->disptop;
+  if (term->selected && start.y <= y && y <= end.y) {
+    int x0 = term->sel_rect || y == start.y ? start.x : 0;
+    int x1 = term->sel_rect || y == end.y ? min(end.x, term->cols) : term->cols;
+    if (x0 < x1)
+      spans[n++] = (overlay_span){.start = x0, .end = x1,
+                                  .attr = ATTR_REVERSE};
+  }
+  return n;
+}
+
+/*
+ * Bring the display up to date. If overlays_only is set, only the cursor,
+ * blinking text and overlays such as the selection are assumed to have
+ * changed since the last paint, so only the lines they affect are looked at.
+ */
+static void
+paint(bool overlays_only)
+{
+  cc_collect(false);
+
+  bool frozen = term->frozen.on;
+  term_cursor *curs = frozen ? &term->frozen.curs : &term->curs;
+  bool cursor_on =
+    frozen ? term->frozen.cursor_on : term->cursor_on && !term->show_other_screen;
+
  /* The display line that the cursor is on, or -1 if the cursor is invisible. */
-  int curs_y =
-    term.cursor_on && !term.show_other_screen
-    ? term.curs.y - term.disptop : -1;
+  int curs_y = cursor_on ? curs->y - term->disptop : -1;
 
-  for (int i = 0; i < term.rows; i++) {
-    pos scrpos;
-    scrpos.y = i + term.disptop;
+  // While an application is drawing a frame in synchronized output mode,
+  // keep showing the previous one.
+  if (term->sync_output)
+    return;
+
+  trace_latency(LAT_PAINT);
+  count(CNT_PAINT, 1);
+  long long start = count_start();
+  long long trace_start = trace_begin();
+
+  term->draw.num_runs = term->draw.text_len = 0;
+
+  overlay_span overlays[term->rows][MAX_OVERLAYS];
+  int overlay_nums[term->rows];
+  termline *lines[term->rows];
+  uint hashes[term->rows];
+  for (int i = 0; i < term->rows; i++) {
+    termline *displine = term->displines[i];
+    int n = overlay_nums[i] = get_overlays(i, overlays[i]);
+    bool overlays_changed =
+      n != displine->overlay_num ||
+      memcmp(overlays[i], displine->overlays, n * sizeof(overlay_span));
+    if (!overlays_only || overlays_changed ||
+        i == curs_y || i == term->painted_curs_y || displine->blinks) {
+      lines[i] = fetch_line(i + term->disptop);
+      hashes[i] = line_hash(lines[i]);
+    }
+    else
+      lines[i] = 0;
+  }
+
+ /*
+  * If the display has scrolled, e.g. because of output at the bottom of
+  * the screen, get the front end to move what's already there, so that
+  * only the newly exposed lines need drawing.
+  */
+  if (!overlays_only) {
+    int scroll_top, scroll_bottom;
+    int scroll = find_scroll(hashes, &scroll_top, &scroll_bottom);
+    if (scroll)
+      scroll_display(scroll_top, scroll_bottom, scroll);
+  }
+
+  long long rows_start = trace_begin();
+  for (int i = 0; i < term->rows; i++) {
+    if (!lines[i])
+      continue;
 
    /* Do Arabic shaping and bidi. */
-    termline *line = fetch_line(scrpos.y);
+    termline *line = lines[i];
     termchar *chars = term_bidi_line(line, i);
-    int *backward = chars ? term.post_bidi_cache[i].backward : 0;
-    int *forward = chars ? term.post_bidi_cache[i].forward : 0;
+    int *backward = chars ? term->post_bidi_cache[i].backward : 0;
+    int *forward = chars ? term->post_bidi_cache[i].forward : 0;
     chars = chars ?: line->chars;
 
-    termline *displine = term.displines[i];
+    termline *displine = term->displines[i];
     termchar *dispchars = displine->chars;
-    termchar newchars[term.cols];
+    termchar newchars[term->cols];
+    bool blinks = false;
+
+   /* Turn the overlay spans into attribute masks for each column. */
+    int overlay_num = overlay_nums[i];
+    uint overlay_attrs[overlay_num ? term->cols : 1];
+    if (overlay_num) {
+      memset(overlay_attrs, 0, term->cols * sizeof(uint));
+      for (int k = 0; k < overlay_num; k++) {
+        overlay_span *span = &overlays[i][k];
+        for (int x = span->start; x < span->end; x++)
+          overlay_attrs[x] ^= span->attr;
+      }
+    }
+    displine->overlay_num = overlay_num;
+    memcpy(displine->overlays, overlays[i],
+           overlay_num * sizeof(overlay_span));
 
   /*
     * First loop: work along the line deciding what we want
     * each character cell to look like.
     */
-    for (int j = 0; j < term.cols; j++) {
+    for (int j = 0; j < term->cols; j++) {
       termchar *d = chars + j;
-      scrpos.x = backward ? backward[j] : j;
-      wchar tchar = d->chr;
+      xchar tchar = d->chr;
       uint tattr = d->attr;
       
      /* Many Windows fonts don't have the Unicode hyphen, but groff
@@ -644,22 +1057,17 @@ term_paint(void)
       if (tchar == 0x2010)
         tchar = '-';
 
-      if (j < term.cols - 1 && d[1].chr == UCSWIDE)
+      if (j < term->cols - 1 && d[1].chr == UCSWIDE)
         tattr |= ATTR_WIDE;
 
-     /* Video reversing things */
-      bool selected = 
-        term.selected &&
-        ( term.sel_rect
-          ? posPle(term.sel_start, scrpos) && posPlt(scrpos, term.sel_end)
-          : posle(term.sel_start, scrpos) && poslt(scrpos, term.sel_end)
-        );
-      if (term.in_vbell || selected)
-        tattr ^= ATTR_REVERSE;
+     /* Selection and other highlights */
+      if (overlay_num)
+        tattr ^= overlay_attrs[backward ? backward[j] : j];
 
      /* 'Real' blinking ? */
-      if (term.blink_is_real && (tattr & ATTR_BLINK)) {
-        if (term.has_focus && term.tblinker)
+      if (term->blink_is_real && (tattr & ATTR_BLINK)) {
+        blinks = true;
+        if (term->has_focus && term->tblinker)
           tchar = ' ';
         tattr &= ~ATTR_BLINK;
       }
@@ -679,8 +1087,7 @@ term_paint(void)
      /* FULL-TERMCHAR */
       newchars[j].attr = tattr;
       newchars[j].chr = tchar;
-     /* Combining characters are still read from chars */
-      newchars[j].cc_next = 0;
+      newchars[j].cc = d->cc;
     }
 
     if (i == curs_y) {
@@ -688,7 +1095,7 @@ term_paint(void)
       * moving it one column to the left when it's on the right half of a
       * wide character.
       */
-      int curs_x = term.curs.x;
+      int curs_x = curs->x;
       if (forward)
         curs_x = forward[curs_x];
       if (curs_x > 0 && chars[curs_x].chr == UCSWIDE)
@@ -696,11 +1103,11 @@ term_paint(void)
 
      /* Determine cursor cell attributes. */
       newchars[curs_x].attr |=
-        (!term.has_focus ? TATTR_PASCURS :
-         term.cblinker || !term_cursor_blinks() ? TATTR_ACTCURS : 0) |
-        (term.curs.wrapnext ? TATTR_RIGHTCURS : 0);
+        (!term->has_focus ? TATTR_PASCURS :
+         term->cblinker || !term_cursor_blinks() ? TATTR_ACTCURS : 0) |
+        (curs->wrapnext ? TATTR_RIGHTCURS : 0);
       
-      if (term.cursor_invalid)
+      if (term->cursor_invalid)
         dispchars[curs_x].attr |= ATTR_INVALID;
     }
 
@@ -720,7 +1127,7 @@ term_paint(void)
     */
     int laststart = 0;
     bool dirtyrect = false;
-    for (int j = 0; j < term.cols; j++) {
+    for (int j = 0; j < term->cols; j++) {
       if (dispchars[j].attr & DATTR_STARTRUN) {
         laststart = j;
         dirtyrect = false;
@@ -742,7 +1149,7 @@ term_paint(void)
    /*
     * Finally, loop once more and actually do the drawing.
     */
-    wchar text[max(term.cols, 16)];
+    wchar text[max(term->cols, 16)];
     int textlen = 0;
     bool dirty_run = (line->attr != displine->attr);
     bool dirty_line = dirty_run;
@@ -751,10 +1158,10 @@ term_paint(void)
 
     displine->attr = line->attr;
 
-    for (int j = 0; j < term.cols; j++) {
+    for (int j = 0; j < term->cols; j++) {
       termchar *d = chars + j;
       uint tattr = newchars[j].attr;
-      wchar tchar = newchars[j].chr;
+      xchar tchar = newchars[j].chr;
 
       if ((dispchars[j].attr ^ tattr) & ATTR_WIDE)
         dirty_line = true;
@@ -762,9 +1169,12 @@ term_paint(void)
       bool break_run = tattr ^ attr;
 
      /*
-      * Break on both sides of any combined-character cell.
+      * Break on both sides of any combined-character cell. Characters
+      * outside the BMP take two UTF-16 code units, so they are treated
+      * the same way.
       */
-      if (d->cc_next || (j > 0 && d[-1].cc_next))
+      if (d->cc || tchar >= 0x10000 ||
+          (j > 0 && (d[-1].cc || newchars[j - 1].chr >= 0x10000)))
         break_run = true;
 
       if (!dirty_line) {
@@ -777,7 +1187,7 @@ term_paint(void)
 
       if (break_run) {
         if (dirty_run && textlen)
-          win_text(start, i, text, textlen, attr, line->attr);
+          draw_text(start, i, text, textlen, attr, line->attr);
         start = j;
         textlen = 0;
         attr = tattr;
@@ -788,20 +1198,26 @@ term_paint(void)
         !termchars_equal_override(&dispchars[j], d, tchar, tattr);
       dirty_run |= do_copy;
 
-      text[textlen++] = tchar;
-
-      if (d->cc_next) {
-        termchar *dd = d;
-        while (dd->cc_next && textlen < 16) {
-          dd += dd->cc_next;
-          text[textlen++] = dd->chr;
+      void add_text(xchar xc) {
+        if (xc < 0x10000)
+          text[textlen++] = xc;
+        else {
+          text[textlen++] = high_surrogate(xc);
+          text[textlen++] = low_surrogate(xc);
+          attr |= TATTR_COMBINING;
         }
+      }
+
+      add_text(tchar);
+
+      if (d->cc) {
+        for (const xchar *cc = cc_chars(d->cc); *cc && textlen < 15; cc++)
+          add_text(*cc);
         attr |= TATTR_COMBINING;
       }
 
       if (do_copy) {
-        copy_termchar(displine, j, d);  // may change displine->chars
-        dispchars = displine->chars;
+        dispchars[j] = *d;
         dispchars[j].chr = tchar;
         dispchars[j].attr = tattr;
         if (start == j)
@@ -809,7 +1225,7 @@ term_paint(void)
       }
 
      /* If it's a wide char step along to the next one. */
-      if ((tattr & ATTR_WIDE) && ++j < term.cols) {
+      if ((tattr & ATTR_WIDE) && ++j < term->cols) {
         d++;
        /*
         * By construction above, the cursor should not
@@ -818,15 +1234,44 @@ term_paint(void)
         */
         if (!termchars_equal(&dispchars[j], d))
           dirty_run = true;
-        copy_termchar(displine, j, d);
+        dispchars[j] = *d;
       }
     }
     if (dirty_run && textlen)
-      win_text(start, i, text, textlen, attr, line->attr);
+      draw_text(start, i, text, textlen, attr, line->attr);
+    displine->hash = hashes[i];
+    displine->blinks = blinks;
     release_line(line);
   }
 
-  term.cursor_invalid = false;
+  trace_end("paint rows", rows_start, term->rows);
+
+  term->cursor_invalid = false;
+  term->painted_curs_y = curs_y;
+
+  if (term->draw.num_runs) {
+    long long draw_start = trace_begin();
+    win_draw(&term->draw);
+    trace_end("win_draw", draw_start, term->draw.num_runs);
+  }
+  trace_latency(LAT_DRAW);
+
+  count(CNT_TEXT, term->draw.num_runs);
+  count(CNT_TEXT_CHARS, term->draw.text_len);
+  count_time(CNT_PAINT_TIME, start);
+  trace_end("term_paint", trace_start, overlays_only);
+}
+
+void
+term_paint(void)
+{
+  paint(false);
+}
+
+void
+term_paint_overlays(void)
+{
+  paint(true);
 }
 
 void
@@ -836,18 +1281,18 @@ term_invalidate(int left, int top, int right, int bottom)
     left = 0;
   if (top < 0)
     top = 0;
-  if (right >= term.cols)
-    right = term.cols - 1;
-  if (bottom >= term.rows)
-    bottom = term.rows - 1;
-
-  for (int i = top; i <= bottom && i < term.rows; i++) {
-    if ((term.displines[i]->attr & LATTR_MODE) == LATTR_NORM)
-      for (int j = left; j <= right && j < term.cols; j++)
-        term.displines[i]->chars[j].attr |= ATTR_INVALID;
+  if (right >= term->cols)
+    right = term->cols - 1;
+  if (bottom >= term->rows)
+    bottom = term->rows - 1;
+
+  for (int i = top; i <= bottom && i < term->rows; i++) {
+    if ((term->displines[i]->attr & LATTR_MODE) == LATTR_NORM)
+      for (int j = left; j <= right && j < term->cols; j++)
+        term->displines[i]->chars[j].attr |= ATTR_INVALID;
     else
-      for (int j = left / 2; j <= right / 2 + 1 && j < term.cols; j++)
-        term.displines[i]->chars[j].attr |= ATTR_INVALID;
+      for (int j = left / 2; j <= right / 2 + 1 && j < term->cols; j++)
+        term->displines[i]->chars[j].attr |= ATTR_INVALID;
   }
 }
 
@@ -862,53 +1307,147 @@ void
 term_scroll(int rel, int where)
 {
   int sbtop = -sblines();
-  term.disptop = (rel < 0 ? 0 : rel > 0 ? sbtop : term.disptop) + where;
-  if (term.disptop < sbtop)
-    term.disptop = sbtop;
-  if (term.disptop > 0)
-    term.disptop = 0;
+  term->disptop = (rel < 0 ? 0 : rel > 0 ? sbtop : term->disptop) + where;
+  if (term->disptop < sbtop)
+    term->disptop = sbtop;
+  if (term->disptop > 0)
+    term->disptop = 0;
   win_update();
 }
 
 void
 term_set_focus(bool has_focus)
 {
-  if (has_focus != term.has_focus) {
-    term.has_focus = has_focus;
+  if (has_focus != term->has_focus) {
+    term->has_focus = has_focus;
     term_schedule_cblink();
-    if (term.report_focus)
+    if (term->report_focus)
       child_write(has_focus ? "\e[I" : "\e[O", 3);
   }
 }
 
+/*
+ * Select the current terminal's charset settings, which other terminals
+ * might have changed meanwhile. The decoder only needs resetting when the
+ * terminal's own settings change.
+ */
 void
 term_update_cs()
 {
-  term_cursor *curs = &term.curs;
-  cs_set_mode(
+  term_cursor *curs = &term->curs;
+  cs_mode mode =
     curs->oem_acs ? CSM_OEM :
     curs->utf ? CSM_UTF8 :
-    curs->csets[curs->g1] == CSET_OEM ? CSM_OEM : CSM_DEFAULT
-  );
+    curs->csets[curs->g1] == CSET_OEM ? CSM_OEM : CSM_DEFAULT;
+  if (mode != term->charset_mode) {
+    term->charset_mode = mode;
+    cs_mb1towc(&term->decoder, 0, 0);
+  }
+  cs_select(mode, term->charset_locale);
 }
 
 int
 term_cursor_type(void)
 {
-  return term.cursor_type == -1 ? cfg.cursor_type : term.cursor_type;
+  return term->cursor_type == -1 ? cfg.cursor_type : term->cursor_type;
+}
+
+/*
+ * Colour resolution. These functions only depend on their arguments and
+ * the bold config settings, so that front ends can cache their results
+ * until the palette or the config changes.
+ */
+
+/* Like term_colour_indices(), with the bold settings given explicitly. */
+void
+term_colour_indices_as(uint attr, bool rvideo,
+                       bool bold_as_colour, bool bold_as_font,
+                       colour_i *fgp, colour_i *bgp)
+{
+  colour_i fgi = (attr & ATTR_FGMASK) >> ATTR_FGSHIFT;
+  colour_i bgi = (attr & ATTR_BGMASK) >> ATTR_BGSHIFT;
+
+  if (rvideo) {
+    if (fgi >= 256)
+      fgi ^= 2;
+    if (bgi >= 256)
+      bgi ^= 2;
+  }
+  if (attr & ATTR_BOLD && bold_as_colour) {
+    if (fgi < 8)
+      fgi |= 8;
+    else if (fgi >= 256 && !bold_as_font)
+      fgi |= 1;
+  }
+  if (attr & ATTR_BLINK) {
+    if (bgi < 8)
+      bgi |= 8;
+    else if (bgi >= 256)
+      bgi |= 1;
+  }
+  *fgp = fgi;
+  *bgp = bgi;
+}
+
+void
+term_colour_indices(uint attr, bool rvideo, colour_i *fgp, colour_i *bgp)
+{
+  term_colour_indices_as(attr, rvideo, cfg.bold_as_colour, cfg.bold_as_font,
+                         fgp, bgp);
+}
+
+text_colours
+term_text_colours(uint attr, const colour *palette, bool rvideo,
+                  colour_i cursor_i, int cursor_type)
+{
+  colour_i fgi, bgi;
+  term_colour_indices(attr, rvideo, &fgi, &bgi);
+
+  colour fg = palette[fgi];
+  colour bg = palette[bgi];
+
+  if (attr & ATTR_DIM) {
+    fg = (fg & 0xFEFEFEFE) >> 1; // Halve the brightness.
+    if (!cfg.bold_as_colour || fgi >= 256)
+      fg += (bg & 0xFEFEFEFE) >> 1; // Blend with background.
+  }
+  if (attr & ATTR_REVERSE) {
+    colour t = fg; fg = bg; bg = t;
+  }
+  if (attr & ATTR_INVISIBLE)
+    fg = bg;
+
+  colour cursor = 0;
+  if (attr & (TATTR_ACTCURS | TATTR_PASCURS)) {
+    cursor = palette[cursor_i];
+
+    bool too_close = colour_dist(cursor, bg) < 32768;
+
+    if (too_close)
+      cursor = fg;
+
+    if ((attr & TATTR_ACTCURS) && cursor_type == CUR_BLOCK) {
+      fg = palette[CURSOR_TEXT_COLOUR_I];
+      if (too_close && colour_dist(cursor, fg) < 32768)
+        fg = bg;
+      bg = cursor;
+    }
+  }
+
+  return (text_colours){.fg = fg, .bg = bg, .cursor = cursor};
 }
 
 bool
 term_cursor_blinks(void)
 {
-  return term.cursor_blinks == -1 ? cfg.cursor_blinks : term.cursor_blinks;
+  return term->cursor_blinks == -1 ? cfg.cursor_blinks : term->cursor_blinks;
 }
 
 void
 term_hide_cursor(void)
 {
-  if (term.cursor_on) {
-    term.cursor_on = false;
+  if (term->cursor_on) {
+    term->cursor_on = false;
     win_update();
   }
 }
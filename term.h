@@ -3,6 +3,8 @@
 
 #include "minibidi.h"
 #include "config.h"
+#include "charset.h"
+#include "latency.h"
 
 // Colour numbers
 
@@ -118,40 +120,70 @@ enum {
   ATTR_DEFAULT = ATTR_DEFFG | ATTR_DEFBG,
 };
 
+/* The attributes that affect the colours a character is drawn in. */
+enum {
+  ATTR_COLOURMASK =
+    ATTR_FGMASK | ATTR_BGMASK | ATTR_BOLD | ATTR_DIM | ATTR_INVISIBLE |
+    ATTR_REVERSE | ATTR_BLINK | TATTR_PASCURS | TATTR_ACTCURS
+};
 
+/*
+ * Final colours of a run of text, as resolved by term_text_colours().
+ * The cursor colour is only meaningful if the run has a cursor attribute.
+ */
 typedef struct {
- /*
-  * The cc_next field is used to link multiple termchars
-  * together into a list, so as to fit more than one character
-  * into a character cell (Unicode combining characters).
-  * 
-  * cc_next is a relative offset into the current array of
-  * termchars. I.e. to advance to the next character in a list,
-  * one does `tc += tc->next'.
-  * 
-  * Zero means end of list.
-  */
-  short cc_next;
+  colour fg, bg, cursor;
+} text_colours;
+
 
+typedef struct {
  /*
   * Any code in terminal.c which definitely needs to be changed
   * when extra fields are added here is labelled with a comment
   * saying FULL-TERMCHAR.
+  *
+  * Characters are stored as full UTF-32 code points, so characters
+  * outside the Basic Multilingual Plane occupy a single cell rather
+  * than a surrogate pair. Conversion to UTF-16 only happens when text
+  * is handed to the front end for display or copying.
+  */
+  xchar chr;
+
+ /*
+  * Combining characters are not stored in the line itself.
+  * Instead, cc is the index of the cell's combining sequence in the
+  * terminal's sequence pool, or zero if there is none. Sequences are
+  * interned, so two cells carry the same combining characters if and
+  * only if their cc fields are equal, and cells can be copied and
+  * moved around like plain values.
   */
-  wchar chr;
+  ushort cc;
+
   uint attr;
 
 } termchar;
 
 const termchar basic_erase_char;
 
+/*
+ * A highlight overlaid on a display line, such as the selection: a span of
+ * logical columns whose attributes are XORed with attr when painting.
+ */
+typedef struct {
+  ushort start, end;
+  uint attr;
+} overlay_span;
+
+enum { MAX_OVERLAYS = 4 };
+
 typedef struct {
   ushort attr;
   ushort cols;    /* number of real columns on the line */
-  ushort size;    /* number of allocated termchars
-                     (cc-lists may make this > cols) */
   bool temporary; /* true if decompressed from scrollback */
-  short cc_free;  /* offset to first cc in free list */
+  bool blinks;    /* display lines only: has blinking text */
+  uchar overlay_num;  /* display lines only: overlays last painted */
+  overlay_span overlays[MAX_OVERLAYS];
+  uint hash;      /* display lines only: hash of the content last painted */
   termchar *chars;
 } termline;
 
@@ -175,13 +207,11 @@ void release_line(termline *);
 int termchars_equal(termchar *a, termchar *b);
 int termchars_equal_override(termchar *a, termchar *b, uint bchr, uint battr);
 
-void copy_termchar(termline *destline, int x, termchar *src);
-void move_termchar(termline *line, termchar *dest, termchar *src);
+void add_cc(termline *, int col, xchar chr);
+const xchar *cc_chars(ushort cc);
+void cc_collect(bool force);
 
-void add_cc(termline *, int col, wchar chr);
-void clear_cc(termline *, int col);
-
-uchar *compressline(termline *);
+uchar *compressline(termline *, int *bytes_used);
 termline *decompressline(uchar *, int *bytes_used);
 
 termchar *term_bidi_line(termline *, int scr_y);
@@ -194,10 +224,49 @@ typedef enum {
   CSET_OEM = 'U'      /* OEM Codepage 437 */
 } term_cset;
 
+/*
+ * Pool of interned combining character sequences. Entry 0 is reserved to
+ * mean "no combining characters". The pool is limited to what fits into
+ * the 16-bit cc field of a termchar, so a terminal's pool is rebuilt from
+ * the sequences still in use when it's getting full.
+ */
+typedef struct {
+  xchar **seqs;      /* zero-terminated sequences, indexed by cc value */
+  uint num, size;    /* number of entries used and allocated */
+  ushort *hash;      /* open-addressed hash table of indices into seqs */
+  uint hash_size;    /* always a power of two */
+} cc_pool;
+
+const xchar *cc_pool_chars(cc_pool *, ushort cc);
+void cc_pool_free(cc_pool *);
+termline *decompressline_pool(uchar *, cc_pool *);
+uchar *fetch_compressed_line(int y);
+
 typedef struct {
   int y, x;
 } pos;
 
+/*
+ * The draw list is what term_paint() produces for the front end: a run
+ * of text for each part of the screen that needs redrawing, with the
+ * text of all runs kept in a single buffer. Both buffers are reused
+ * from one update to the next.
+ */
+typedef struct {
+  ushort x, y;       /* position in character cells */
+  ushort lattr;      /* line attributes */
+  ushort len;        /* number of UTF-16 code units */
+  uint attr;         /* character, cursor and combining attributes */
+  uint text;         /* offset of the run's text in the text buffer */
+} draw_run;
+
+typedef struct {
+  draw_run *runs;
+  uint num_runs, runs_size;
+  wchar *text;
+  uint text_len, text_size;
+} draw_list;
+
 typedef enum {
   MBT_LEFT = 1, MBT_MIDDLE = 2, MBT_RIGHT = 3
 } mouse_button;
@@ -219,6 +288,8 @@ typedef struct {
   uchar oem_acs;
 } term_cursor;
 
+typedef struct term term_t;
+
 struct term {
   bool on_alt_screen;     /* On alternate screen? */
   bool show_other_screen;
@@ -227,6 +298,8 @@ struct term {
   term_cursor curs, saved_cursors[2];
 
   uchar **scrollback;     /* lines scrolled off top of screen */
+  int *sbsizes;           /* their compressed sizes, for the counters */
+  long long sbbytes;      /* total size of the scrollback lines */
   int disptop;            /* distance scrolled back (0 or -ve) */
   int sblen;              /* length of scrollback buffer */
   int sblines;            /* number of lines of scrollback */
@@ -234,13 +307,30 @@ struct term {
   int tempsblines;        /* number of lines of .scrollback that
                            * can be retrieved onto the terminal
                            * ("temporary scrollback") */
+  int sb_retained;        /* number of users holding on to scrollback lines */
+  int sb_retain_num;      /* number of oldest lines they might be using */
+  int sb_fresh;           /* number of newest lines they can't be using */
+  uchar **sb_retired;     /* lines to be freed once no longer retained */
+  int sb_retired_num, sb_retired_size;
 
   termlines *displines;   /* buffer of text on real screen */
+  draw_list draw;         /* runs of text to be drawn by the front end */
+  int painted_curs_y;     /* display line the cursor was painted on, or -1 */
 
   termchar erase_char;
 
-  char *inbuf;      /* terminal input buffer */
-  uint inbuf_size, inbuf_pos;
+  cc_pool ccs;            /* combining character sequences */
+
+  struct {
+    bool on;
+    bool deselected;      /* selection cleared by output */
+    int sblines;          /* number of scrollback lines when frozen */
+    uchar **sb;           /* those lines, shared with the scrollback */
+    termlines *lines;     /* copies of the screen lines */
+    term_cursor curs;
+    bool cursor_on;
+    int pushed;           /* lines pushed into the scrollback since */
+  } frozen;               /* view held still during drag-selects */
 
   bool rvideo;   /* global reverse video flag */
   bool cursor_on;        /* cursor enabled flag */
@@ -276,12 +366,14 @@ struct term {
   bool report_ambig_width;
   bool bracketed_paste;
   bool show_scrollbar;
+  bool sync_output;       /* hold back paints until a frame is complete */
 
   int  cursor_type;
   int  cursor_blinks;
   bool cursor_invalid;
 
-  uchar esc_mod;  // Modifier character in escape sequences
+  uchar esc_mod;  // Modifier character in escape sequences, 0xFF if several
+  ushort esc_mods;  // Both modifiers if there were exactly two
 
   uint csi_argc;
   uint csi_argv[32];
@@ -321,6 +413,25 @@ struct term {
     MS_COPYING = -4, MS_PASTING = -5, MS_OPENING = -6
   } mouse_state;
 
+  // Rate limiting of mouse motion reports
+  struct {
+    bool pending;
+    mouse_button b;
+    mod_keys mods;
+    pos p;
+    // Last report sent
+    int tick;
+    mouse_button last_b;
+    pos last_p;
+  } motion;
+
+  // Mouse wheel movement not yet acted upon
+  int wheel_accu;
+
+  // Destination of the last move by "clicks place cursor", if any
+  bool click_moved;
+  pos click_dest;
+
   bool sel_rect, selected;
   pos sel_start, sel_end, sel_anchor;
   
@@ -331,12 +442,25 @@ struct term {
   wchar *paste_buffer;
   int paste_len, paste_pos;
 
+ /* Conversion state of the input, and the charset settings it's for */
+  cs_decoder decoder;
+  cs_mode charset_mode;
+  string charset_locale;  // set via OSC 701, or null for the configured one
+
+ /* Keystrokes waiting for their echo to be drawn */
+  latency_pending latency;
+
  /* True when we've seen part of a multibyte input char */
   bool in_mb_char;
   
  /* Non-zero when we've seen the first half of a surrogate pair */
   wchar high_surrogate;
 
+ /* Grapheme cluster segmentation state, carried across term_write() calls */
+  uchar gcb_prop;   /* break property of the previous character */
+  uchar gcb_emoji;  /* progress through an emoji ZWJ sequence */
+  bool gcb_ri_odd;  /* previous character is an unpaired regional indicator */
+
  /*
   * These are buffers used by the bidi and Arabic shaping code.
   */
@@ -348,8 +472,25 @@ struct term {
   int bidi_cache_size;
 };
 
-extern struct term term;
+/*
+ * The terminal that the term_* functions and the rest of the terminal core
+ * operate on. Any number of terminals can be created, and the front end
+ * makes the one it's dealing with current, including before calling any
+ * timer callbacks. The functions don't take the terminal as an argument.
+ *
+ * Parser and decoder state, the bidi caches, the combining character pool
+ * and pending latency keystrokes are kept per terminal. The counters, the
+ * latency histograms and the headless renderer are shared by all terminals
+ * in the process. All terminals therefore belong to the main thread, and
+ * the only other thread, for background copies, works on a snapshot.
+ * Terminals that are to run in parallel need separate processes.
+ */
+extern term_t *term;
+
+term_t *term_new(void);
+void term_free(term_t *);
 
+void term_update_cs(void);
 void term_resize(int, int);
 void term_scroll(int, int);
 void term_reset(void);
@@ -360,9 +501,12 @@ void term_mouse_move(mod_keys, pos);
 void term_mouse_wheel(int delta, int lines_per_notch, mod_keys, pos);
 void term_select_all(void);
 void term_paint(void);
+void term_paint_overlays(void);
 void term_invalidate(int left, int top, int right, int bottom);
 void term_open(void);
 void term_copy(void);
+void term_cancel_copy(void);
+int term_copy_progress(void);
 void term_paste(wchar *, uint len);
 void term_send_paste(void);
 void term_cancel_paste(void);
@@ -370,9 +514,14 @@ void term_reconfig(void);
 void term_flip_screen(void);
 void term_reset_screen(void);
 void term_write(const char *, uint len);
-void term_flush(void);
 void term_set_focus(bool has_focus);
 int  term_cursor_type(void);
+void term_colour_indices(uint attr, bool rvideo, colour_i *fgi, colour_i *bgi);
+void term_colour_indices_as(uint attr, bool rvideo,
+                            bool bold_as_colour, bool bold_as_font,
+                            colour_i *fgi, colour_i *bgi);
+text_colours term_text_colours(uint attr, const colour *palette, bool rvideo,
+                               colour_i cursor_i, int cursor_type);
 bool term_cursor_blinks(void);
 void term_hide_cursor(void);
 
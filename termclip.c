@@ -8,52 +8,143 @@
 #include "win.h"
 #include "child.h"
 #include "charset.h"
+#include "trace.h"
+
+#include <pthread.h>
 
 /*
- * Helper routine for term_copy(): growing buffer.
+ * Helper routine for term_copy(): growing buffer. Attributes are only
+ * captured if attrbuf is allocated.
  */
 typedef struct {
   int buflen;   /* amount of allocated space in textbuf/attrbuf */
   int bufpos;   /* amount of actual data */
   wchar *textbuf;       /* buffer for copied text */
-  wchar *textptr;       /* = textbuf + bufpos (current insertion point) */
-  uint *attrbuf; /* buffer for copied attributes */
-  uint *attrptr; /* = attrbuf + bufpos */
+  uint *attrbuf; /* buffer for copied attributes, or null */
 } clip_workbuf;
 
 static void
-clip_addchar(clip_workbuf * b, wchar chr, int attr)
+clip_reserve(clip_workbuf *b, int n)
 {
-  if (b->bufpos >= b->buflen) {
-    b->buflen += 128;
+  if (b->bufpos + n > b->buflen) {
+    b->buflen = max(b->buflen * 2, b->bufpos + n);
     b->textbuf = renewn(b->textbuf, b->buflen);
-    b->textptr = b->textbuf + b->bufpos;
-    b->attrbuf = renewn(b->attrbuf, b->buflen);
-    b->attrptr = b->attrbuf + b->bufpos;
+    if (b->attrbuf)
+      b->attrbuf = renewn(b->attrbuf, b->buflen);
   }
-  *b->textptr++ = chr;
-  *b->attrptr++ = attr;
+}
+
+static inline void
+clip_addchar(clip_workbuf * b, wchar chr, int attr)
+{
+  if (b->bufpos >= b->buflen)
+    clip_reserve(b, 1);
+  b->textbuf[b->bufpos] = chr;
+  if (b->attrbuf)
+    b->attrbuf[b->bufpos] = attr;
   b->bufpos++;
 }
 
 static void
-get_selection(clip_workbuf *buf)
+clip_addxchar(clip_workbuf * b, xchar chr, int attr)
 {
-  pos start = term.sel_start, end = term.sel_end;
-  
-  int old_top_x;
-  int attr;
+  if (chr < 0x10000)
+    clip_addchar(b, chr, attr);
+  else {
+    clip_addchar(b, high_surrogate(chr), attr);
+    clip_addchar(b, low_surrogate(chr), attr);
+  }
+}
 
-  buf->buflen = 5120;
+/*
+ * Selection extractor. The output buffer is sized up front for the
+ * common case of one code unit per cell plus line ends, so that even
+ * huge selections need few if any reallocations. Text is produced a
+ * number of lines at a time, so that callers can spread the work out.
+ *
+ * The selected lines are snapshotted in compressed form when the
+ * extractor is set up, with combining characters going into a private
+ * pool, so that extraction doesn't touch the terminal state and can
+ * run on a background thread.
+ */
+typedef struct {
+  pos start, end;
+  int top_x;     /* start column of each line, for rectangular selection */
+  int cols;
+  bool rect;
+  int top_y;     /* line number of the first snapshot line */
+  int num_lines; /* number of snapshot lines ... */
+  int sb_lines;  /* ... of which this many are shared with the scrollback */
+  uchar **lines;
+  cc_pool ccs;
+  clip_workbuf buf;
+} sel_extractor;
+
+static void
+sel_init(sel_extractor *ex, bool with_attrs)
+{
+  pos start = term->sel_start, end = term->sel_end;
+  ex->start = start;
+  ex->end = end;
+  ex->top_x = start.x;
+  ex->cols = term->cols;
+  ex->rect = term->sel_rect;
+
+  ex->top_y = start.y;
+  ex->num_lines = max(min(end.y, term->rows - 1) - start.y + 1, 0);
+  ex->sb_lines = 0;
+  ex->lines = newn(uchar *, max(ex->num_lines, 1));
+  for (int i = 0; i < ex->num_lines; i++) {
+    int y = start.y + i;
+    ex->lines[i] = fetch_compressed_line(y);
+    if (y < 0)
+      ex->sb_lines++;
+  }
+  if (ex->sb_lines)
+    term_retain_scrollback();
+  memset(&ex->ccs, 0, sizeof ex->ccs);
+
+  int width = ex->rect ? max(end.x - start.x, 0) : ex->cols;
+  clip_workbuf *buf = &ex->buf;
+  buf->buflen = ex->num_lines * (width + 2) + 1;
   buf->bufpos = 0;
-  buf->textptr = buf->textbuf = newn(wchar, buf->buflen);
-  buf->attrptr = buf->attrbuf = newn(uint, buf->buflen);
+  buf->textbuf = newn(wchar, buf->buflen);
+  buf->attrbuf = with_attrs ? newn(uint, buf->buflen) : 0;
+}
+
+/*
+ * Free the line snapshot, but not the output buffer.
+ * Must be called from the main thread.
+ */
+static void
+sel_free(sel_extractor *ex)
+{
+  for (int i = ex->sb_lines; i < ex->num_lines; i++)
+    free(ex->lines[i]);
+  free(ex->lines);
+  ex->lines = 0;
+  if (ex->sb_lines)
+    term_release_scrollback();
+  ex->num_lines = ex->sb_lines = 0;
+  cc_pool_free(&ex->ccs);
+}
 
-  old_top_x = start.x;    /* needed for rect==1 */
+/*
+ * Extract up to max_lines lines of the selection. Returns true and
+ * terminates the text once the end of the selection has been reached.
+ */
+static bool
+sel_extract(sel_extractor *ex, int max_lines)
+{
+  pos start = ex->start, end = ex->end;
+  clip_workbuf *buf = &ex->buf;
+  int last_y = ex->top_y + ex->num_lines;
 
-  while (poslt(start, end)) {
+  for (; max_lines > 0 && poslt(start, end) && start.y < last_y; max_lines--) {
     bool nl = false;
-    termline *line = fetch_line(start.y);
+    termline *line =
+      decompressline_pool(ex->lines[start.y - ex->top_y], &ex->ccs);
+    resizeline(line, ex->cols);
     pos nlpos;
 
    /*
@@ -62,7 +153,7 @@ get_selection(clip_workbuf *buf)
     * line...
     */
     nlpos.y = start.y;
-    nlpos.x = term.cols;
+    nlpos.x = ex->cols;
 
    /*
     * ... move it backwards if there's unused space at the end
@@ -72,7 +163,7 @@ get_selection(clip_workbuf *buf)
     */
     if (!(line->attr & LATTR_WRAPPED)) {
       while (nlpos.x && line->chars[nlpos.x - 1].chr == ' ' &&
-             !line->chars[nlpos.x - 1].cc_next && poslt(start, nlpos))
+             !line->chars[nlpos.x - 1].cc && poslt(start, nlpos))
         decpos(nlpos);
       if (poslt(nlpos, end))
         nl = true;
@@ -89,35 +180,25 @@ get_selection(clip_workbuf *buf)
     * column from a table doesn't fill with spaces on the
     * right.)
     */
-    if (term.sel_rect) {
+    if (ex->rect) {
       if (nlpos.x > end.x)
         nlpos.x = end.x;
       nl = (start.y < end.y);
     }
 
+    clip_reserve(buf, max(nlpos.x - start.x, 0) + 2);
     while (poslt(start, end) && poslt(start, nlpos)) {
-      wchar cbuf[16], *p;
-      int x = start.x;
+      termchar *c = &line->chars[start.x];
 
-      if (line->chars[x].chr == UCSWIDE) {
+      if (c->chr == UCSWIDE) {
         start.x++;
         continue;
       }
 
-      while (1) {
-        wchar c = line->chars[x].chr;
-        attr = line->chars[x].attr;
-        cbuf[0] = c;
-        cbuf[1] = 0;
-
-        for (p = cbuf; *p; p++)
-          clip_addchar(buf, *p, attr);
-
-        if (line->chars[x].cc_next)
-          x += line->chars[x].cc_next;
-        else
-          break;
-      }
+      int attr = c->attr;
+      clip_addxchar(buf, c->chr, attr);
+      for (const xchar *cc = cc_pool_chars(&ex->ccs, c->cc); *cc; cc++)
+        clip_addxchar(buf, *cc, attr);
       start.x++;
     }
     if (nl) {
@@ -125,36 +206,178 @@ get_selection(clip_workbuf *buf)
       clip_addchar(buf, '\n', 0);
     }
     start.y++;
-    start.x = term.sel_rect ? old_top_x : 0;
+    start.x = ex->rect ? ex->top_x : 0;
 
-    release_line(line);
+    freeline(line);
   }
+  ex->start = start;
+
+  if (poslt(start, end) && start.y < last_y)
+    return false;
   clip_addchar(buf, 0, 0);
+  return true;
+}
+
+static void
+get_selection(clip_workbuf *buf, bool with_attrs)
+{
+  sel_extractor ex;
+  sel_init(&ex, with_attrs);
+  sel_extract(&ex, INT_MAX);
+  sel_free(&ex);
+  *buf = ex.buf;
+}
+
+/*
+ * Copying of large selections is done on a background thread, which
+ * extracts the text and prepares the clipboard data. The main thread
+ * polls for completion and then hands the data to the clipboard.
+ * Progress and cancellation flags are shared between the two threads.
+ * The colours and settings the clipboard data is formatted with are
+ * captured when the copy starts, as they can change meanwhile.
+ * There's only one background copy at a time, whichever terminal it's for.
+ */
+enum {
+  COPY_SYNC_LINES = 1000,  /* copy smaller selections synchronously */
+  COPY_CHUNK_LINES = 256,  /* lines to extract between cancellation checks */
+  COPY_POLL_TICKS = 50
+};
+
+static struct {
+  bool active;
+  term_t *owner;
+  pthread_t thread;
+  sel_extractor ex;
+  copy_style style;
+  int total_lines;
+  int lines_done;   /* shared */
+  bool cancel;      /* shared */
+  bool done;        /* shared */
+  clip_data *clip;
+} copy_job;
+
+static void *
+copy_thread(void *unused(arg))
+{
+  sel_extractor *ex = &copy_job.ex;
+  bool finished = false;
+  trace_thread_name("copy");
+  while (!finished && !__atomic_load_n(&copy_job.cancel, __ATOMIC_RELAXED)) {
+    long long start = trace_begin();
+    finished = sel_extract(ex, COPY_CHUNK_LINES);
+    trace_end("copy", start, COPY_CHUNK_LINES);
+    int done = ex->start.y - ex->top_y;
+    __atomic_store_n(&copy_job.lines_done, done, __ATOMIC_RELAXED);
+  }
+  if (finished) {
+    clip_workbuf *buf = &ex->buf;
+    copy_job.clip = win_prepare_copy(buf->textbuf, buf->attrbuf, buf->bufpos,
+                                     &copy_job.style, &copy_job.cancel);
+  }
+  __atomic_store_n(&copy_job.done, true, __ATOMIC_RELEASE);
+  return 0;
+}
+
+static void
+copy_job_end(bool to_clipboard)
+{
+  pthread_join(copy_job.thread, 0);
+  if (copy_job.clip)
+    win_finish_copy(copy_job.clip, to_clipboard);
+  // The snapshot holds on to its terminal's scrollback.
+  term_t *cur = term;
+  term = copy_job.owner;
+  sel_free(&copy_job.ex);
+  term = cur;
+  free(copy_job.ex.buf.textbuf);
+  free(copy_job.ex.buf.attrbuf);
+  copy_job.active = false;
+  copy_job.owner = 0;
+  copy_job.clip = 0;
+  win_update_mouse();
+}
+
+static void
+copy_poll_cb(void)
+{
+  if (!copy_job.active)
+    return;
+  if (__atomic_load_n(&copy_job.done, __ATOMIC_ACQUIRE))
+    copy_job_end(true);
+  else
+    win_set_timer(copy_poll_cb, COPY_POLL_TICKS);
+}
+
+static void
+cancel_copy_job(void)
+{
+  if (!copy_job.active)
+    return;
+  __atomic_store_n(&copy_job.cancel, true, __ATOMIC_RELAXED);
+  copy_job_end(false);
+}
+
+/* Abandon a background copy from this terminal that's still in progress. */
+void
+term_cancel_copy(void)
+{
+  if (copy_job.owner == term)
+    cancel_copy_job();
+}
+
+/* Percentage done of a background copy from this terminal, or -1. */
+int
+term_copy_progress(void)
+{
+  if (!copy_job.active || copy_job.owner != term)
+    return -1;
+  int done = __atomic_load_n(&copy_job.lines_done, __ATOMIC_RELAXED);
+  return done * 100 / max(copy_job.total_lines, 1);
 }
 
 void
 term_copy(void)
 {
-  if (!term.selected)
+  if (!term->selected)
     return;
-  
-  clip_workbuf buf;
-  get_selection(&buf);
-  
+
+  cancel_copy_job();
+
+  sel_extractor *ex = &copy_job.ex;
+  sel_init(ex, cfg.copy_as_rtf);
+
+  if (ex->num_lines > COPY_SYNC_LINES) {
+    copy_job.total_lines = ex->num_lines;
+    copy_job.lines_done = 0;
+    copy_job.cancel = copy_job.done = false;
+    copy_job.clip = 0;
+    win_get_copy_style(&copy_job.style);
+    if (!pthread_create(&copy_job.thread, 0, copy_thread, 0)) {
+      copy_job.active = true;
+      copy_job.owner = term;
+      win_set_timer(copy_poll_cb, COPY_POLL_TICKS);
+      win_update_mouse();
+      return;
+    }
+  }
+
+  sel_extract(ex, INT_MAX);
+  sel_free(ex);
+
  /* Finally, transfer all that to the clipboard. */
-  win_copy(buf.textbuf, buf.attrbuf, buf.bufpos);
-  free(buf.textbuf);
-  free(buf.attrbuf);
+  clip_workbuf *buf = &ex->buf;
+  win_copy(buf->textbuf, buf->attrbuf, buf->bufpos);
+  free(buf->textbuf);
+  free(buf->attrbuf);
 }
 
 void
 term_open(void)
 {
-  if (!term.selected)
+  if (!term->selected)
     return;
   clip_workbuf buf;
-  get_selection(&buf);
-  free(buf.attrbuf);
+  get_selection(&buf, false);
   
   // Don't bother opening if it's all whitespace.
   wchar *p = buf.textbuf;
@@ -171,20 +394,20 @@ term_paste(wchar *data, uint len)
 {
   term_cancel_paste();
 
-  term.paste_buffer = newn(wchar, len);
-  term.paste_len = term.paste_pos = 0;
+  term->paste_buffer = newn(wchar, len);
+  term->paste_len = term->paste_pos = 0;
 
   // Copy data to the paste buffer, converting both Windows-style \r\n and
   // Unix-style \n line endings to \r, because that's what the Enter key sends.
   for (uint i = 0; i < len; i++) {
     wchar wc = data[i];
     if (wc != '\n')
-      term.paste_buffer[term.paste_len++] = wc;
+      term->paste_buffer[term->paste_len++] = wc;
     else if (i == 0 || data[i - 1] != '\r')
-      term.paste_buffer[term.paste_len++] = '\r';
+      term->paste_buffer[term->paste_len++] = '\r';
   }
   
-  if (term.bracketed_paste)
+  if (term->bracketed_paste)
     child_write("\e[200~", 6);
   term_send_paste();
 }
@@ -192,32 +415,42 @@ term_paste(wchar *data, uint len)
 void
 term_cancel_paste(void)
 {
-  if (term.paste_buffer) {
-    free(term.paste_buffer);
-    term.paste_buffer = 0;
-    if (term.bracketed_paste)
+  if (term->paste_buffer) {
+    free(term->paste_buffer);
+    term->paste_buffer = 0;
+    if (term->bracketed_paste)
       child_write("\e[201~", 6);
   }
 }
 
+/*
+ * Pass on paste data a chunk at a time for as long as the pty keeps up,
+ * so that large pastes neither block nor pile up in the output queue.
+ * The rest is sent once the queue has drained.
+ */
+enum { PASTE_CHUNK = 4096, PASTE_BACKLOG = 65536 };
+
 void
 term_send_paste(void)
 {
-  int i = term.paste_pos;
-  while (i < term.paste_len && term.paste_buffer[i++] != '\r');
-  child_sendw(term.paste_buffer + term.paste_pos, i - term.paste_pos);
-  if (i < term.paste_len)
-    term.paste_pos = i;
-  else
-    term_cancel_paste();
+  while (term->paste_buffer && child_write_backlog() < PASTE_BACKLOG) {
+    int n = min(term->paste_len - term->paste_pos, PASTE_CHUNK);
+    if (term->paste_pos + n < term->paste_len &&
+        is_high_surrogate(term->paste_buffer[term->paste_pos + n - 1]))
+      n--;
+    child_sendw(term->paste_buffer + term->paste_pos, n);
+    term->paste_pos += n;
+    if (term->paste_pos >= term->paste_len)
+      term_cancel_paste();
+  }
 }
 
 void
 term_select_all(void)
 {
-  term.sel_start = (pos){-sblines(), 0};
-  term.sel_end = (pos){term_last_nonempty_line(), term.cols};
-  term.selected = true;
+  term->sel_start = (pos){-sblines(), 0};
+  term->sel_end = (pos){term_last_nonempty_line(), term->cols};
+  term->selected = true;
   if (cfg.copy_on_select)
     term_copy();
 }
@@ -5,17 +5,22 @@
 
 #include "termpriv.h"
 
+#include "counters.h"
+
 termline *
 newline(int cols, int bce)
 {
+  count(CNT_ALLOC, 1);
   termline *line = new(termline);
   line->chars = newn(termchar, cols);
   for (int j = 0; j < cols; j++)
-    line->chars[j] = (bce ? term.erase_char : basic_erase_char);
-  line->cols = line->size = cols;
+    line->chars[j] = (bce ? term->erase_char : basic_erase_char);
+  line->cols = cols;
   line->attr = LATTR_NORM;
   line->temporary = false;
-  line->cc_free = 0;
+  line->blinks = false;
+  line->overlay_num = 0;
+  line->hash = 0;
   return line;
 }
 
@@ -39,6 +44,7 @@ freeline(termline *line)
 struct buf {
   uchar *data;
   int len, size;
+  cc_pool *ccs;   /* where decompressed combining characters go */
 };
 
 static void
@@ -59,70 +65,169 @@ get(struct buf *b)
 }
 
 /*
- * Add a combining character to a character cell.
+ * Combining characters live in a per-terminal pool of interned sequences,
+ * so that a character cell only needs to carry a small index into it.
+ * Sequences are limited to CC_MAX characters; anything beyond that is
+ * dropped, as is any new sequence while the pool is full. Unused entries
+ * are collected once the pool is three quarters full.
  */
-void
-add_cc(termline *line, int col, wchar chr)
+enum {
+  CC_MAX = 15, CC_POOL_MAX = 0x10000, CC_COLLECT_AT = CC_POOL_MAX / 4 * 3
+};
+
+static uint
+cc_len(const xchar *seq)
 {
-  assert(col >= 0 && col < line->cols);
+  uint len = 0;
+  while (seq[len])
+    len++;
+  return len;
+}
 
- /*
-  * Start by extending the cols array if the free list is empty.
-  */
-  if (!line->cc_free) {
-    int n = line->size;
-    line->size += 16 + (line->size - line->cols) / 2;
-    line->chars = renewn(line->chars, line->size);
-    line->cc_free = n;
-    do
-      line->chars[n].cc_next = 1;
-    while (++n < line->size - 1);
-    line->chars[n].cc_next = 0;  // Terminates the free list.
+static uint
+cc_hash(const xchar *seq)
+{
+  uint h = 2166136261u;
+  while (*seq)
+    h = (h ^ *seq++) * 16777619u;
+  return h;
+}
+
+static void
+cc_rehash(cc_pool *pool)
+{
+  pool->hash_size = pool->hash_size ? pool->hash_size * 2 : 256;
+  free(pool->hash);
+  pool->hash = newn(ushort, pool->hash_size);
+  for (uint i = 1; i < pool->num; i++) {
+    uint h = cc_hash(pool->seqs[i]) & (pool->hash_size - 1);
+    while (pool->hash[h])
+      h = (h + 1) & (pool->hash_size - 1);
+    pool->hash[h] = i;
   }
+}
 
- /*
-  * Now walk the cc list of the cell in question.
-  */
-  while (line->chars[col].cc_next)
-    col += line->chars[col].cc_next;
+/*
+ * Look up a combining sequence, adding it to the pool if necessary.
+ * Returns 0 if the pool is full.
+ */
+static ushort
+cc_intern(cc_pool *pool, const xchar *seq)
+{
+  if (pool->num * 2 >= pool->hash_size)
+    cc_rehash(pool);
+
+  uint h = cc_hash(seq) & (pool->hash_size - 1);
+  for (ushort i; (i = pool->hash[h]); h = (h + 1) & (pool->hash_size - 1)) {
+    const xchar *s = pool->seqs[i], *t = seq;
+    while (*s && *s == *t)
+      s++, t++;
+    if (*s == *t)
+      return i;
+  }
 
- /*
-  * `col' now points at the last cc currently in this cell; so
-  * we simply add another one.
-  */
-  int newcc = line->cc_free;
-  if (line->chars[newcc].cc_next)
-    line->cc_free = newcc + line->chars[newcc].cc_next;
-  else
-    line->cc_free = 0;
-  line->chars[newcc].cc_next = 0;
-  line->chars[newcc].chr = chr;
-  line->chars[col].cc_next = newcc - col;
+  if (!pool->num)
+    pool->num = 1;  // Entry 0 means no combining characters.
+  if (pool->num >= CC_POOL_MAX)
+    return 0;
+  if (pool->num >= pool->size) {
+    pool->size = pool->size * 2 + 64;
+    pool->seqs = renewn(pool->seqs, pool->size);
+  }
+  uint i = pool->num++;
+  uint len = cc_len(seq);
+  pool->seqs[i] = newn(xchar, len + 1);
+  memcpy(pool->seqs[i], seq, (len + 1) * sizeof(xchar));
+  pool->hash[h] = i;
+  return i;
 }
 
 /*
- * Clear the combining character list in a character cell.
+ * Get the zero-terminated combining sequence of a cell.
  */
+const xchar *
+cc_pool_chars(cc_pool *pool, ushort cc)
+{
+  static const xchar none[1];
+  return cc ? pool->seqs[cc] : none;
+}
+
+const xchar *
+cc_chars(ushort cc)
+{
+  return cc_pool_chars(&term->ccs, cc);
+}
+
 void
-clear_cc(termline *line, int col)
+cc_pool_free(cc_pool *pool)
 {
-  int oldfree, origcol = col;
+  for (uint i = 1; i < pool->num; i++)
+    free(pool->seqs[i]);
+  free(pool->seqs);
+  free(pool->hash);
+  memset(pool, 0, sizeof *pool);
+}
+
+/*
+ * Rebuild the current terminal's pool from the sequences in use, if it's
+ * getting full or if forced. Compressed lines carry their sequences
+ * themselves, so only the uncompressed lines need renumbering. This must
+ * only be called while no temporary lines are around, i.e. not during
+ * painting or output processing.
+ */
+void
+cc_collect(bool force)
+{
+  if (!term->lines || !(force || term->ccs.num >= CC_COLLECT_AT))
+    return;
 
+  cc_pool old = term->ccs;
+  memset(&term->ccs, 0, sizeof term->ccs);
+
+  void renumber(termline *line) {
+    for (int j = 0; j < line->cols; j++) {
+      termchar *c = &line->chars[j];
+      if (c->cc)
+        c->cc = cc_intern(&term->ccs, cc_pool_chars(&old, c->cc));
+    }
+  }
+  for (int i = 0; i < term->rows; i++) {
+    renumber(term->lines[i]);
+    renumber(term->other_lines[i]);
+    renumber(term->displines[i]);
+    if (term->frozen.on)
+      renumber(term->frozen.lines[i]);
+  }
+
+  // The bidi cache holds old numbers, so make its entries miss.
+  for (int i = 0; i < term->bidi_cache_size; i++)
+    term->pre_bidi_cache[i].width = -1;
+
+  cc_pool_free(&old);
+}
+
+/*
+ * Add a combining character to a character cell.
+ */
+void
+add_cc(termline *line, int col, xchar chr)
+{
   assert(col >= 0 && col < line->cols);
 
-  if (!line->chars[col].cc_next)
-    return;     /* nothing needs doing */
+  termchar *c = &line->chars[col];
+  const xchar *old = cc_chars(c->cc);
+  uint len = cc_len(old);
+  if (len >= CC_MAX)
+    return;
 
-  oldfree = line->cc_free;
-  line->cc_free = col + line->chars[col].cc_next;
-  while (line->chars[col].cc_next)
-    col += line->chars[col].cc_next;
-  if (oldfree)
-    line->chars[col].cc_next = oldfree - col;
-  else
-    line->chars[col].cc_next = 0;
+  xchar seq[len + 2];
+  memcpy(seq, old, len * sizeof(xchar));
+  seq[len] = chr;
+  seq[len + 1] = 0;
 
-  line->chars[origcol].cc_next = 0;
+  ushort cc = cc_intern(&term->ccs, seq);
+  if (cc)
+    c->cc = cc;
 }
 
 /*
@@ -138,15 +243,7 @@ termchars_equal_override(termchar *a, termchar *b, uint bchr, uint battr)
     return false;
   if ((a->attr & ~DATTR_MASK) != (battr & ~DATTR_MASK))
     return false;
-  while (a->cc_next || b->cc_next) {
-    if (!a->cc_next || !b->cc_next)
-      return false;     /* one cc-list ends, other does not */
-    a += a->cc_next;
-    b += b->cc_next;
-    if (a->chr != b->chr)
-      return false;
-  }
-  return true;
+  return a->cc == b->cc;
 }
 
 int
@@ -155,67 +252,40 @@ termchars_equal(termchar *a, termchar *b)
   return termchars_equal_override(a, b, b->chr, b->attr);
 }
 
-/*
- * Copy a character cell. (Requires a pointer to the destination
- * termline, so as to access its free list.)
- */
-void
-copy_termchar(termline *destline, int x, termchar *src)
-{
-  clear_cc(destline, x);
-
-  destline->chars[x] = *src;    /* copy everything except cc-list */
-  destline->chars[x].cc_next = 0;       /* and make sure this is zero */
-
-  while (src->cc_next) {
-    src += src->cc_next;
-    add_cc(destline, x, src->chr);
-  }
-}
-
-/*
- * Move a character cell within its termline.
- */
-void
-move_termchar(termline * line, termchar *dest, termchar *src)
-{
- /* First clear the cc list from the original char, just in case. */
-  clear_cc(line, dest - line->chars);
-
- /* Move the character cell and adjust its cc_next. */
-  *dest = *src; /* copy everything except cc-list */
-  if (src->cc_next)
-    dest->cc_next = src->cc_next - (dest - src);
-
- /* Ensure the original cell doesn't have a cc list. */
-  src->cc_next = 0;
-}
-
 static void
 makeliteral_chr(struct buf *buf, termchar *c)
 {
  /*
   * The encoding for characters assigns one-byte codes to printable
   * ASCII characters and NUL, and two-byte codes to anything else up
-  * to 0x96FF. UTF-16 surrogates also get two-byte codes, to avoid non-BMP
-  * characters exploding to six bytes. Anything else is three bytes long.
+  * to 0x96FF. Characters in planes 1 to 7, which include emoji and the
+  * CJK extensions, get three-byte codes, as does the rest of the BMP.
+  * Anything else is four bytes long.
   */
-  wchar wc = c->chr;
-  if (wc == 0 || (wc >= 0x20 && wc < 0x7F))
+  xchar xc = c->chr;
+  if (xc == 0 || (xc >= 0x20 && xc < 0x7F))
     ;
+  else if (xc >= 0x10000) {
+    uchar plane = xc >> 16;
+    if (plane < 8)
+      add(buf, 0x17 + plane);
+    else {
+      add(buf, 0x1F);
+      add(buf, plane);
+    }
+    add(buf, xc >> 8);
+  }
   else {
-    uchar b = wc >> 8;
+    uchar b = xc >> 8;
     if (b < 0x80)
       b += 0x80;
     else if (b < 0x97)
       b -= 0x7F;
-    else if (b >= 0xD8 && b < 0xE0)
-      b -= 0xC0;
     else
       add(buf, 0x7F);
     add(buf, b);
   }
-  add(buf, wc);
+  add(buf, xc);
 }
 
 static void
@@ -277,10 +347,9 @@ makeliteral_cc(struct buf *b, termchar *c)
   */
   termchar z;
 
-  while (c->cc_next) {
-    c += c->cc_next;
-    assert(c->chr != 0);
-    makeliteral_chr(b, c);
+  for (const xchar *cc = cc_chars(c->cc); *cc; cc++) {
+    z.chr = *cc;
+    makeliteral_chr(b, &z);
   }
 
   z.chr = 0;
@@ -293,13 +362,16 @@ readliteral_chr(struct buf *buf, termchar *c, termline *unused(line))
   uchar b = get(buf);
   if (b == 0 || (b >= 0x20 && b < 0x7F))
     c->chr = b;
+  else if (b >= 0x18 && b < 0x20) {
+    xchar plane = b < 0x1F ? b - 0x17 : get(buf);
+    xchar hi = get(buf);
+    c->chr = plane << 16 | hi << 8 | get(buf);
+  }
   else {
     if (b >= 0x80)
       b -= 0x80;
     else if (b < 0x18)
       b += 0x7F;
-    else if (b < 0x20)
-      b += 0xC0;
     else
       b = get(buf);
     c->chr = b << 8 | get(buf);
@@ -341,16 +413,19 @@ static void
 readliteral_cc(struct buf *b, termchar *c, termline *line)
 {
   termchar n;
-  int x = c - line->chars;
-
-  c->cc_next = 0;
+  xchar seq[CC_MAX + 1];
+  uint len = 0;
 
   while (1) {
     readliteral_chr(b, &n, line);
     if (!n.chr)
       break;
-    add_cc(line, x, n.chr);
+    if (len < CC_MAX)
+      seq[len++] = n.chr;
   }
+  seq[len] = 0;
+
+  c->cc = len ? cc_intern(b->ccs, seq) : 0;
 }
 
 static void
@@ -489,9 +564,10 @@ makerle(struct buf *b, termline *line,
 
 
 uchar *
-compressline(termline *line)
+compressline(termline *line, int *bytes_used)
 {
-  struct buf buffer = { null, 0, 0 }, *b = &buffer;
+  long long start = count_start();
+  struct buf buffer = { null, 0, 0, null }, *b = &buffer;
 
  /*
   * First, store the column count, 7 bits at a time, least
@@ -539,6 +615,11 @@ compressline(termline *line)
  /*
   * Trim the allocated memory so we don't waste any, and return.
   */
+  count(CNT_COMPRESS, 1);
+  count(CNT_ALLOC, 1);
+  count_time(CNT_COMPRESS_TIME, start);
+  if (bytes_used)
+    *bytes_used = b->len;
   return renewn(b->data, b->len);
 }
 
@@ -577,8 +658,8 @@ readrle(struct buf *b, termline *line,
   assert(n == line->cols);
 }
 
-termline *
-decompressline(uchar *data, int *bytes_used)
+static termline *
+decompress(uchar *data, int *bytes_used, cc_pool *ccs)
 {
   int ncols, byte, shift;
   struct buf buffer, *b = &buffer;
@@ -586,6 +667,7 @@ decompressline(uchar *data, int *bytes_used)
 
   b->data = data;
   b->len = 0;
+  b->ccs = ccs;
 
  /*
   * First read in the column count.
@@ -602,21 +684,8 @@ decompressline(uchar *data, int *bytes_used)
   */
   line = new(termline);
   line->chars = newn(termchar, ncols);
-  line->cols = line->size = ncols;
+  line->cols = ncols;
   line->temporary = true;
-  line->cc_free = 0;
-
- /*
-  * We must set all the cc pointers in line->chars to 0 right
-  * now, so that cc diagnostics that verify the integrity of the
-  * whole line will make sense while we're in the middle of
-  * building it up.
-  */
-  {
-    int i;
-    for (i = 0; i < line->cols; i++)
-      line->chars[i].cc_next = 0;
-  }
 
  /*
   * Now read in the line attributes.
@@ -642,6 +711,28 @@ decompressline(uchar *data, int *bytes_used)
   return line;
 }
 
+termline *
+decompressline(uchar *data, int *bytes_used)
+{
+  long long start = count_start();
+  termline *line = decompress(data, bytes_used, &term->ccs);
+  count(CNT_DECOMPRESS, 1);
+  count(CNT_ALLOC, 1);
+  count_time(CNT_DECOMPRESS_TIME, start);
+  return line;
+}
+
+/*
+ * Decompress a line with its combining characters going into the given
+ * pool instead of the terminal's. This doesn't touch any terminal state,
+ * so it can be used on other threads.
+ */
+termline *
+decompressline_pool(uchar *data, cc_pool *ccs)
+{
+  return decompress(data, null, ccs);
+}
+
 /*
  * Clear a line, throwing away any combining characters.
  */
@@ -650,12 +741,7 @@ clearline(termline *line)
 {
   line->attr = LATTR_NORM;
   for (int j = 0; j < line->cols; j++)
-    line->chars[j] = term.erase_char;
-  if (line->size > line->cols) {
-    line->size = line->cols;
-    line->chars = renewn(line->chars, line->size);
-    line->cc_free = 0;
-  }
+    line->chars[j] = term->erase_char;
 }
 
 /*
@@ -667,37 +753,8 @@ resizeline(termline *line, int cols)
   int oldcols = line->cols;
 
   if (cols > oldcols) {
-
-   /*
-    * Leave the same amount of cc space as there was to begin with.
-    */
-    line->size += cols - oldcols;
-    line->chars = renewn(line->chars, line->size);
+    line->chars = renewn(line->chars, cols);
     line->cols = cols;
-
-   /*
-    * Move the cc section.
-    */
-    memmove(line->chars + cols, line->chars + oldcols,
-            (line->size - cols) * sizeof(termchar));
-
-   /*
-    * Adjust the first cc_next pointer in each list. (All the
-    * subsequent ones are still valid because they are
-    * relative offsets within the cc block.) Also do the same
-    * to the head of the cc_free list.
-    */
-    for (int i = 0; i < oldcols; i++)
-      if (line->chars[i].cc_next)
-        line->chars[i].cc_next += cols - oldcols;
-    if (line->cc_free)
-      line->cc_free += cols - oldcols;
-
-   /*
-    * And finally fill in the new space with erase chars. (We
-    * don't have to worry about cc lists here, because we
-    * _know_ the erase char doesn't have one.)
-    */
     for (int i = oldcols; i < cols; i++)
       line->chars[i] = basic_erase_char;
   }
@@ -709,38 +766,64 @@ resizeline(termline *line, int cols)
 int
 sblines(void)
 {
-  return term.on_alt_screen ^ term.show_other_screen ? 0 : term.sblines;
+  if (term->frozen.on)
+    return term->frozen.sblines;
+  return term->on_alt_screen ^ term->show_other_screen ? 0 : term->sblines;
 }
 
 /*
  * Retrieve a line of the screen or of the scrollback, according to
  * whether the y coordinate is non-negative or negative
- * (respectively).
+ * (respectively). While the view is frozen, lines come from the frozen
+ * copy instead.
  */
 termline *
 fetch_line(int y)
 {
-  termlines *lines = term.show_other_screen ? term.other_lines : term.lines;
+  termlines *lines =
+    term->frozen.on ? term->frozen.lines :
+    term->show_other_screen ? term->other_lines : term->lines;
 
   termline *line;
   if (y >= 0) {
-    assert(y < term.rows);
+    assert(y < term->rows);
     line = lines[y];
   }
   else {
-    assert(y < term.sblines);
-    y += term.sbpos;
-    if (y < 0)
-      y += term.sblen; // Scrollback has wrapped round
-    uchar *cline = term.scrollback[y];
-    line = decompressline(cline, null);
-    resizeline(line, term.cols);
+    line = decompressline(fetch_compressed_line(y), null);
+    resizeline(line, term->cols);
   }
 
   assert(line);
   return line;
 }
 
+/*
+ * Retrieve a line in compressed form. Screen lines are compressed afresh
+ * and belong to the caller, whereas scrollback lines are returned as
+ * stored, so they can only be kept while the scrollback is retained.
+ */
+uchar *
+fetch_compressed_line(int y)
+{
+  if (y >= 0) {
+    termlines *lines =
+      term->frozen.on ? term->frozen.lines :
+      term->show_other_screen ? term->other_lines : term->lines;
+    assert(y < term->rows);
+    return compressline(lines[y], null);
+  }
+  if (term->frozen.on) {
+    assert(-y <= term->frozen.sblines);
+    return term->frozen.sb[term->frozen.sblines + y];
+  }
+  assert(-y <= term->sblines);
+  y += term->sbpos;
+  if (y < 0)
+    y += term->sblen; // Scrollback has wrapped round
+  return term->scrollback[y];
+}
+
 /* Release a screen or scrollback line */
 void
 release_line(termline *line)
@@ -761,20 +844,20 @@ term_bidi_cache_hit(int line, termchar *lbefore, int width)
 {
   int i;
 
-  if (!term.pre_bidi_cache)
+  if (!term->pre_bidi_cache)
     return false;       /* cache doesn't even exist yet! */
 
-  if (line >= term.bidi_cache_size)
+  if (line >= term->bidi_cache_size)
     return false;       /* cache doesn't have this many lines */
 
-  if (!term.pre_bidi_cache[line].chars)
+  if (!term->pre_bidi_cache[line].chars)
     return false;       /* cache doesn't contain _this_ line */
 
-  if (term.pre_bidi_cache[line].width != width)
+  if (term->pre_bidi_cache[line].width != width)
     return false;       /* line is wrong width */
 
   for (i = 0; i < width; i++)
-    if (!termchars_equal(term.pre_bidi_cache[line].chars + i, lbefore + i))
+    if (!termchars_equal(term->pre_bidi_cache[line].chars + i, lbefore + i))
       return false;     /* line doesn't match cache */
 
   return true;  /* it didn't match. */
@@ -782,48 +865,48 @@ term_bidi_cache_hit(int line, termchar *lbefore, int width)
 
 static void
 term_bidi_cache_store(int line, termchar *lbefore, termchar *lafter,
-                      bidi_char *wcTo, int width, int size)
+                      bidi_char *wcTo, int width)
 {
   int i;
 
-  if (!term.pre_bidi_cache || term.bidi_cache_size <= line) {
-    int j = term.bidi_cache_size;
-    term.bidi_cache_size = line + 1;
-    term.pre_bidi_cache = renewn(term.pre_bidi_cache, term.bidi_cache_size);
-    term.post_bidi_cache = renewn(term.post_bidi_cache, term.bidi_cache_size);
-    while (j < term.bidi_cache_size) {
-      term.pre_bidi_cache[j].chars = term.post_bidi_cache[j].chars = null;
-      term.pre_bidi_cache[j].width = term.post_bidi_cache[j].width = -1;
-      term.pre_bidi_cache[j].forward = term.post_bidi_cache[j].forward = null;
-      term.pre_bidi_cache[j].backward = term.post_bidi_cache[j].backward = null;
+  if (!term->pre_bidi_cache || term->bidi_cache_size <= line) {
+    int j = term->bidi_cache_size;
+    term->bidi_cache_size = line + 1;
+    term->pre_bidi_cache = renewn(term->pre_bidi_cache, term->bidi_cache_size);
+    term->post_bidi_cache = renewn(term->post_bidi_cache, term->bidi_cache_size);
+    while (j < term->bidi_cache_size) {
+      term->pre_bidi_cache[j].chars = term->post_bidi_cache[j].chars = null;
+      term->pre_bidi_cache[j].width = term->post_bidi_cache[j].width = -1;
+      term->pre_bidi_cache[j].forward = term->post_bidi_cache[j].forward = null;
+      term->pre_bidi_cache[j].backward = term->post_bidi_cache[j].backward = null;
       j++;
     }
   }
 
-  free(term.pre_bidi_cache[line].chars);
-  free(term.post_bidi_cache[line].chars);
-  free(term.post_bidi_cache[line].forward);
-  free(term.post_bidi_cache[line].backward);
+  free(term->pre_bidi_cache[line].chars);
+  free(term->post_bidi_cache[line].chars);
+  free(term->post_bidi_cache[line].forward);
+  free(term->post_bidi_cache[line].backward);
 
-  term.pre_bidi_cache[line].width = width;
-  term.pre_bidi_cache[line].chars = newn(termchar, size);
-  term.post_bidi_cache[line].width = width;
-  term.post_bidi_cache[line].chars = newn(termchar, size);
-  term.post_bidi_cache[line].forward = newn(int, width);
-  term.post_bidi_cache[line].backward = newn(int, width);
+  term->pre_bidi_cache[line].width = width;
+  term->pre_bidi_cache[line].chars = newn(termchar, width);
+  term->post_bidi_cache[line].width = width;
+  term->post_bidi_cache[line].chars = newn(termchar, width);
+  term->post_bidi_cache[line].forward = newn(int, width);
+  term->post_bidi_cache[line].backward = newn(int, width);
 
-  memcpy(term.pre_bidi_cache[line].chars, lbefore, size * sizeof(termchar));
-  memcpy(term.post_bidi_cache[line].chars, lafter, size * sizeof(termchar));
-  memset(term.post_bidi_cache[line].forward, 0, width * sizeof (int));
-  memset(term.post_bidi_cache[line].backward, 0, width * sizeof (int));
+  memcpy(term->pre_bidi_cache[line].chars, lbefore, width * sizeof(termchar));
+  memcpy(term->post_bidi_cache[line].chars, lafter, width * sizeof(termchar));
+  memset(term->post_bidi_cache[line].forward, 0, width * sizeof (int));
+  memset(term->post_bidi_cache[line].backward, 0, width * sizeof (int));
 
   for (i = 0; i < width; i++) {
     int p = wcTo[i].index;
 
     assert(0 <= p && p < width);
 
-    term.post_bidi_cache[line].backward[i] = p;
-    term.post_bidi_cache[line].forward[p] = i;
+    term->post_bidi_cache[line].backward[i] = p;
+    term->post_bidi_cache[line].forward[p] = i;
   }
 }
 
@@ -833,7 +916,7 @@ term_bidi_cache_store(int line, termchar *lbefore, termchar *lafter,
  * all took place (because bidi is disabled). If return was
  * non-null, auxiliary information such as the forward and reverse
  * mappings of permutation position are available in
- * term.post_bidi_cache[scr_y].*.
+ * term->post_bidi_cache[scr_y].*.
  */
 termchar *
 term_bidi_line(termline *line, int scr_y)
@@ -843,45 +926,46 @@ term_bidi_line(termline *line, int scr_y)
 
  /* Do Arabic shaping and bidi. */
 
-  if (!term_bidi_cache_hit(scr_y, line->chars, term.cols)) {
+  bool hit = term_bidi_cache_hit(scr_y, line->chars, term->cols);
+  count(hit ? CNT_BIDI_HIT : CNT_BIDI_MISS, 1);
+  if (!hit) {
 
-    if (term.wcFromTo_size < term.cols) {
-      term.wcFromTo_size = term.cols;
-      term.wcFrom = renewn(term.wcFrom, term.wcFromTo_size);
-      term.wcTo = renewn(term.wcTo, term.wcFromTo_size);
+    if (term->wcFromTo_size < term->cols) {
+      term->wcFromTo_size = term->cols;
+      term->wcFrom = renewn(term->wcFrom, term->wcFromTo_size);
+      term->wcTo = renewn(term->wcTo, term->wcFromTo_size);
     }
 
-    for (it = 0; it < term.cols; it++) {
-      wchar c = line->chars[it].chr;
-      term.wcFrom[it].origwc = term.wcFrom[it].wc = c;
-      term.wcFrom[it].index = it;
+    for (it = 0; it < term->cols; it++) {
+     /* The bidi tables only cover the BMP, so treat anything beyond
+      * that as a neutral character. */
+      xchar xc = line->chars[it].chr;
+      wchar c = xc < 0x10000 ? xc : 0xFFFD;
+      term->wcFrom[it].origwc = term->wcFrom[it].wc = c;
+      term->wcFrom[it].index = it;
     }
 
-    do_bidi(term.wcFrom, term.cols);
-    do_shape(term.wcFrom, term.wcTo, term.cols);
+    do_bidi(term->wcFrom, term->cols);
+    do_shape(term->wcFrom, term->wcTo, term->cols);
 
-    if (term.ltemp_size < line->size) {
-      term.ltemp_size = line->size;
-      term.ltemp = renewn(term.ltemp, term.ltemp_size);
+    if (term->ltemp_size < term->cols) {
+      term->ltemp_size = term->cols;
+      term->ltemp = renewn(term->ltemp, term->ltemp_size);
     }
 
-    memcpy(term.ltemp, line->chars, line->size * sizeof(termchar));
-
-    for (it = 0; it < term.cols; it++) {
-      term.ltemp[it] = line->chars[term.wcTo[it].index];
-      if (term.ltemp[it].cc_next)
-        term.ltemp[it].cc_next -= it - term.wcTo[it].index;
+    for (it = 0; it < term->cols; it++) {
+      term->ltemp[it] = line->chars[term->wcTo[it].index];
 
-      if (term.wcTo[it].origwc != term.wcTo[it].wc)
-        term.ltemp[it].chr = term.wcTo[it].wc;
+      if (term->wcTo[it].origwc != term->wcTo[it].wc)
+        term->ltemp[it].chr = term->wcTo[it].wc;
     }
-    term_bidi_cache_store(scr_y, line->chars, term.ltemp, term.wcTo,
-                          term.cols, line->size);
+    term_bidi_cache_store(scr_y, line->chars, term->ltemp, term->wcTo,
+                          term->cols);
 
-    lchars = term.ltemp;
+    lchars = term->ltemp;
   }
   else {
-    lchars = term.post_bidi_cache[scr_y].chars;
+    lchars = term->post_bidi_cache[scr_y].chars;
   }
 
   return lchars;
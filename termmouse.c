@@ -13,10 +13,10 @@
  * character we find is UCSWIDE, then we must look one space further
  * to the left.
  */
-static wchar
+static xchar
 get_char(termline *line, int x)
 {
-  wchar c = line->chars[x].chr;
+  xchar c = line->chars[x].chr;
   if (c == UCSWIDE && x > 0)
     c = line->chars[x - 1].chr;
   return c;
@@ -29,10 +29,10 @@ sel_spread_word(pos p, bool forward)
   termline *line = fetch_line(p.y);
   
   for (;;) {
-    wchar c = get_char(line, p.x);
+    xchar c = get_char(line, p.x);
     if (iswalnum(c))
       ret_p = p;
-    else if (term.mouse_state != MS_OPENING && *cfg.word_chars) {
+    else if (term->mouse_state != MS_OPENING && *cfg.word_chars) {
       if (!strchr(cfg.word_chars, c))
         break;
       ret_p = p;
@@ -48,7 +48,7 @@ sel_spread_word(pos p, bool forward)
 
     if (forward) {
       p.x++;
-      if (p.x >= term.cols - ((line->attr & LATTR_WRAPPED2) != 0)) {
+      if (p.x >= term->cols - ((line->attr & LATTR_WRAPPED2) != 0)) {
         if (!(line->attr & LATTR_WRAPPED))
           break;
         p.x = 0;
@@ -64,7 +64,7 @@ sel_spread_word(pos p, bool forward)
         line = fetch_line(--p.y);
         if (!(line->attr & LATTR_WRAPPED))
           break;
-        p.x = term.cols - ((line->attr & LATTR_WRAPPED2) != 0);
+        p.x = term->cols - ((line->attr & LATTR_WRAPPED2) != 0);
       }
       p.x--;
     }
@@ -80,7 +80,7 @@ sel_spread_word(pos p, bool forward)
 static pos
 sel_spread_half(pos p, bool forward)
 {
-  switch (term.mouse_state) {
+  switch (term->mouse_state) {
     when MS_SEL_CHAR: {
      /*
       * In this mode, every character is a separate unit, except
@@ -88,13 +88,13 @@ sel_spread_half(pos p, bool forward)
       */
       termline *line = fetch_line(p.y);
       if (!(line->attr & LATTR_WRAPPED)) {
-        termchar *q = line->chars + term.cols;
-        while (q > line->chars && q[-1].chr == ' ' && !q[-1].cc_next)
+        termchar *q = line->chars + term->cols;
+        while (q > line->chars && q[-1].chr == ' ' && !q[-1].cc)
           q--;
-        if (q == line->chars + term.cols)
+        if (q == line->chars + term->cols)
           q--;
         if (p.x >= q - line->chars)
-          p.x = forward ? term.cols - 1 : q - line->chars;
+          p.x = forward ? term->cols - 1 : q - line->chars;
       }
       release_line(line);
     }
@@ -109,7 +109,7 @@ sel_spread_half(pos p, bool forward)
           p.x = 0;
         }
         int x = p.x;
-        p.x = term.cols - 1;
+        p.x = term->cols - 1;
         do {
           if (get_char(line, x) != ' ')
             p.x = x;
@@ -137,27 +137,27 @@ sel_spread_half(pos p, bool forward)
 static void
 sel_spread(void)
 {
-  term.sel_start = sel_spread_half(term.sel_start, false);
-  term.sel_end = sel_spread_half(term.sel_end, true);
-  incpos(term.sel_end);
+  term->sel_start = sel_spread_half(term->sel_start, false);
+  term->sel_end = sel_spread_half(term->sel_end, true);
+  incpos(term->sel_end);
 }
 
 static void
 sel_drag(pos selpoint)
 {
-  term.selected = true;
-  if (!term.sel_rect) {
+  term->selected = true;
+  if (!term->sel_rect) {
    /*
     * For normal selection, we set (sel_start,sel_end) to
     * (selpoint,sel_anchor) in some order.
     */
-    if (poslt(selpoint, term.sel_anchor)) {
-      term.sel_start = selpoint;
-      term.sel_end = term.sel_anchor;
+    if (poslt(selpoint, term->sel_anchor)) {
+      term->sel_start = selpoint;
+      term->sel_end = term->sel_anchor;
     }
     else {
-      term.sel_start = term.sel_anchor;
-      term.sel_end = selpoint;
+      term->sel_start = term->sel_anchor;
+      term->sel_end = selpoint;
     }
     sel_spread();
   }
@@ -167,30 +167,30 @@ sel_drag(pos selpoint)
     * interchange x and y coordinates (if the user has
     * dragged in the -x and +y directions, or vice versa).
     */
-    term.sel_start.x = min(term.sel_anchor.x, selpoint.x);
-    term.sel_end.x = 1 + max(term.sel_anchor.x, selpoint.x);
-    term.sel_start.y = min(term.sel_anchor.y, selpoint.y);
-    term.sel_end.y = max(term.sel_anchor.y, selpoint.y);
+    term->sel_start.x = min(term->sel_anchor.x, selpoint.x);
+    term->sel_end.x = 1 + max(term->sel_anchor.x, selpoint.x);
+    term->sel_start.y = min(term->sel_anchor.y, selpoint.y);
+    term->sel_end.y = max(term->sel_anchor.y, selpoint.y);
   }
 }
 
 static void
 sel_extend(pos selpoint)
 {
-  if (term.selected) {
-    if (!term.sel_rect) {
+  if (term->selected) {
+    if (!term->sel_rect) {
      /*
       * For normal selection, we extend by moving
       * whichever end of the current selection is closer
       * to the mouse.
       */
-      if (posdiff(selpoint, term.sel_start) <
-          posdiff(term.sel_end, term.sel_start) / 2) {
-        term.sel_anchor = term.sel_end;
-        decpos(term.sel_anchor);
+      if (posdiff(selpoint, term->sel_start) <
+          posdiff(term->sel_end, term->sel_start) / 2) {
+        term->sel_anchor = term->sel_end;
+        decpos(term->sel_anchor);
       }
       else
-        term.sel_anchor = term.sel_start;
+        term->sel_anchor = term->sel_start;
     }
     else {
      /*
@@ -198,18 +198,18 @@ sel_extend(pos selpoint)
       * _four_ places to put sel_anchor and selpoint: the
       * four corners of the selection.
       */
-      term.sel_anchor.x = 
-        selpoint.x * 2 < term.sel_start.x + term.sel_end.x
-        ? term.sel_end.x - 1
-        : term.sel_start.x;
-      term.sel_anchor.y = 
-        selpoint.y * 2 < term.sel_start.y + term.sel_end.y
-        ? term.sel_end.y
-        : term.sel_start.y;
+      term->sel_anchor.x = 
+        selpoint.x * 2 < term->sel_start.x + term->sel_end.x
+        ? term->sel_end.x - 1
+        : term->sel_start.x;
+      term->sel_anchor.y = 
+        selpoint.y * 2 < term->sel_start.y + term->sel_end.y
+        ? term->sel_end.y
+        : term->sel_start.y;
     }
   }
   else
-    term.sel_anchor = selpoint;
+    term->sel_anchor = selpoint;
   sel_drag(selpoint);
 }
 
@@ -220,23 +220,39 @@ typedef enum {
   MA_RELEASE = 3
 } mouse_action;
 
+/*
+ * Motion reports are sent only when the mouse has moved to a different
+ * cell, and no more often than cfg.mouse_motion_rate times a second.
+ * A report that can't be sent yet is held back, and replaced if the
+ * mouse moves on. Other mouse events send it first to preserve ordering.
+ */
 static void
 send_mouse_event(mouse_action a, mouse_button b, mod_keys mods, pos p)
 {
+  if (a != MA_MOVE && term->motion.pending) {
+    term->motion.pending = false;
+    if (term->mouse_mode >= MM_BTN_EVENT)
+      send_mouse_event(MA_MOVE, term->motion.b, term->motion.mods, term->motion.p);
+  }
+  if (a == MA_MOVE)
+    term->motion.tick = get_tick_count();
+  term->motion.last_b = b;
+  term->motion.last_p = p;
+
   uint x = p.x + 1, y = p.y + 1;
   
   uint code = b ? b - 1 : 0x3;
   
   if (a != MA_RELEASE)
     code |= a * 0x20;
-  else if (term.mouse_enc != ME_XTERM_CSI)
+  else if (term->mouse_enc != ME_XTERM_CSI)
     code = 0x3;
   
   code |= (mods & ~cfg.click_target_mod) * 0x4;
   
-  if (term.mouse_enc == ME_XTERM_CSI)
+  if (term->mouse_enc == ME_XTERM_CSI)
     child_printf("\e[<%u;%u;%u%c", code, x, y, (a == MA_RELEASE ? 'm' : 'M'));
-  else if (term.mouse_enc == ME_URXVT_CSI)
+  else if (term->mouse_enc == ME_URXVT_CSI)
     child_printf("\e[%u;%u;%uM", code + 0x20, x, y);
   else {
     // Xterm's hacky but traditional character offset approach.
@@ -245,7 +261,7 @@ send_mouse_event(mouse_action a, mouse_button b, mod_keys mods, pos p)
     
     void encode_coord(uint c) {
       c += 0x20;
-      if (term.mouse_enc != ME_UTF8)
+      if (term->mouse_enc != ME_UTF8)
         buf[len++] = c < 0x100 ? c : 0; 
       else if (c < 0x80)
         buf[len++] = c;
@@ -269,18 +285,52 @@ send_mouse_event(mouse_action a, mouse_button b, mod_keys mods, pos p)
   }
 }
 
+static void
+motion_cb(void)
+{
+  if (term->motion.pending) {
+    term->motion.pending = false;
+    if (term->mouse_mode >= MM_BTN_EVENT)
+      send_mouse_event(MA_MOVE, term->motion.b, term->motion.mods, term->motion.p);
+  }
+}
+
+static void
+send_motion(mouse_button b, mod_keys mods, pos p)
+{
+  if (b == term->motion.last_b && p.x == term->motion.last_p.x && p.y == term->motion.last_p.y) {
+    // Back where the last report was, so nothing to send.
+    term->motion.pending = false;
+    return;
+  }
+  int rate = cfg.mouse_motion_rate;
+  int wait = rate > 0 ? term->motion.tick + 1000 / rate - get_tick_count() : 0;
+  if (wait <= 0) {
+    term->motion.pending = false;
+    send_mouse_event(MA_MOVE, b, mods, p);
+  }
+  else {
+    if (!term->motion.pending)
+      win_set_timer(motion_cb, wait);
+    term->motion.pending = true;
+    term->motion.b = b;
+    term->motion.mods = mods;
+    term->motion.p = p;
+  }
+}
+
 static pos
 box_pos(pos p)
 {
-  p.y = min(max(0, p.y), term.rows - 1);
-  p.x = min(max(0, p.x), term.cols - 1);
+  p.y = min(max(0, p.y), term->rows - 1);
+  p.x = min(max(0, p.x), term->cols - 1);
   return p;
 }
 
 static pos
 get_selpoint(const pos p)
 {
-  pos sp = { .y = p.y + term.disptop, .x = p.x };
+  pos sp = { .y = p.y + term->disptop, .x = p.x };
   termline *line = fetch_line(sp.y);
   if ((line->attr & LATTR_MODE) != LATTR_NORM)
     sp.x /= 2;
@@ -290,7 +340,7 @@ get_selpoint(const pos p)
   * click point from the physical one.
   */
   if (term_bidi_line(line, p.y) != null)
-    sp.x = term.post_bidi_cache[p.y].backward[sp.x];
+    sp.x = term->post_bidi_cache[p.y].backward[sp.x];
   
   // Back to previous cell if current one is second half of a wide char
   if (line->chars[sp.x].chr == UCSWIDE)
@@ -314,7 +364,7 @@ send_keys(char *code, uint len, uint count)
 static bool
 is_app_mouse(mod_keys *mods_p)
 {
-  if (!term.mouse_mode || term.show_other_screen)
+  if (!term->mouse_mode || term->show_other_screen)
     return false;
   bool override = *mods_p & cfg.click_target_mod;
   *mods_p &= ~cfg.click_target_mod;
@@ -325,52 +375,52 @@ void
 term_mouse_click(mouse_button b, mod_keys mods, pos p, int count)
 {
   if (is_app_mouse(&mods)) {
-    if (term.mouse_mode == MM_X10)
+    if (term->mouse_mode == MM_X10)
       mods = 0;
     send_mouse_event(MA_CLICK, b, mods, box_pos(p));
-    term.mouse_state = b;
+    term->mouse_state = b;
   }
   else {  
     bool alt = mods & MDK_ALT;
     bool shift_or_ctrl = mods & (MDK_SHIFT | MDK_CTRL);
     int rca = cfg.right_click_action;
-    term.mouse_state = 0;
+    term->mouse_state = 0;
     if (b == MBT_RIGHT && (rca == RC_MENU || shift_or_ctrl)) {
       if (!alt) 
         win_popup_menu();
     }
     else if (b == ((rca == RC_PASTE) ? MBT_RIGHT : MBT_MIDDLE)) {
       if (!alt)
-        term.mouse_state = shift_or_ctrl ? MS_COPYING : MS_PASTING;
+        term->mouse_state = shift_or_ctrl ? MS_COPYING : MS_PASTING;
     }
     else if (b == MBT_LEFT && mods == MDK_SHIFT && rca == RC_EXTEND)
-      term.mouse_state = MS_PASTING;
+      term->mouse_state = MS_PASTING;
     else if (b == MBT_LEFT && mods == MDK_CTRL) {
       // Open word under cursor
       p = get_selpoint(box_pos(p));
-      term.mouse_state = MS_OPENING;
-      term.selected = true;
-      term.sel_rect = false;
-      term.sel_start = term.sel_end = term.sel_anchor = p;
+      term->mouse_state = MS_OPENING;
+      term->selected = true;
+      term->sel_rect = false;
+      term->sel_start = term->sel_end = term->sel_anchor = p;
       sel_spread();
       win_update();
     }
     else {
       // Only clicks for selecting and extending should get here.
       p = get_selpoint(box_pos(p));
-      term.mouse_state = -count;
-      term.sel_rect = alt;
+      term->mouse_state = -count;
+      term->sel_rect = alt;
       if (b != MBT_LEFT || shift_or_ctrl)
         sel_extend(p);
       else if (count == 1) {
-        term.selected = false;
-        term.sel_anchor = p;
+        term->selected = false;
+        term->sel_anchor = p;
       }
       else {
         // Double or triple-click: select whole word or line
-        term.selected = true;
-        term.sel_rect = false;
-        term.sel_start = term.sel_end = term.sel_anchor = p;
+        term->selected = true;
+        term->sel_rect = false;
+        term->sel_start = term->sel_end = term->sel_anchor = p;
         sel_spread();
       }
       win_capture_mouse();
@@ -382,37 +432,34 @@ term_mouse_click(mouse_button b, mod_keys mods, pos p, int count)
 void
 term_mouse_release(mouse_button b, mod_keys mods, pos p)
 {
-  int state = term.mouse_state;
-  term.mouse_state = 0;
+  int state = term->mouse_state;
+  term->mouse_state = 0;
   switch (state) {
     when MS_COPYING: term_copy();
     when MS_PASTING: win_paste();
     when MS_OPENING:
       term_open();
-      term.selected = false;
+      term->selected = false;
       win_update();
     when MS_SEL_CHAR or MS_SEL_WORD or MS_SEL_LINE: {
       // Finish selection.
-      if (term.selected && cfg.copy_on_select)
+      if (term->selected && cfg.copy_on_select)
         term_copy();
       
-      // Flush any output held back during selection.
-      term_flush();
+      // Catch up with any output processed during selection.
+      term_thaw();
       
       // "Clicks place cursor" implementation.
-      if (!cfg.clicks_place_cursor || term.on_alt_screen || term.app_cursor_keys)
+      if (!cfg.clicks_place_cursor || term->on_alt_screen || term->app_cursor_keys)
         return;
       
-      pos dest = term.selected ? term.sel_end : get_selpoint(box_pos(p));
-      
-      static bool moved_previously;
-      static pos last_dest;
+      pos dest = term->selected ? term->sel_end : get_selpoint(box_pos(p));
       
       pos orig;
       if (state == MS_SEL_CHAR)
-        orig = (pos){.y = term.curs.y, .x = term.curs.x};
-      else if (moved_previously)
-        orig = last_dest;
+        orig = (pos){.y = term->curs.y, .x = term->curs.x};
+      else if (term->click_moved)
+        orig = term->click_dest;
       else
         return;
       
@@ -425,10 +472,10 @@ term_mouse_release(mouse_button b, mod_keys mods, pos p)
         termline *line = fetch_line(p.y);
         if (!(line->attr & LATTR_WRAPPED)) {
           release_line(line);
-          moved_previously = false;
+          term->click_moved = false;
           return;
         }
-        int cols = term.cols - ((line->attr & LATTR_WRAPPED2) != 0);
+        int cols = term->cols - ((line->attr & LATTR_WRAPPED2) != 0);
         for (int x = p.x; x < cols; x++) {
           if (line->chars[x].chr != UCSWIDE)
             count++;
@@ -445,16 +492,16 @@ term_mouse_release(mouse_button b, mod_keys mods, pos p)
       release_line(line);
       
       char code[3] = 
-        {'\e', term.app_cursor_keys ? 'O' : '[', forward ? 'C' : 'D'};
+        {'\e', term->app_cursor_keys ? 'O' : '[', forward ? 'C' : 'D'};
 
       send_keys(code, 3, count);
       
-      moved_previously = true;
-      last_dest = dest;
+      term->click_moved = true;
+      term->click_dest = dest;
     }
     default:
       if (is_app_mouse(&mods)) {
-        if (term.mouse_mode >= MM_VT200)
+        if (term->mouse_mode >= MM_VT200)
           send_mouse_event(MA_RELEASE, b, mods, box_pos(p));
       }
   }
@@ -463,9 +510,9 @@ term_mouse_release(mouse_button b, mod_keys mods, pos p)
 static void
 sel_scroll_cb(void)
 {
-  if (term_selecting() && term.sel_scroll) {
-    term_scroll(0, term.sel_scroll);
-    sel_drag(get_selpoint(term.sel_pos));
+  if (term_selecting() && term->sel_scroll) {
+    term_scroll(0, term->sel_scroll);
+    sel_drag(get_selpoint(term->sel_pos));
     win_update();
     win_set_timer(sel_scroll_cb, 125);
   }
@@ -476,32 +523,32 @@ term_mouse_move(mod_keys mods, pos p)
 {
   pos bp = box_pos(p);
   if (term_selecting()) {
-    if (p.y < 0 || p.y >= term.rows) {
-      if (!term.sel_scroll) 
+    if (p.y < 0 || p.y >= term->rows) {
+      if (!term->sel_scroll) 
         win_set_timer(sel_scroll_cb, 200);
-      term.sel_scroll = p.y < 0 ? p.y : p.y - term.rows + 1;
-      term.sel_pos = bp;
+      term->sel_scroll = p.y < 0 ? p.y : p.y - term->rows + 1;
+      term->sel_pos = bp;
     }
     else   { 
-      term.sel_scroll = 0;
-      if (p.x < 0 && p.y + term.disptop > term.sel_anchor.y)
-        bp = (pos){.y = p.y - 1, .x = term.cols - 1};
+      term->sel_scroll = 0;
+      if (p.x < 0 && p.y + term->disptop > term->sel_anchor.y)
+        bp = (pos){.y = p.y - 1, .x = term->cols - 1};
     }
     sel_drag(get_selpoint(bp));
-    win_update();
+    win_update_overlays();
   }
-  else if (term.mouse_state == MS_OPENING) {
-    term.mouse_state = 0;
-    term.selected = false;
-    win_update();
+  else if (term->mouse_state == MS_OPENING) {
+    term->mouse_state = 0;
+    term->selected = false;
+    win_update_overlays();
   }
-  else if (term.mouse_state > 0) {
-    if (term.mouse_mode >= MM_BTN_EVENT)
-      send_mouse_event(MA_MOVE, term.mouse_state, mods, bp);
+  else if (term->mouse_state > 0) {
+    if (term->mouse_mode >= MM_BTN_EVENT)
+      send_motion(term->mouse_state, mods, bp);
   }
   else {
-    if (term.mouse_mode == MM_ANY_EVENT)
-      send_mouse_event(MA_MOVE, 0, mods, bp);
+    if (term->mouse_mode == MM_ANY_EVENT)
+      send_motion(0, mods, bp);
   }
 }
 
@@ -510,51 +557,50 @@ term_mouse_wheel(int delta, int lines_per_notch, mod_keys mods, pos p)
 {
   enum { NOTCH_DELTA = 120 };
   
-  static int accu;
-  accu += delta;
+  term->wheel_accu += delta;
   
   if (is_app_mouse(&mods)) {
     // Send as mouse events, with one event per notch.
-    int notches = accu / NOTCH_DELTA;
+    int notches = term->wheel_accu / NOTCH_DELTA;
     if (notches) {
-      accu -= NOTCH_DELTA * notches;
+      term->wheel_accu -= NOTCH_DELTA * notches;
       mouse_button b = (notches < 0) + 1;
       notches = abs(notches);
       do send_mouse_event(MA_WHEEL, b, mods, p); while (--notches);
     }
   }
   else if (mods == MDK_CTRL) {
-    int zoom = accu / NOTCH_DELTA;
+    int zoom = term->wheel_accu / NOTCH_DELTA;
     if (zoom) {
-      accu -= NOTCH_DELTA * zoom;
+      term->wheel_accu -= NOTCH_DELTA * zoom;
       win_zoom_font(zoom);
     }
   }
   else if (!(mods & ~MDK_SHIFT)) {
     // Scroll, taking the lines_per_notch setting into account.
     // Scroll by a page per notch if setting is -1 or Shift is pressed.
-    int lines_per_page = max(1, term.rows - 1);
+    int lines_per_page = max(1, term->rows - 1);
     if (lines_per_notch == -1 || mods & MDK_SHIFT)
       lines_per_notch = lines_per_page;
-    int lines = lines_per_notch * accu / NOTCH_DELTA;
+    int lines = lines_per_notch * term->wheel_accu / NOTCH_DELTA;
     if (lines) {
-      accu -= lines * NOTCH_DELTA / lines_per_notch;
-      if (!term.on_alt_screen || term.show_other_screen)
+      term->wheel_accu -= lines * NOTCH_DELTA / lines_per_notch;
+      if (!term->on_alt_screen || term->show_other_screen)
         term_scroll(0, -lines);
-      else if (term.wheel_reporting) {
+      else if (term->wheel_reporting) {
         // Send scroll distance as CSI a/b events
         bool up = lines > 0;
         lines = abs(lines);
         int pages = lines / lines_per_page;
         lines -= pages * lines_per_page;
-        if (term.app_wheel) {
+        if (term->app_wheel) {
           send_keys(up ? "\e[1;2a" : "\e[1;2b", 6, pages);
           send_keys(up ? "\eOa" : "\eOb", 3, lines);
         }
         else {
           send_keys(up ? "\e[5~" : "\e[6~", 4, pages);
           char code[3] = 
-            {'\e', term.app_cursor_keys ? 'O' : '[', up ? 'A' : 'B'};
+            {'\e', term->app_cursor_keys ? 'O' : '[', up ? 'A' : 'B'};
           send_keys(code, 3, lines);
         }
       }
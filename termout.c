@@ -10,6 +10,9 @@
 #include "charset.h"
 #include "child.h"
 #include "print.h"
+#include "latency.h"
+#include "counters.h"
+#include "trace.h"
 
 #include <sys/termios.h>
 
@@ -29,21 +32,21 @@ static const char primary_da[] = "\e[?1;2c";
 static void
 move(int x, int y, int marg_clip)
 {
-  term_cursor *curs = &term.curs;
+  term_cursor *curs = &term->curs;
   if (x < 0)
     x = 0;
-  if (x >= term.cols)
-    x = term.cols - 1;
+  if (x >= term->cols)
+    x = term->cols - 1;
   if (marg_clip) {
-    if ((curs->y >= term.marg_top || marg_clip == 2) && y < term.marg_top)
-      y = term.marg_top;
-    if ((curs->y <= term.marg_bot || marg_clip == 2) && y > term.marg_bot)
-      y = term.marg_bot;
+    if ((curs->y >= term->marg_top || marg_clip == 2) && y < term->marg_top)
+      y = term->marg_top;
+    if ((curs->y <= term->marg_bot || marg_clip == 2) && y > term->marg_bot)
+      y = term->marg_bot;
   }
   if (y < 0)
     y = 0;
-  if (y >= term.rows)
-    y = term.rows - 1;
+  if (y >= term->rows)
+    y = term->rows - 1;
   curs->x = x;
   curs->y = y;
   curs->wrapnext = false;
@@ -55,7 +58,7 @@ move(int x, int y, int marg_clip)
 static void
 save_cursor(void)
 {
-  term.saved_cursors[term.on_alt_screen] = term.curs;
+  term->saved_cursors[term->on_alt_screen] = term->curs;
 }
 
 /*
@@ -64,21 +67,21 @@ save_cursor(void)
 static void
 restore_cursor(void)
 {
-  term_cursor *curs = &term.curs;
-  *curs = term.saved_cursors[term.on_alt_screen];
-  term.erase_char.attr = curs->attr & (ATTR_FGMASK | ATTR_BGMASK);
+  term_cursor *curs = &term->curs;
+  *curs = term->saved_cursors[term->on_alt_screen];
+  term->erase_char.attr = curs->attr & (ATTR_FGMASK | ATTR_BGMASK);
   
  /* Make sure the window hasn't shrunk since the save */
-  if (curs->x >= term.cols)
-    curs->x = term.cols - 1;
-  if (curs->y >= term.rows)
-    curs->y = term.rows - 1;
+  if (curs->x >= term->cols)
+    curs->x = term->cols - 1;
+  if (curs->y >= term->rows)
+    curs->y = term->rows - 1;
 
  /*
   * wrapnext might reset to False if the x position is no
   * longer at the rightmost edge.
   */
-  if (curs->wrapnext && curs->x < term.cols - 1)
+  if (curs->wrapnext && curs->x < term->cols - 1)
     curs->wrapnext = false;
 
   term_update_cs();
@@ -94,29 +97,27 @@ insert_char(int n)
   int dir = (n < 0 ? -1 : +1);
   int m;
   termline *line;
-  term_cursor *curs = &term.curs;
+  term_cursor *curs = &term->curs;
 
   n = (n < 0 ? -n : n);
-  if (n > term.cols - curs->x)
-    n = term.cols - curs->x;
-  m = term.cols - curs->x - n;
+  if (n > term->cols - curs->x)
+    n = term->cols - curs->x;
+  m = term->cols - curs->x - n;
   term_check_boundary(curs->x, curs->y);
   if (dir < 0)
     term_check_boundary(curs->x + n, curs->y);
-  line = term.lines[curs->y];
+  line = term->lines[curs->y];
   if (dir < 0) {
-    for (int j = 0; j < m; j++)
-      move_termchar(line, line->chars + curs->x + j,
-                    line->chars + curs->x + j + n);
+    memmove(line->chars + curs->x, line->chars + curs->x + n,
+            m * sizeof(termchar));
     while (n--)
-      line->chars[curs->x + m++] = term.erase_char;
+      line->chars[curs->x + m++] = term->erase_char;
   }
   else {
-    for (int j = m; j--;)
-      move_termchar(line, line->chars + curs->x + j + n,
-                    line->chars + curs->x + j);
+    memmove(line->chars + curs->x + n, line->chars + curs->x,
+            m * sizeof(termchar));
     while (n--)
-      line->chars[curs->x + n] = term.erase_char;
+      line->chars[curs->x + n] = term->erase_char;
   }
 }
 
@@ -131,11 +132,11 @@ write_bell(void)
 static void
 write_backspace(void)
 {
-  term_cursor *curs = &term.curs;
+  term_cursor *curs = &term->curs;
   if (curs->x == 0 && (curs->y == 0 || !curs->autowrap))
    /* do nothing */ ;
   else if (curs->x == 0 && curs->y > 0)
-    curs->x = term.cols - 1, curs->y--;
+    curs->x = term->cols - 1, curs->y--;
   else if (curs->wrapnext)
     curs->wrapnext = false;
   else
@@ -145,66 +146,106 @@ write_backspace(void)
 static void
 write_tab(void)
 {
-  term_cursor *curs = &term.curs;
+  term_cursor *curs = &term->curs;
 
   do
     curs->x++;
-  while (curs->x < term.cols - 1 && !term.tabs[curs->x]);
+  while (curs->x < term->cols - 1 && !term->tabs[curs->x]);
   
-  if ((term.lines[curs->y]->attr & LATTR_MODE) != LATTR_NORM) {
-    if (curs->x >= term.cols / 2)
-      curs->x = term.cols / 2 - 1;
+  if ((term->lines[curs->y]->attr & LATTR_MODE) != LATTR_NORM) {
+    if (curs->x >= term->cols / 2)
+      curs->x = term->cols / 2 - 1;
   }
   else {
-    if (curs->x >= term.cols)
-      curs->x = term.cols - 1;
+    if (curs->x >= term->cols)
+      curs->x = term->cols - 1;
   }
 }
 
 static void
 write_return(void)
 {
-  term.curs.x = 0;
-  term.curs.wrapnext = false;
+  term->curs.x = 0;
+  term->curs.wrapnext = false;
 }
 
 static void
 write_linefeed(void)
 {
-  term_cursor *curs = &term.curs;
-  if (curs->y == term.marg_bot)
-    term_do_scroll(term.marg_top, term.marg_bot, 1, true);
-  else if (curs->y < term.rows - 1)
+  term_cursor *curs = &term->curs;
+  if (curs->y == term->marg_bot)
+    term_do_scroll(term->marg_top, term->marg_bot, 1, true);
+  else if (curs->y < term->rows - 1)
     curs->y++;
   curs->wrapnext = false;
 }
 
+/*
+ * Canonical composition table, generated by scripts/mkcomposetable.pl.
+ * This is an open-addressed hash table, so the hash function and table
+ * size here must match the ones in the script.
+ */
+static const struct {
+  xchar c, cc, composed;
+} compose_table[2048] = {
+#include "compose.t"
+};
+
+static inline uint
+compose_hash(xchar c, xchar cc)
+{
+  return (uint)((c * 31 + cc) * 2654435761u) >> 21;
+}
+
+/* Try to combine a base and combining character into a precomposed one.
+ * Returns 0 if unsuccessful.
+ */
+static xchar
+combine_chars(xchar c, xchar cc)
+{
+ /* Hangul syllables */
+  if (c >= 0x1100 && c < 0x1113 && cc >= 0x1161 && cc < 0x1176)
+    return 0xAC00 + ((c - 0x1100) * 21 + (cc - 0x1161)) * 28;
+  if (c >= 0xAC00 && c <= 0xD7A3 && (c - 0xAC00) % 28 == 0 &&
+      cc > 0x11A7 && cc < 0x11C3)
+    return c + (cc - 0x11A7);
+
+  uint i = compose_hash(c, cc);
+  while (compose_table[i].c) {
+    if (compose_table[i].c == c && compose_table[i].cc == cc)
+      return compose_table[i].composed;
+    i = (i + 1) % lengthof(compose_table);
+  }
+  return 0;
+}
+
 static void
-write_char(wchar c, int width)
+write_char(xchar c, int width)
 {
   if (!c)
     return;
+  count(CNT_CELLS, 1);
   
-  term_cursor *curs = &term.curs;
-  termline *line = term.lines[curs->y];
-  void put_char(wchar c)
+  term_cursor *curs = &term->curs;
+  termline *line = term->lines[curs->y];
+  void put_char(xchar c)
   {
-    clear_cc(line, curs->x);
     line->chars[curs->x].chr = c;
+    line->chars[curs->x].cc = 0;
     line->chars[curs->x].attr = curs->attr;
   }  
 
   if (curs->wrapnext && curs->autowrap && width > 0) {
     line->attr |= LATTR_WRAPPED;
-    if (curs->y == term.marg_bot)
-      term_do_scroll(term.marg_top, term.marg_bot, 1, true);
-    else if (curs->y < term.rows - 1)
+    if (curs->y == term->marg_bot)
+      term_do_scroll(term->marg_top, term->marg_bot, 1, true);
+    else if (curs->y < term->rows - 1)
       curs->y++;
     curs->x = 0;
     curs->wrapnext = false;
-    line = term.lines[curs->y];
+    line = term->lines[curs->y];
   }
-  if (term.insert && width > 0)
+  if (term->insert && width > 0)
     insert_char(width);
   switch (width) {
     when 1:  // Normal character.
@@ -233,15 +274,15 @@ write_char(wchar c, int width)
       */
       term_check_boundary(curs->x, curs->y);
       term_check_boundary(curs->x + 2, curs->y);
-      if (curs->x == term.cols - 1) {
-        line->chars[curs->x] = term.erase_char;
+      if (curs->x == term->cols - 1) {
+        line->chars[curs->x] = term->erase_char;
         line->attr |= LATTR_WRAPPED | LATTR_WRAPPED2;
-        if (curs->y == term.marg_bot)
-          term_do_scroll(term.marg_top, term.marg_bot, 1, true);
-        else if (curs->y < term.rows - 1)
+        if (curs->y == term->marg_bot)
+          term_do_scroll(term->marg_top, term->marg_bot, 1, true);
+        else if (curs->y < term->rows - 1)
           curs->y++;
         curs->x = 0;
-        line = term.lines[curs->y];
+        line = term->lines[curs->y];
        /* Now we must term_check_boundary again, of course. */
         term_check_boundary(curs->x, curs->y);
         term_check_boundary(curs->x + 2, curs->y);
@@ -262,8 +303,10 @@ write_char(wchar c, int width)
           assert(x > 0);
           x--;
         }
-       /* Try to precompose with the cell's base codepoint */
-        wchar pc = win_combine_chars(line->chars[x].chr, c);
+       /* Try to precompose with the cell's base codepoint, unless other
+        * combining characters have already been attached to it. */
+        xchar bc = line->chars[x].chr;
+        xchar pc = line->chars[x].cc ? 0 : combine_chars(bc, c);
         if (pc)
           line->chars[x].chr = pc;
         else
@@ -274,28 +317,161 @@ write_char(wchar c, int width)
       return;
   }
   curs->x++;
-  if (curs->x == term.cols) {
+  if (curs->x == term->cols) {
     curs->x--;
     curs->wrapnext = true;
   }
 }
 
+/*
+ * Grapheme cluster break properties, as defined in Unicode Standard
+ * Annex #29. The table is generated by scripts/mkgcbtable.pl.
+ */
+enum {
+  GCB_Other, GCB_CR, GCB_LF, GCB_Control, GCB_Extend, GCB_ZWJ, GCB_RI,
+  GCB_Prepend, GCB_SpacingMark, GCB_L, GCB_V, GCB_T, GCB_LV, GCB_LVT,
+  GCB_ExtPict
+};
+
+static const struct {
+  xchar first, last;
+  uchar prop;
+} gcb_table[] = {
+#include "graphemes.t"
+};
+
+static uchar
+gcb_prop(xchar c)
+{
+  int min = 0, max = lengthof(gcb_table) - 1;
+  if (c < gcb_table[0].first || c > gcb_table[max].last)
+    return GCB_Other;
+  while (max >= min) {
+    int mid = (min + max) / 2;
+    if (c > gcb_table[mid].last)
+      min = mid + 1;
+    else if (c < gcb_table[mid].first)
+      max = mid - 1;
+    else
+      return gcb_table[mid].prop;
+  }
+  return GCB_Other;
+}
+
+/*
+ * Make the cell before the cursor double-width, because a character that
+ * has been added to its cluster turns it into a wide emoji or flag.
+ */
+static void
+widen_char(void)
+{
+  term_cursor *curs = &term->curs;
+  termline *line = term->lines[curs->y];
+  if (curs->wrapnext || curs->x == 0 ||
+      line->chars[curs->x - 1].chr == UCSWIDE)
+    return;
+
+  term_check_boundary(curs->x + 1, curs->y);
+  line->chars[curs->x] = line->chars[curs->x - 1];
+  line->chars[curs->x].chr = UCSWIDE;
+  line->chars[curs->x].cc = 0;
+  curs->x++;
+  if (curs->x == term->cols) {
+    curs->x--;
+    curs->wrapnext = true;
+  }
+}
+
+/*
+ * Write a printable character, adding it to the previous character cell
+ * if it continues the same grapheme cluster according to UAX #29.
+ * Printable ASCII characters never continue a cluster except after a
+ * prepended concatenation mark, so they bypass the property lookup.
+ */
+static void
+write_ucschar(xchar c, int width)
+{
+  uchar prev = term->gcb_prop;
+  if (c < 0x80 && prev != GCB_Prepend) {
+    term->gcb_prop = GCB_Other;
+    write_char(c, width);
+    return;
+  }
+
+  uchar prop = gcb_prop(c);
+  bool join;
+  if (prev == GCB_CR || prev == GCB_LF || prev == GCB_Control ||
+      prop == GCB_CR || prop == GCB_LF || prop == GCB_Control)
+    join = false;  // GB4, GB5
+  else if (prop == GCB_Extend || prop == GCB_ZWJ || prop == GCB_SpacingMark)
+    join = true;  // GB9, GB9a
+  else if (prev == GCB_Prepend)
+    join = true;  // GB9b
+  else if (prev == GCB_L)
+    join = prop == GCB_L || prop == GCB_V || prop == GCB_LV || prop == GCB_LVT;
+  else if (prev == GCB_LV || prev == GCB_V)
+    join = prop == GCB_V || prop == GCB_T;
+  else if (prev == GCB_LVT || prev == GCB_T)
+    join = prop == GCB_T;
+  else if (prop == GCB_ExtPict)
+    join = prev == GCB_ZWJ && term->gcb_emoji == 2;  // GB11
+  else if (prop == GCB_RI)
+    join = prev == GCB_RI && term->gcb_ri_odd;  // GB12, GB13
+  else
+    join = false;
+
+  bool in_emoji =
+    term->gcb_emoji == 1 && (prev == GCB_ExtPict || prev == GCB_Extend);
+  bool widen =
+    join && (prop == GCB_RI || prop == GCB_ExtPict ||
+             (c == 0xFE0F && in_emoji));
+
+  term->gcb_emoji =
+    prop == GCB_ExtPict ? 1 :
+    prop == GCB_Extend && in_emoji ? 1 :
+    prop == GCB_ZWJ && in_emoji ? 2 : 0;
+  term->gcb_ri_odd = prop == GCB_RI && !join;
+  term->gcb_prop = prop;
+
+  if (join) {
+    write_char(c, 0);
+    if (widen)
+      widen_char();
+  }
+  else
+    write_char(c, width);
+}
+
 static void
 write_error(void)
 {
   // Write 'Medium Shade' character from vt100 linedraw set,
   // which looks appropriately erroneous.
+  term->gcb_prop = GCB_Other;
   write_char(0x2592, 1);
 }
 
 /* Process control character, returning whether it has been recognised. */
+/*
+ * Add a modifier character to an escape sequence. More than one is only
+ * distinguished where it matters, such as for DECRQM on private modes,
+ * so keep the pair in case there are exactly two.
+ */
+static void
+add_esc_mod(uchar c)
+{
+  term->esc_mods =
+    term->esc_mod && term->esc_mod != 0xFF ? CPAIR(term->esc_mod, c) : 0;
+  term->esc_mod = term->esc_mod ? 0xFF : c;
+}
+
 static bool
 do_ctrl(char c)
 {
   switch (c) {
     when '\e':   /* ESC: Escape */
-      term.state = ESCAPE;
-      term.esc_mod = 0;
+      term->state = ESCAPE;
+      term->esc_mod = 0;
     when '\a':   /* BEL: Bell */
       write_bell();
     when '\b':     /* BS: Back space */
@@ -310,15 +486,15 @@ do_ctrl(char c)
       write_return();
     when '\n':   /* LF: Line feed */
       write_linefeed();
-      if (term.newline_mode)
+      if (term->newline_mode)
         write_return();
     when CTRL('E'):   /* ENQ: terminal type query */
       child_write(cfg.answerback, strlen(cfg.answerback));
     when CTRL('N'):   /* LS1: Locking-shift one */
-      term.curs.g1 = true;
+      term->curs.g1 = true;
       term_update_cs();
     when CTRL('O'):   /* LS0: Locking-shift zero */
-      term.curs.g1 = false;
+      term->curs.g1 = false;
       term_update_cs();
     otherwise:
       return false;
@@ -329,38 +505,38 @@ do_ctrl(char c)
 static void
 do_esc(uchar c)
 {
-  term_cursor *curs = &term.curs;
-  term.state = NORMAL;
-  switch (CPAIR(term.esc_mod, c)) {
+  term_cursor *curs = &term->curs;
+  term->state = NORMAL;
+  switch (CPAIR(term->esc_mod, c)) {
     when '[':  /* CSI: control sequence introducer */
-      term.state = CSI_ARGS;
-      term.csi_argc = 1;
-      memset(term.csi_argv, 0, sizeof(term.csi_argv));
-      term.esc_mod = 0;
+      term->state = CSI_ARGS;
+      term->csi_argc = 1;
+      memset(term->csi_argv, 0, sizeof(term->csi_argv));
+      term->esc_mod = 0;
     when ']':  /* OSC: operating system command */
-      term.state = OSC_START;
+      term->state = OSC_START;
     when 'P':  /* DCS: device control string */
-      term.state = CMD_STRING;
-      term.cmd_num = -1;
-      term.cmd_len = 0;
+      term->state = CMD_STRING;
+      term->cmd_num = -1;
+      term->cmd_len = 0;
     when '^' or '_': /* PM: privacy message, APC: application program command */
-      term.state = IGNORE_STRING;
+      term->state = IGNORE_STRING;
     when '7':  /* DECSC: save cursor */
       save_cursor();
     when '8':  /* DECRC: restore cursor */
       restore_cursor();
     when '=':  /* DECKPAM: Keypad application mode */
-      term.app_keypad = true;
+      term->app_keypad = true;
     when '>':  /* DECKPNM: Keypad numeric mode */
-      term.app_keypad = false;
+      term->app_keypad = false;
     when 'D':  /* IND: exactly equivalent to LF */
       write_linefeed();
     when 'E':  /* NEL: exactly equivalent to CR-LF */
       write_return();
       write_linefeed();
     when 'M':  /* RI: reverse index - backwards LF */
-      if (curs->y == term.marg_top)
-        term_do_scroll(term.marg_top, term.marg_bot, -1, true);
+      if (curs->y == term->marg_top)
+        term_do_scroll(term->marg_top, term->marg_bot, -1, true);
       else if (curs->y > 0)
         curs->y--;
       curs->wrapnext = false;
@@ -368,30 +544,31 @@ do_esc(uchar c)
       child_write(primary_da, sizeof primary_da - 1);
     when 'c':  /* RIS: restore power-on settings */
       term_reset();
-      if (term.reset_132) {
-        win_set_chars(term.rows, 80);
-        term.reset_132 = 0;
+      win_reset_colours();
+      if (term->reset_132) {
+        win_set_chars(term->rows, 80);
+        term->reset_132 = 0;
       }
     when 'H':  /* HTS: set a tab */
-      term.tabs[curs->x] = true;
+      term->tabs[curs->x] = true;
     when CPAIR('#', '8'):    /* DECALN: fills screen with Es :-) */
-      for (int i = 0; i < term.rows; i++) {
-        termline *line = term.lines[i];
-        for (int j = 0; j < term.cols; j++) {
+      for (int i = 0; i < term->rows; i++) {
+        termline *line = term->lines[i];
+        for (int j = 0; j < term->cols; j++) {
           line->chars[j] =
-            (termchar){.cc_next = 0, .chr = 'E', .attr = ATTR_DEFAULT};
+            (termchar){.chr = 'E', .cc = 0, .attr = ATTR_DEFAULT};
         }
         line->attr = LATTR_NORM;
       }
-      term.disptop = 0;
+      term->disptop = 0;
     when CPAIR('#', '3'):  /* DECDHL: 2*height, top */
-      term.lines[curs->y]->attr = LATTR_TOP;
+      term->lines[curs->y]->attr = LATTR_TOP;
     when CPAIR('#', '4'):  /* DECDHL: 2*height, bottom */
-      term.lines[curs->y]->attr = LATTR_BOT;
+      term->lines[curs->y]->attr = LATTR_BOT;
     when CPAIR('#', '5'):  /* DECSWL: normal */
-      term.lines[curs->y]->attr = LATTR_NORM;
+      term->lines[curs->y]->attr = LATTR_NORM;
     when CPAIR('#', '6'):  /* DECDWL: 2*width */
-      term.lines[curs->y]->attr = LATTR_WIDE;
+      term->lines[curs->y]->attr = LATTR_WIDE;
     when CPAIR('(', 'A') or CPAIR('(', 'B') or CPAIR('(', '0'):
      /* GZD4: G0 designate 94-set */
       curs->csets[0] = c;
@@ -413,16 +590,19 @@ do_esc(uchar c)
       curs->utf = false;
       term_update_cs();
   }
+  // Introducers are counted when their sequence is done.
+  if (term->state == NORMAL)
+    count(CNT_ESC, 1);
 }
 
 static void
 do_sgr(void)
 {
  /* Set Graphics Rendition. */
-  uint argc = term.csi_argc;
-  uint attr = term.curs.attr;
+  uint argc = term->csi_argc;
+  uint attr = term->curs.attr;
   for (uint i = 0; i < argc; i++) {
-    switch (term.csi_argv[i]) {
+    switch (term->csi_argv[i]) {
       when 0: attr = ATTR_DEFAULT | (attr & ATTR_PROTECTED);
       when 1: attr |= ATTR_BOLD;
       when 2: attr |= ATTR_DIM;
@@ -431,7 +611,7 @@ do_sgr(void)
       when 7: attr |= ATTR_REVERSE;
       when 8: attr |= ATTR_INVISIBLE;
       when 10 ... 12:
-        term.curs.oem_acs = term.csi_argv[i] - 10;
+        term->curs.oem_acs = term->csi_argv[i] - 10;
         term_update_cs();
       when 21: attr &= ~ATTR_BOLD;
       when 22: attr &= ~(ATTR_BOLD | ATTR_DIM);
@@ -441,14 +621,14 @@ do_sgr(void)
       when 28: attr &= ~ATTR_INVISIBLE;
       when 30 ... 37: /* foreground */
         attr &= ~ATTR_FGMASK;
-        attr |= (term.csi_argv[i] - 30) << ATTR_FGSHIFT;
+        attr |= (term->csi_argv[i] - 30) << ATTR_FGSHIFT;
       when 90 ... 97: /* bright foreground */
         attr &= ~ATTR_FGMASK;
-        attr |= ((term.csi_argv[i] - 90 + 8) << ATTR_FGSHIFT);
+        attr |= ((term->csi_argv[i] - 90 + 8) << ATTR_FGSHIFT);
       when 38: /* 256-colour foreground */
-        if (i + 2 < argc && term.csi_argv[i + 1] == 5) {
+        if (i + 2 < argc && term->csi_argv[i + 1] == 5) {
           attr &= ~ATTR_FGMASK;
-          attr |= ((term.csi_argv[i + 2] & 0xFF) << ATTR_FGSHIFT);
+          attr |= ((term->csi_argv[i + 2] & 0xFF) << ATTR_FGSHIFT);
           i += 2;
         }
       when 39: /* default foreground */
@@ -456,14 +636,14 @@ do_sgr(void)
         attr |= ATTR_DEFFG;
       when 40 ... 47: /* background */
         attr &= ~ATTR_BGMASK;
-        attr |= (term.csi_argv[i] - 40) << ATTR_BGSHIFT;
+        attr |= (term->csi_argv[i] - 40) << ATTR_BGSHIFT;
       when 100 ... 107: /* bright background */
         attr &= ~ATTR_BGMASK;
-        attr |= ((term.csi_argv[i] - 100 + 8) << ATTR_BGSHIFT);
+        attr |= ((term->csi_argv[i] - 100 + 8) << ATTR_BGSHIFT);
       when 48: /* 256-colour background */
-        if (i + 2 < argc && term.csi_argv[i + 1] == 5) {
+        if (i + 2 < argc && term->csi_argv[i + 1] == 5) {
           attr &= ~ATTR_BGMASK;
-          attr |= ((term.csi_argv[i + 2] & 0xFF) << ATTR_BGSHIFT);
+          attr |= ((term->csi_argv[i + 2] & 0xFF) << ATTR_BGSHIFT);
           i += 2;
         }
       when 49: /* default background */
@@ -471,8 +651,35 @@ do_sgr(void)
         attr |= ATTR_DEFBG;
     }
   }
-  term.curs.attr = attr;
-  term.erase_char.attr = attr & (ATTR_FGMASK | ATTR_BGMASK);
+  term->curs.attr = attr;
+  term->erase_char.attr = attr & (ATTR_FGMASK | ATTR_BGMASK);
+}
+
+/*
+ * Synchronized output mode lets applications draw a frame without parts of
+ * it being shown before it's complete. In case an application forgets to
+ * reset the mode, or dies while it is set, it times out.
+ */
+enum { SYNC_TIMEOUT = 150 };
+
+static void
+sync_output_timeout(void)
+{
+  if (term->sync_output) {
+    term->sync_output = false;
+    win_update();
+  }
+}
+
+static void
+set_sync_output(bool state)
+{
+  bool was_on = term->sync_output;
+  term->sync_output = state;
+  if (state && !was_on)
+    win_set_timer(sync_output_timeout, SYNC_TIMEOUT);
+  else if (!state && was_on)
+    win_update();
 }
 
 /*
@@ -481,69 +688,73 @@ do_sgr(void)
 static void
 set_modes(bool state)
 {
-  for (uint i = 0; i < term.csi_argc; i++) {
-    int arg = term.csi_argv[i];
-    if (term.esc_mod) {
+  for (uint i = 0; i < term->csi_argc; i++) {
+    int arg = term->csi_argv[i];
+    if (term->esc_mod) {
       switch (arg) {
         when 1:  /* DECCKM: application cursor keys */
-          term.app_cursor_keys = state;
+          term->app_cursor_keys = state;
         when 2:  /* DECANM: VT52 mode */
           // IGNORE
         when 3:  /* DECCOLM: 80/132 columns */
-          if (term.deccolm_allowed) {
-            term.selected = false;
-            win_set_chars(term.rows, state ? 132 : 80);
-            term.reset_132 = state;
-            term.marg_top = 0;
-            term.marg_bot = term.rows - 1;
+          if (term->deccolm_allowed) {
+            term->selected = false;
+            win_set_chars(term->rows, state ? 132 : 80);
+            term->reset_132 = state;
+            term->marg_top = 0;
+            term->marg_bot = term->rows - 1;
             move(0, 0, 0);
             term_erase(false, false, true, true);
           }
         when 5:  /* DECSCNM: reverse video */
-          if (state != term.rvideo) {
-            term.rvideo = state;
+          if (state != term->rvideo) {
+            term->rvideo = state;
             win_invalidate_all();
           }
         when 6:  /* DECOM: DEC origin mode */
-          term.curs.origin = state;
+          term->curs.origin = state;
         when 7:  /* DECAWM: auto wrap */
-          term.curs.autowrap = state;
+          term->curs.autowrap = state;
         when 8:  /* DECARM: auto key repeat */
           // ignore
         when 9:  /* X10_MOUSE */
-          term.mouse_mode = state ? MM_X10 : 0;
+          term->mouse_mode = state ? MM_X10 : 0;
+          term->motion.pending = false;
           win_update_mouse();
         when 25: /* DECTCEM: enable/disable cursor */
-          term.cursor_on = state;
+          term->cursor_on = state;
         when 40: /* Allow/disallow DECCOLM (xterm c132 resource) */
-          term.deccolm_allowed = state;
+          term->deccolm_allowed = state;
         when 47: /* alternate screen */
-          term.selected = false;
+          term->selected = false;
           term_switch_screen(state, false);
-          term.disptop = 0;
+          term->disptop = 0;
         when 67: /* DECBKM: backarrow key mode */
-          term.backspace_sends_bs = state;
+          term->backspace_sends_bs = state;
         when 1000: /* VT200_MOUSE */
-          term.mouse_mode = state ? MM_VT200 : 0;
+          term->mouse_mode = state ? MM_VT200 : 0;
+          term->motion.pending = false;
           win_update_mouse();
         when 1002: /* BTN_EVENT_MOUSE */
-          term.mouse_mode = state ? MM_BTN_EVENT : 0;
+          term->mouse_mode = state ? MM_BTN_EVENT : 0;
+          term->motion.pending = false;
           win_update_mouse();
         when 1003: /* ANY_EVENT_MOUSE */
-          term.mouse_mode = state ? MM_ANY_EVENT : 0;
+          term->mouse_mode = state ? MM_ANY_EVENT : 0;
+          term->motion.pending = false;
           win_update_mouse();
         when 1004: /* FOCUS_EVENT_MOUSE */
-          term.report_focus = state;
+          term->report_focus = state;
         when 1005: /* Xterm's UTF8 encoding for mouse positions */
-          term.mouse_enc = state ? ME_UTF8 : 0;
+          term->mouse_enc = state ? ME_UTF8 : 0;
         when 1006: /* Xterm's CSI-style mouse encoding */
-          term.mouse_enc = state ? ME_XTERM_CSI : 0;
+          term->mouse_enc = state ? ME_XTERM_CSI : 0;
         when 1015: /* Urxvt's CSI-style mouse encoding */
-          term.mouse_enc = state ? ME_URXVT_CSI : 0;
+          term->mouse_enc = state ? ME_URXVT_CSI : 0;
         when 1047:       /* alternate screen */
-          term.selected = false;
+          term->selected = false;
           term_switch_screen(state, true);
-          term.disptop = 0;
+          term->disptop = 0;
         when 1048:       /* save/restore cursor */
           if (state)
             save_cursor();
@@ -552,58 +763,108 @@ set_modes(bool state)
         when 1049:       /* cursor & alternate screen */
           if (state)
             save_cursor();
-          term.selected = false;
+          term->selected = false;
           term_switch_screen(state, true);
           if (!state)
             restore_cursor();
-          term.disptop = 0;
+          term->disptop = 0;
         when 1061:       /* VT220 keyboard emulation */
-          term.vt220_keys = state;
+          term->vt220_keys = state;
         when 2004:       /* xterm bracketed paste mode */
-          term.bracketed_paste = state;
+          term->bracketed_paste = state;
+        when 2026:       /* Synchronized output */
+          set_sync_output(state);
 
         /* Mintty private modes */
         when 7700:       /* CJK ambigous width reporting */
-          term.report_ambig_width = state;
+          term->report_ambig_width = state;
         when 7727:       /* Application escape key mode */
-          term.app_escape_key = state;
+          term->app_escape_key = state;
         when 7728:       /* Escape sends FS (instead of ESC) */
-          term.escape_sends_fs = state;
+          term->escape_sends_fs = state;
         when 7766:       /* Show/hide scrollbar (if enabled in config) */
-          if (state != term.show_scrollbar) {
-            term.show_scrollbar = state;
+          if (state != term->show_scrollbar) {
+            term->show_scrollbar = state;
             if (cfg.scrollbar)
               win_update_scrollbar();
           }
         when 7783:       /* Shortcut override */
-          term.shortcut_override = state;
+          term->shortcut_override = state;
         when 7786:       /* Mousewheel reporting */
-          term.wheel_reporting = state;
+          term->wheel_reporting = state;
         when 7787:       /* Application mousewheel mode */
-          term.app_wheel = state;
+          term->app_wheel = state;
       }
     }
     else {
       switch (arg) {
         when 4:  /* IRM: set insert mode */
-          term.insert = state;
+          term->insert = state;
         when 12: /* SRM: set echo mode */
-          term.echoing = !state;
+          term->echoing = !state;
         when 20: /* LNM: Return sends ... */
-          term.newline_mode = state;
+          term->newline_mode = state;
       }
     }
   }
 }
 
+/*
+ * State of a mode for DECRQM: 1 if set, 2 if reset, or 0 if not recognised.
+ */
+static int
+get_mode(bool private, int arg)
+{
+  int state = -1;
+  if (private) {
+    switch (arg) {
+      when 1:  state = term->app_cursor_keys;
+      when 3:  state = term->reset_132;
+      when 5:  state = term->rvideo;
+      when 6:  state = term->curs.origin;
+      when 7:  state = term->curs.autowrap;
+      when 9:  state = term->mouse_mode == MM_X10;
+      when 25: state = term->cursor_on;
+      when 40: state = term->deccolm_allowed;
+      when 47 or 1047 or 1049: state = term->on_alt_screen;
+      when 67: state = term->backspace_sends_bs;
+      when 1000: state = term->mouse_mode == MM_VT200;
+      when 1002: state = term->mouse_mode == MM_BTN_EVENT;
+      when 1003: state = term->mouse_mode == MM_ANY_EVENT;
+      when 1004: state = term->report_focus;
+      when 1005: state = term->mouse_enc == ME_UTF8;
+      when 1006: state = term->mouse_enc == ME_XTERM_CSI;
+      when 1015: state = term->mouse_enc == ME_URXVT_CSI;
+      when 1061: state = term->vt220_keys;
+      when 2004: state = term->bracketed_paste;
+      when 2026: state = term->sync_output;
+      when 7700: state = term->report_ambig_width;
+      when 7727: state = term->app_escape_key;
+      when 7728: state = term->escape_sends_fs;
+      when 7766: state = term->show_scrollbar;
+      when 7783: state = term->shortcut_override;
+      when 7786: state = term->wheel_reporting;
+      when 7787: state = term->app_wheel;
+    }
+  }
+  else {
+    switch (arg) {
+      when 4:  state = term->insert;
+      when 12: state = !term->echoing;
+      when 20: state = term->newline_mode;
+    }
+  }
+  return state < 0 ? 0 : state ? 1 : 2;
+}
+
 /*
  * dtterm window operations and xterm extensions.
  */
 static void
 do_winop(void)
 {
-  int arg1 = term.csi_argv[1], arg2 = term.csi_argv[2];
-  switch (term.csi_argv[0]) {
+  int arg1 = term->csi_argv[1], arg2 = term->csi_argv[2];
+  switch (term->csi_argv[0]) {
     when 1: win_set_iconic(false);
     when 2: win_set_iconic(true);
     when 3: win_set_pos(arg1, arg2);
@@ -625,7 +886,7 @@ do_winop(void)
       win_get_pixels(&height, &width);
       child_printf("\e[4;%d;%dt", height, width);
     }
-    when 18: child_printf("\e[8;%d;%dt", term.rows, term.cols);
+    when 18: child_printf("\e[8;%d;%dt", term->rows, term->cols);
     when 19: {
       int rows, cols;
       win_get_screen_chars(&rows, &cols);
@@ -643,10 +904,11 @@ do_winop(void)
 static void
 do_csi(uchar c)
 {
-  term_cursor *curs = &term.curs;
-  int arg0 = term.csi_argv[0], arg1 = term.csi_argv[1];
+  count_csi(c);
+  term_cursor *curs = &term->curs;
+  int arg0 = term->csi_argv[0], arg1 = term->csi_argv[1];
   int arg0_def1 = arg0 ?: 1;  // first arg with default 1
-  switch (CPAIR(term.esc_mod, c)) {
+  switch (CPAIR(term->esc_mod, c)) {
     when 'A':        /* CUU: move up N lines */
       move(curs->x, curs->y - arg0_def1, 1);
     when 'e':        /* VPR: move down N lines */
@@ -669,34 +931,34 @@ do_csi(uchar c)
       move(arg0_def1 - 1, curs->y, 0);
     when 'd':        /* VPA: set vertical posn */
       move(curs->x,
-           (curs->origin ? term.marg_top : 0) + arg0_def1 - 1,
+           (curs->origin ? term->marg_top : 0) + arg0_def1 - 1,
            curs->origin ? 2 : 0);
     when 'H' or 'f':  /* CUP or HVP: set horz and vert posns at once */
       move((arg1 ?: 1) - 1,
-           (curs->origin ? term.marg_top : 0) + arg0_def1 - 1,
+           (curs->origin ? term->marg_top : 0) + arg0_def1 - 1,
            curs->origin ? 2 : 0);
     when 'J' or CPAIR('?', 'J'): { /* ED/DECSED: (selective) erase in display */
-      if (arg0 == 3 && !term.esc_mod) { /* Erase Saved Lines (xterm) */
+      if (arg0 == 3 && !term->esc_mod) { /* Erase Saved Lines (xterm) */
         term_clear_scrollback();
-        term.disptop = 0;
+        term->disptop = 0;
       }
       else {
         bool above = arg0 == 1 || arg0 == 2;
         bool below = arg0 == 0 || arg0 == 2;
-        term_erase(term.esc_mod, false, above, below);
+        term_erase(term->esc_mod, false, above, below);
       }
     }
     when 'K' or CPAIR('?', 'K'): { /* EL/DECSEL: (selective) erase in line */
       bool right = arg0 == 0 || arg0 == 2;
       bool left  = arg0 == 1 || arg0 == 2;
-      term_erase(term.esc_mod, true, left, right);
+      term_erase(term->esc_mod, true, left, right);
     }
     when 'L':        /* IL: insert lines */
-      if (curs->y >= term.marg_top && curs->y <= term.marg_bot)
-        term_do_scroll(curs->y, term.marg_bot, -arg0_def1, false);
+      if (curs->y >= term->marg_top && curs->y <= term->marg_bot)
+        term_do_scroll(curs->y, term->marg_bot, -arg0_def1, false);
     when 'M':        /* DL: delete lines */
-      if (curs->y >= term.marg_top && curs->y <= term.marg_bot)
-        term_do_scroll(curs->y, term.marg_bot, arg0_def1, true);
+      if (curs->y >= term->marg_top && curs->y <= term->marg_bot)
+        term_do_scroll(curs->y, term->marg_bot, arg0_def1, true);
     when '@':        /* ICH: insert chars */
       insert_char(arg0_def1);
     when 'P':        /* DCH: delete chars */
@@ -714,31 +976,31 @@ do_csi(uchar c)
       set_modes(false);
     when 'i' or CPAIR('?', 'i'):  /* MC: Media copy */
       if (arg0 == 5 && *cfg.printer) {
-        term.printing = true;
-        term.only_printing = !term.esc_mod;
-        term.print_state = 0;
+        term->printing = true;
+        term->only_printing = !term->esc_mod;
+        term->print_state = 0;
         printer_start_job(cfg.printer);
       }
-      else if (arg0 == 4 && term.printing) {
+      else if (arg0 == 4 && term->printing) {
         // Drop escape sequence from print buffer and finish printing.
-        while (term.printbuf[--term.printbuf_pos] != '\e');
+        while (term->printbuf[--term->printbuf_pos] != '\e');
         term_print_finish();
       }
     when 'g':        /* TBC: clear tabs */
       if (!arg0)
-        term.tabs[curs->x] = false;
+        term->tabs[curs->x] = false;
       else if (arg0 == 3) {
-        for (int i = 0; i < term.cols; i++)
-          term.tabs[i] = false;
+        for (int i = 0; i < term->cols; i++)
+          term->tabs[i] = false;
       }
     when 'r': {      /* DECSTBM: set scroll margins */
       int top = arg0_def1 - 1;
-      int bot = (arg1 ? min(arg1, term.rows) : term.rows) - 1;
+      int bot = (arg1 ? min(arg1, term->rows) : term->rows) - 1;
       if (bot > top) {
-        term.marg_top = top;
-        term.marg_bot = bot;
+        term->marg_top = top;
+        term->marg_bot = bot;
         curs->x = 0;
-        curs->y = curs->origin ? term.marg_top : 0;
+        curs->y = curs->origin ? term->marg_top : 0;
       }
     }
     when 'm':        /* SGR: set graphics rendition */
@@ -755,18 +1017,18 @@ do_csi(uchar c)
       * allowed any number of rows from 24 and above to be set.
       */
       if (arg0 >= 24) {
-        win_set_chars(arg0, term.cols);
-        term.selected = false;
+        win_set_chars(arg0, term->cols);
+        term->selected = false;
       }
       else
         do_winop();
     when 'S':        /* SU: Scroll up */
-      term_do_scroll(term.marg_top, term.marg_bot, arg0_def1, true);
+      term_do_scroll(term->marg_top, term->marg_bot, arg0_def1, true);
       curs->wrapnext = false;
     when 'T':        /* SD: Scroll down */
       /* Avoid clash with unsupported hilight mouse tracking mode sequence */
-      if (term.csi_argc <= 1) {
-        term_do_scroll(term.marg_top, term.marg_bot, -arg0_def1, true);
+      if (term->csi_argc <= 1) {
+        term_do_scroll(term->marg_top, term->marg_bot, -arg0_def1, true);
         curs->wrapnext = false;
       }
     when CPAIR('*', '|'):     /* DECSNLS */
@@ -776,24 +1038,29 @@ do_csi(uchar c)
       * support any size in reasonable range
       * (24..49 AIUI) with no default specified.
       */
-      win_set_chars(arg0 ?: cfg.rows, term.cols);
-      term.selected = false;
+      win_set_chars(arg0 ?: cfg.rows, term->cols);
+      term->selected = false;
     when CPAIR('$', '|'):     /* DECSCPP */
      /*
       * Set number of columns per page
       * Docs imply range is only 80 or 132, but
       * I'll allow any.
       */
-      win_set_chars(term.rows, arg0 ?: cfg.cols);
-      term.selected = false;
+      win_set_chars(term->rows, arg0 ?: cfg.cols);
+      term->selected = false;
+    when CPAIR('$', 'p'):     /* DECRQM: request ANSI mode */
+      child_printf("\e[%u;%u$y", arg0, get_mode(false, arg0));
+    when CPAIR(0xFF, 'p'):    /* DECRQM: request DEC private mode */
+      if (term->esc_mods == CPAIR('?', '$'))
+        child_printf("\e[?%u;%u$y", arg0, get_mode(true, arg0));
     when 'X': {      /* ECH: write N spaces w/o moving cursor */
-      int n = min(arg0_def1, term.cols - curs->x);
+      int n = min(arg0_def1, term->cols - curs->x);
       int p = curs->x;
       term_check_boundary(curs->x, curs->y);
       term_check_boundary(curs->x + n, curs->y);
-      termline *line = term.lines[curs->y];
+      termline *line = term->lines[curs->y];
       while (n--)
-        line->chars[p++] = term.erase_char;
+        line->chars[p++] = term->erase_char;
     }
     when 'x':        /* DECREQTPARM: report terminal characteristics */
       child_printf("\e[%c;1;1;112;112;1;0x", '2' + arg0);
@@ -802,28 +1069,28 @@ do_csi(uchar c)
       while (--n >= 0 && curs->x > 0) {
         do
           curs->x--;
-        while (curs->x > 0 && !term.tabs[curs->x]);
+        while (curs->x > 0 && !term->tabs[curs->x]);
       }
     }
     when CPAIR('>', 'm'):     /* xterm: modifier key setting */
       /* only the modifyOtherKeys setting is implemented */
       if (!arg0)
-        term.modify_other_keys = 0;
+        term->modify_other_keys = 0;
       else if (arg0 == 4)
-        term.modify_other_keys = arg1;
+        term->modify_other_keys = arg1;
     when CPAIR('>', 'n'):     /* xterm: modifier key setting */
       /* only the modifyOtherKeys setting is implemented */
       if (arg0 == 4)
-        term.modify_other_keys = 0;
+        term->modify_other_keys = 0;
     when CPAIR(' ', 'q'):     /* DECSCUSR: set cursor style */
-      term.cursor_type = arg0 ? (arg0 - 1) / 2 : -1;
-      term.cursor_blinks = arg0 ? arg0 % 2 : -1;
-      term.cursor_invalid = true;
+      term->cursor_type = arg0 ? (arg0 - 1) / 2 : -1;
+      term->cursor_blinks = arg0 ? arg0 % 2 : -1;
+      term->cursor_invalid = true;
       term_schedule_cblink();
     when CPAIR('"', 'q'):  /* DECSCA: select character protection attribute */
       switch (arg0) {
-        when 0 or 2: term.curs.attr &= ~ATTR_PROTECTED;
-        when 1: term.curs.attr |= ATTR_PROTECTED;
+        when 0 or 2: term->curs.attr &= ~ATTR_PROTECTED;
+        when 1: term->curs.attr |= ATTR_PROTECTED;
       }
   }
 }
@@ -834,12 +1101,12 @@ do_dcs(void)
   // Only DECRQSS (Request Status String) is implemented.
   // No DECUDK (User-Defined Keys) or xterm termcap/terminfo data.
 
-  char *s = term.cmd_buf;
+  char *s = term->cmd_buf;
 
   if (*s++ != '$')
     return;
   
-  uint attr = term.curs.attr;
+  uint attr = term->curs.attr;
 
   if (!strcmp(s, "qm")) { // SGR
     char buf[64], *p = buf;
@@ -858,8 +1125,8 @@ do_dcs(void)
     if (attr & ATTR_INVISIBLE)
       p += sprintf(p, ";8");
 
-    if (term.curs.oem_acs)
-      p += sprintf(p, ";%u", 10 + term.curs.oem_acs);
+    if (term->curs.oem_acs)
+      p += sprintf(p, ";%u", 10 + term->curs.oem_acs);
 
     uint fg = (attr & ATTR_FGMASK) >> ATTR_FGSHIFT;
     if (fg != FG_COLOUR_I) {
@@ -882,7 +1149,7 @@ do_dcs(void)
     child_write(buf, p - buf);
   }
   else if (!strcmp(s, "qr"))  // DECSTBM (scroll margins)
-    child_printf("\eP1$r%u;%ur\e\\", term.marg_top + 1, term.marg_bot + 1);
+    child_printf("\eP1$r%u;%ur\e\\", term->marg_top + 1, term->marg_bot + 1);
   else if (!strcmp(s, "q\"p"))  // DECSCL (conformance level)
     child_write("\eP1$r61\"p\e\\", 11);  // report as VT100
   else if (!strcmp(s, "q\"q"))  // DECSCA (protection attribute)
@@ -894,7 +1161,7 @@ do_dcs(void)
 static void
 do_colour_osc(uint i)
 {
-  char *s = term.cmd_buf;
+  char *s = term->cmd_buf;
   bool has_index_arg = !i;
   if (has_index_arg) {
     int len = 0;
@@ -905,14 +1172,14 @@ do_colour_osc(uint i)
   }
   colour c;
   if (!strcmp(s, "?")) {
-    child_printf("\e]%u;", term.cmd_num);
+    child_printf("\e]%u;", term->cmd_num);
     if (has_index_arg)
       child_printf("%u;", i);
     c = win_get_colour(i);
     child_printf("rgb:%04x/%04x/%04x\e\\",
                  red(c) * 0x101, green(c) * 0x101, blue(c) * 0x101);
   }
-  else if (parse_colour(s, &c))
+  else if (parse_colour(s, &c) && c != win_get_colour(i))
     win_set_colour(i, c);
 }
 
@@ -922,9 +1189,13 @@ do_colour_osc(uint i)
 static void
 do_cmd(void)
 {
-  char *s = term.cmd_buf;
-  s[term.cmd_len] = 0;
-  switch (term.cmd_num) {
+  char *s = term->cmd_buf;
+  s[term->cmd_len] = 0;
+  if (term->cmd_num < 0)
+    count(CNT_DCS, 1);
+  else
+    count_osc(term->cmd_num);
+  switch (term->cmd_num) {
     when -1: do_dcs();
     when 0 or 2 or 21: win_set_title(s);  // ignore icon title
     when 4:  do_colour_osc(0);
@@ -934,8 +1205,12 @@ do_cmd(void)
     when 701:  // Set/get locale (from urxvt).
       if (!strcmp(s, "?"))
         child_printf("\e]701;%s\e\\", cs_get_locale());
-      else
-        cs_set_locale(s);
+      else {
+        delete(term->charset_locale);
+        term->charset_locale = *s ? strdup(s) : 0;
+        cs_mb1towc(&term->decoder, 0, 0);
+        term_update_cs();
+      }
     when 7770:  // Change font size.
       if (!strcmp(s, "?"))
         child_printf("\e]7770;%u\e\\", win_get_font_size());
@@ -952,7 +1227,7 @@ do_cmd(void)
     when 7771: {  // Enquire about font support for a list of characters
       if (*s++ != '?')
         return;
-      wchar wcs[term.cmd_len];
+      wchar wcs[term->cmd_len];
       uint n = 0;
       while (*s) {
         if (*s++ != ';')
@@ -960,62 +1235,61 @@ do_cmd(void)
         wcs[n++] = strtoul(s, &s, 10);
       }
       win_check_glyphs(wcs, n);
-      s = term.cmd_buf;
+      s = term->cmd_buf;
       for (size_t i = 0; i < n; i++) {
         *s++ = ';';
         if (wcs[i])
           s += sprintf(s, "%u", wcs[i]);
       }
       *s = 0;
-      child_printf("\e]7771;!%s\e\\", term.cmd_buf);
+      child_printf("\e]7771;!%s\e\\", term->cmd_buf);
     }
+    when 7772:  // Keystroke latency tracing
+      if (!strcmp(s, "?")) {
+        char *report = latency_report();
+        child_printf("\e]7772;%s\e\\", report);
+        free(report);
+      }
+      else if (!strcmp(s, "dump"))
+        latency_dump(cfg.latency_log);
+      else if (!strcmp(s, "0") || !strcmp(s, "1"))
+        latency_enable(*s == '1');
+    when 7773:  // Performance counters
+      if (!strcmp(s, "?")) {
+        char *report = counters_report();
+        child_printf("\e]7773;%s\e\\", report);
+        free(report);
+      }
+      else if (!strcmp(s, "0") || !strcmp(s, "1"))
+        counters_enable(*s == '1');
+    when 7774:  // Timeline tracing
+      if (!strcmp(s, "dump"))
+        trace_dump(cfg.trace_file);
+      else if (!strcmp(s, "0") || !strcmp(s, "1"))
+        trace_enable(*s == '1');
   }
 }
 
 void
 term_print_finish(void)
 {
-  if (term.printing) {
-    printer_write(term.printbuf, term.printbuf_pos);
-    free(term.printbuf);
-    term.printbuf = 0;
-    term.printbuf_size = term.printbuf_pos = 0;
+  if (term->printing) {
+    printer_write(term->printbuf, term->printbuf_pos);
+    free(term->printbuf);
+    term->printbuf = 0;
+    term->printbuf_size = term->printbuf_pos = 0;
     printer_finish_job();
-    term.printing = term.only_printing = false;
+    term->printing = term->only_printing = false;
   }
 }
 
-/* Empty the input buffer */
-void
-term_flush(void)
+static void
+process_output(const char *buf, uint len)
 {
-  term_write(term.inbuf, term.inbuf_pos);
-  free(term.inbuf);
-  term.inbuf = 0;
-  term.inbuf_pos = 0;
-  term.inbuf_size = 0;
-}
+  count(CNT_PARSED, len);
 
-void
-term_write(const char *buf, uint len)
-{
- /*
-  * During drag-selects, we do not process terminal input,
-  * because the user will want the screen to hold still to
-  * be selected.
-  */
-  if (term_selecting()) {
-    if (term.inbuf_pos + len > term.inbuf_size) {
-      term.inbuf_size = max(term.inbuf_pos, term.inbuf_size * 4 + 4096);
-      term.inbuf = renewn(term.inbuf, term.inbuf_size);
-    }
-    memcpy(term.inbuf + term.inbuf_pos, buf, len);
-    term.inbuf_pos += len;
-    return;
-  }
-    
   // Reset cursor blinking.
-  term.cblinker = 1;
+  term->cblinker = 1;
   term_schedule_cblink();
 
   uint pos = 0;
@@ -1026,69 +1300,70 @@ term_write(const char *buf, uint len)
     * If we're printing, add the character to the printer
     * buffer.
     */
-    if (term.printing) {
-      if (term.printbuf_pos >= term.printbuf_size) {
-        term.printbuf_size = term.printbuf_size * 4 + 4096;
-        term.printbuf = renewn(term.printbuf, term.printbuf_size);
+    if (term->printing) {
+      if (term->printbuf_pos >= term->printbuf_size) {
+        term->printbuf_size = term->printbuf_size * 4 + 4096;
+        term->printbuf = renewn(term->printbuf, term->printbuf_size);
       }
-      term.printbuf[term.printbuf_pos++] = c;
+      term->printbuf[term->printbuf_pos++] = c;
 
      /*
       * If we're in print-only mode, we use a much simpler
       * state machine designed only to recognise the ESC[4i
       * termination sequence.
       */
-      if (term.only_printing) {
+      if (term->only_printing) {
         if (c == '\e')
-          term.print_state = 1;
-        else if (c == '[' && term.print_state == 1)
-          term.print_state = 2;
-        else if (c == '4' && term.print_state == 2)
-          term.print_state = 3;
-        else if (c == 'i' && term.print_state == 3) {
-          term.printbuf_pos -= 4;
+          term->print_state = 1;
+        else if (c == '[' && term->print_state == 1)
+          term->print_state = 2;
+        else if (c == '4' && term->print_state == 2)
+          term->print_state = 3;
+        else if (c == 'i' && term->print_state == 3) {
+          term->printbuf_pos -= 4;
           term_print_finish();
         }
         else
-          term.print_state = 0;
+          term->print_state = 0;
         continue;
       }
     }
 
-    switch (term.state) {
+    switch (term->state) {
       when NORMAL: {
         
         wchar wc;
 
-        if (term.curs.oem_acs && !memchr("\e\n\r\b", c, 4)) {
-          if (term.curs.oem_acs == 2)
+        if (term->curs.oem_acs && !memchr("\e\n\r\b", c, 4)) {
+          if (term->curs.oem_acs == 2)
             c |= 0x80;
+          term->gcb_prop = GCB_Other;
           write_char(cs_btowc_glyph(c), 1);
           continue;
         }
         
-        switch (cs_mb1towc(&wc, c)) {
+        switch (cs_mb1towc(&term->decoder, &wc, c)) {
           when 0: // NUL or low surrogate
             if (wc)
               pos--;
           when -1: // Encoding error
             write_error();
-            if (term.in_mb_char || term.high_surrogate)
+            if (term->in_mb_char || term->high_surrogate)
               pos--;
-            term.high_surrogate = 0;
-            term.in_mb_char = false;
-            cs_mb1towc(0, 0); // Clear decoder state
+            term->high_surrogate = 0;
+            term->in_mb_char = false;
+            cs_mb1towc(&term->decoder, 0, 0); // Clear decoder state
             continue;
           when -2: // Incomplete character
-            term.in_mb_char = true;
+            term->in_mb_char = true;
             continue;
         }
         
-        term.in_mb_char = false;
+        term->in_mb_char = false;
         
         // Fetch previous high surrogate 
-        wchar hwc = term.high_surrogate;
-        term.high_surrogate = 0;
+        wchar hwc = term->high_surrogate;
+        term->high_surrogate = 0;
         
         if (is_low_surrogate(wc)) {
           if (hwc) {
@@ -1097,8 +1372,7 @@ term_write(const char *buf, uint len)
             #else
             int width = xcwidth(combine_surrogates(hwc, wc));
             #endif
-            write_char(hwc, width);
-            write_char(wc, 0);
+            write_ucschar(combine_surrogates(hwc, wc), width);
           }
           else
             write_error();
@@ -1109,12 +1383,13 @@ term_write(const char *buf, uint len)
           write_error();
         
         if (is_high_surrogate(wc)) {
-          term.high_surrogate = wc;
+          term->high_surrogate = wc;
           continue;
         }
         
         // Control characters
         if (wc < 0x20 || wc == 0x7F) {
+          term->gcb_prop = GCB_Control;
           if (!do_ctrl(wc) && c == wc) {
             wc = cs_btowc_glyph(c);
             if (wc != c)
@@ -1130,7 +1405,7 @@ term_write(const char *buf, uint len)
         int width = xcwidth(wc);
         #endif
         
-        switch(term.curs.csets[term.curs.g1]) {
+        switch(term->curs.csets[term->curs.g1]) {
           when CSET_LINEDRW:
             if (0x60 <= wc && wc <= 0x7E)
               wc = win_linedraw_chars[wc - 0x60];
@@ -1139,17 +1414,17 @@ term_write(const char *buf, uint len)
               wc = 0xA3; // pound sign
           otherwise: ;
         }
-        write_char(wc, width);
+        write_ucschar(wc, width);
       }
       when ESCAPE or CMD_ESCAPE:
         if (c < 0x20)
           do_ctrl(c);
         else if (c < 0x30)
-          term.esc_mod = term.esc_mod ? 0xFF : c;
-        else if (c == '\\' && term.state == CMD_ESCAPE) {
+          add_esc_mod(c);
+        else if (c == '\\' && term->state == CMD_ESCAPE) {
           /* Process DCS or OSC sequence if we see ST. */
           do_cmd();
-          term.state = NORMAL;
+          term->state = NORMAL;
         }
         else
           do_esc(c);
@@ -1157,70 +1432,72 @@ term_write(const char *buf, uint len)
         if (c < 0x20)
           do_ctrl(c);
         else if (c == ';') {
-          if (term.csi_argc < lengthof(term.csi_argv))
-            term.csi_argc++;
+          if (term->csi_argc < lengthof(term->csi_argv))
+            term->csi_argc++;
         }
         else if (c >= '0' && c <= '9') {
-          uint i = term.csi_argc - 1;
-          if (i < lengthof(term.csi_argv))
-            term.csi_argv[i] = 10 * term.csi_argv[i] + c - '0';
+          uint i = term->csi_argc - 1;
+          if (i < lengthof(term->csi_argv))
+            term->csi_argv[i] = 10 * term->csi_argv[i] + c - '0';
         }
         else if (c < 0x40)
-          term.esc_mod = term.esc_mod ? 0xFF : c;
+          add_esc_mod(c);
         else {
           do_csi(c);
-          term.state = NORMAL;
+          term->state = NORMAL;
         }
       when OSC_START:
-        term.cmd_len = 0;
+        term->cmd_len = 0;
         switch (c) {
           when 'P':  /* Linux palette sequence */
-            term.state = OSC_PALETTE;
+            term->state = OSC_PALETTE;
           when 'R':  /* Linux palette reset */
             win_reset_colours();
-            term.state = NORMAL;
+            term->state = NORMAL;
           when '0' ... '9':  /* OSC command number */
-            term.cmd_num = c - '0';
-            term.state = OSC_NUM;
+            term->cmd_num = c - '0';
+            term->state = OSC_NUM;
           when ';':
-            term.cmd_num = 0;
-            term.state = CMD_STRING;
+            term->cmd_num = 0;
+            term->state = CMD_STRING;
           when '\a' or '\n' or '\r':
-            term.state = NORMAL;
+            term->state = NORMAL;
           when '\e':
-            term.state = ESCAPE;
+            term->state = ESCAPE;
           otherwise:
-            term.state = IGNORE_STRING;
+            term->state = IGNORE_STRING;
         }
       when OSC_NUM:
         switch (c) {
           when '0' ... '9':  /* OSC command number */
-            term.cmd_num = term.cmd_num * 10 + c - '0';
+            term->cmd_num = term->cmd_num * 10 + c - '0';
           when ';':
-            term.state = CMD_STRING;
+            term->state = CMD_STRING;
           when '\a' or '\n' or '\r':
-            term.state = NORMAL;
+            term->state = NORMAL;
           when '\e':
-            term.state = ESCAPE;
+            term->state = ESCAPE;
           otherwise:
-            term.state = IGNORE_STRING;
+            term->state = IGNORE_STRING;
         }
       when OSC_PALETTE:
         if (isxdigit(c)) {
           // The dodgy Linux palette sequence: keep going until we have
           // seven hexadecimal digits.
-          term.cmd_buf[term.cmd_len++] = c;
-          if (term.cmd_len == 7) {
+          term->cmd_buf[term->cmd_len++] = c;
+          if (term->cmd_len == 7) {
             uint n, r, g, b;
-            sscanf(term.cmd_buf, "%1x%2x%2x%2x", &n, &r, &g, &b);
-            win_set_colour(n, make_colour(r, g, b));
-            term.state = NORMAL;
+            sscanf(term->cmd_buf, "%1x%2x%2x%2x", &n, &r, &g, &b);
+            colour c = make_colour(r, g, b);
+            if (c != win_get_colour(n))
+              win_set_colour(n, c);
+            term->state = NORMAL;
           }
         }
         else {
           // End of sequence. Put the character back unless the sequence was 
           // terminated properly.
-          term.state = NORMAL;
+          term->state = NORMAL;
           if (c != '\a') {
             pos--;
             continue;
@@ -1229,28 +1506,72 @@ term_write(const char *buf, uint len)
       when CMD_STRING:
         switch (c) {
           when '\n' or '\r':
-            term.state = NORMAL;
+            term->state = NORMAL;
           when '\a':
             do_cmd();
-            term.state = NORMAL;
+            term->state = NORMAL;
           when '\e':
-            term.state = CMD_ESCAPE;
+            term->state = CMD_ESCAPE;
           otherwise:
-            if (term.cmd_len < lengthof(term.cmd_buf) - 1)
-              term.cmd_buf[term.cmd_len++] = c;
+            if (term->cmd_len < lengthof(term->cmd_buf) - 1)
+              term->cmd_buf[term->cmd_len++] = c;
         }
       when IGNORE_STRING:
         switch (c) {
           when '\n' or '\r' or '\a':
-            term.state = NORMAL;
+            term->state = NORMAL;
           when '\e':
-            term.state = ESCAPE;
+            term->state = ESCAPE;
         }
     }
   }
   win_schedule_update();
-  if (term.printing) {
-    printer_write(term.printbuf, term.printbuf_pos);
-    term.printbuf_pos = 0;
+  if (term->printing) {
+    printer_write(term->printbuf, term->printbuf_pos);
+    term->printbuf_pos = 0;
+  }
+}
+
+void
+term_write(const char *buf, uint len)
+{
+ /*
+  * During drag-selects, the view is frozen, so that the screen holds
+  * still for the user while output processing carries on behind it.
+  * The selection and scroll position belong to the frozen view, so
+  * output must leave them alone.
+  */
+  long long start = trace_begin();
+  term_update_cs();  // other terminals might have changed the charset
+  cc_collect(false);
+  if (term_selecting())
+    term_freeze();
+  else
+    term_thaw();
+
+  if (!term->frozen.on) {
+    process_output(buf, len);
+    trace_latency(LAT_PARSE);
+    trace_end("term_write", start, len);
+    return;
+  }
+
+  bool selected = term->selected;
+  pos sel_start = term->sel_start, sel_end = term->sel_end;
+  pos sel_anchor = term->sel_anchor;
+  int disptop = term->disptop;
+
+  process_output(buf, len);
+
+  if (term->frozen.on) {
+    if (selected && !term->selected)
+      term->frozen.deselected = true;
+    term->selected = selected;
+    term->sel_start = sel_start;
+    term->sel_end = sel_end;
+    term->sel_anchor = sel_anchor;
+    term->disptop = disptop;
   }
+  trace_latency(LAT_PARSE);
+  trace_end("term_write", start, len);
 }
@@ -0,0 +1,108 @@
+#!/bin/sh
+# Golden screenshot tests for the display pipeline, run by 'make check'.
+#
+# Each test feeds its input through mintty-headless on a small screen and
+# compares the final screen with the golden image NAME.ppm in this
+# directory. Tests that don't depend on timing run twice: a byte at a
+# time, so that the output goes through the incremental paint paths for
+# scrolling, cursor movement and overlays, and all at once, for a single
+# full paint. After an intended change in rendering, regenerate the golden
+# images with -u, and look at them before committing.
+
+cd "$(dirname "$0")" || exit 2
+headless=../mintty-headless
+update=false
+[ "$1" = -u ] && update=true
+
+tmp=$(mktemp -d) || exit 2
+trap 'rm -rf "$tmp"' EXIT
+failed=0
+
+# check NAME CHUNKS [OPTION]...
+# Run the input in $tmp/in with each of the given chunk sizes.
+check() {
+  name=$1 chunks=$2
+  shift 2
+  for chunk in $chunks; do
+    out=$tmp/$name-$chunk.ppm
+    "$headless" -q -s 32x8 -c "$chunk" "$@" -o "$out" "$tmp/in" || exit 2
+    if $update && [ "$chunk" = "${chunks%% *}" ]; then
+      cp "$out" "$name.ppm"
+    fi
+    if cmp -s "$out" "$name.ppm"; then
+      echo "PASS: $name (chunk $chunk)"
+    else
+      echo "FAIL: $name (chunk $chunk)"
+      failed=$((failed + 1))
+    fi
+  done
+}
+
+all="1 65536"
+
+# Scrolling by whole lines, which is done by moving pixels.
+i=1
+while [ $i -le 30 ]; do
+  printf '\033[3%dmline %d\033[m of scrolling output\r\n' $((i % 8)) $i
+  i=$((i + 1))
+done >"$tmp/in"
+check scroll "$all"
+
+# Scrolling within margins, up and down.
+{
+  printf 'top line\r\n\033[8;1Hbottom line\033[2;7r\033[2;1H'
+  i=1
+  while [ $i -le 12 ]; do
+    printf 'region %d\r\n' $i
+    i=$((i + 1))
+  done
+  printf '\033[2;1H\033MMoved down\033M\033MTwice more\033[r'
+} >"$tmp/in"
+check region "$all"
+
+# Attributes and colours, and a palette change, which has to invalidate
+# cached colours.
+{
+  printf '\033[1mbold\033[2m dim\033[22;7m rev\033[27;8m hid\033[28;4m ul\033[m\r\n'
+  for c in 0 1 2 3 4 5 6 7; do printf '\033[3%d;4%dm%d\033[9%dm%d' $c $((7 - c)) $c $c $c; done
+  printf '\033[m\r\n'
+  for c in 16 52 88 124 160 196 202 208 214 220 226; do printf '\033[48;5;%dm ' $c; done
+  printf '\033[m\r\n\033[31mred turned green\033[m\r\n\033]4;1;#00ff00\007'
+  printf '\033]10;#ffff80\007\033]11;#000040\007\033]12;#ff00ff\007'
+} >"$tmp/in"
+check colours "$all"
+
+# Reverse video for the whole screen.
+printf 'Normal \033[7mreverse\033[m\r\n\033[?5h' >"$tmp/in"
+check rvideo "$all"
+
+# Double width and height lines, and line drawing characters.
+printf '\033#6wide\r\n\033#3tall\r\n\033#4tall\r\n\033(0lqqk\r\nx  x\r\nmqqj\033(B' \
+  >"$tmp/in"
+check lines "$all"
+
+# Cursor movement with the text in between left alone.
+{
+  printf 'abcdefghij\r\nklmnopqrst\r\nuvwxyz'
+  printf '\033[1;5H\033[2;2H\033[3;9H\033[K\033[1;1H\033[5C\033[B\033[D'
+} >"$tmp/in"
+check cursor "$all"
+
+# Blinking text and cursor at given moments, so only a byte at a time,
+# as the time taken depends on the number of updates.
+printf 'steady \033[5mblinking\033[m steady\r\n\033[5;7mblinking too\033[m' \
+  >"$tmp/in"
+check blink-on 1 -b -i 1700
+check blink-off 1 -b -i 1900
+
+# Selections, which are overlays on the screen.
+printf 'first line of text\r\nsecond line of text\r\nthird line\r\nfourth' \
+  >"$tmp/in"
+check select "$all" -S 6,0,5,2
+check select-block "$all" -B 2,1,8,3
+
+# The visual bell reverses the screen, and the selection with it.
+printf 'some text\r\nmore text\r\n\007' >"$tmp/in"
+check vbell "$all" -f -S 2,0,4,1
+
+[ $failed = 0 ] || { echo "$failed failed"; exit 1; }
@@ -0,0 +1,191 @@
+// trace.c (part of mintty)
+// Licensed under the terms of the GNU General Public License v3 or later.
+
+#include "trace.h"
+
+#include "config.h"
+
+#include <pthread.h>
+#include <time.h>
+
+bool tracing;
+
+/*
+ * Each thread records into a ring of its own, so recording needs no
+ * locking. The rings are kept on a list that's only ever added to, and
+ * a ring left behind by a thread that has finished is taken over by the
+ * next thread that needs one.
+ *
+ * The head counts the spans ever recorded into a ring. It's only
+ * advanced once a span has been written, so a reader can tell which
+ * spans might have been overwritten while it was copying them.
+ */
+enum { RING_SIZE = 1 << 15 };
+
+typedef struct {
+  string name;
+  long long start, dur;  // nanoseconds
+  long long arg;
+} span;
+
+typedef struct ring {
+  struct ring *next;
+  uint tid;
+  string thread_name;
+  bool owned;            // shared
+  long long head;        // shared
+  span spans[RING_SIZE];
+} ring;
+
+static ring *rings;      // shared
+static uint num_rings;   // shared
+static __thread ring *own_ring;
+static pthread_key_t ring_key;
+static pthread_once_t ring_key_once = PTHREAD_ONCE_INIT;
+
+static long long start_time;
+
+long long
+trace_clock(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void
+release_ring(void *r)
+{
+  __atomic_store_n(&((ring *)r)->owned, false, __ATOMIC_RELEASE);
+}
+
+static void
+make_ring_key(void)
+{
+  pthread_key_create(&ring_key, release_ring);
+}
+
+static ring *
+get_ring(void)
+{
+  if (own_ring)
+    return own_ring;
+
+  pthread_once(&ring_key_once, make_ring_key);
+
+  ring *r = __atomic_load_n(&rings, __ATOMIC_ACQUIRE);
+  for (; r; r = r->next) {
+    bool owned = false;
+    if (__atomic_compare_exchange_n(&r->owned, &owned, true, false,
+                                    __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+      break;
+  }
+  if (r)
+    r->thread_name = 0;
+  else {
+    r = new(ring);
+    r->tid = __atomic_add_fetch(&num_rings, 1, __ATOMIC_RELAXED);
+    r->thread_name = 0;
+    r->owned = true;
+    r->head = 0;
+    r->next = __atomic_load_n(&rings, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&rings, &r->next, r, true,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+  }
+  pthread_setspecific(ring_key, r);
+  return own_ring = r;
+}
+
+void
+trace_record(string name, long long start, long long arg)
+{
+  long long now = trace_clock();
+  ring *r = get_ring();
+  long long head = r->head;
+  r->spans[head % RING_SIZE] =
+    (span){.name = name, .start = start, .dur = now - start, .arg = arg};
+  __atomic_store_n(&r->head, head + 1, __ATOMIC_RELEASE);
+}
+
+void
+trace_thread_name(string name)
+{
+  if (__atomic_load_n(&tracing, __ATOMIC_RELAXED))
+    get_ring()->thread_name = name;
+}
+
+static void
+dump_at_exit(void)
+{
+  trace_dump(cfg.trace_file);
+}
+
+void
+trace_enable(bool enable)
+{
+  static bool dump_registered;
+  if (enable) {
+    // Spans can't be cleared while other threads might be recording,
+    // so older ones are skipped when dumping instead.
+    start_time = trace_clock();
+    if (!dump_registered && *cfg.trace_file) {
+      atexit(dump_at_exit);
+      dump_registered = true;
+    }
+  }
+  __atomic_store_n(&tracing, enable, __ATOMIC_RELAXED);
+  trace_thread_name("main");
+}
+
+bool
+trace_dump(string filename)
+{
+  if (!*filename)
+    return false;
+  FILE *file = fopen(filename, "w");
+  if (!file)
+    return false;
+
+  fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", file);
+  bool first = true;
+  int pid = getpid();
+  span *spans = newn(span, RING_SIZE);
+  for (ring *r = __atomic_load_n(&rings, __ATOMIC_ACQUIRE); r; r = r->next) {
+    long long head = __atomic_load_n(&r->head, __ATOMIC_ACQUIRE);
+    long long tail = head > RING_SIZE ? head - RING_SIZE : 0;
+    for (long long i = tail; i < head; i++)
+      spans[i % RING_SIZE] = r->spans[i % RING_SIZE];
+
+    // Drop the spans that might have been overwritten meanwhile.
+    long long new_head = __atomic_load_n(&r->head, __ATOMIC_ACQUIRE);
+    if (new_head >= RING_SIZE)
+      tail = max(tail, new_head - RING_SIZE + 1);
+
+    char name[32];
+    if (r->thread_name)
+      snprintf(name, sizeof name, "%s", r->thread_name);
+    else
+      sprintf(name, "thread %u", r->tid);
+    fprintf(file,
+      "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%i,\"tid\":%u,"
+      "\"args\":{\"name\":\"%s\"}}",
+      first ? "" : ",\n", pid, r->tid, name
+    );
+    first = false;
+
+    for (long long i = tail; i < head; i++) {
+      span *s = &spans[i % RING_SIZE];
+      if (s->start < start_time)
+        continue;
+      fprintf(file,
+        ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":%i,\"tid\":%u,"
+        "\"ts\":%lli.%03lli,\"dur\":%lli.%03lli,\"args\":{\"n\":%lli}}",
+        s->name, pid, r->tid, s->start / 1000, s->start % 1000,
+        s->dur / 1000, s->dur % 1000, s->arg
+      );
+    }
+  }
+  free(spans);
+  fputs("\n]}\n", file);
+  return !fclose(file);
+}
@@ -0,0 +1,43 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+/*
+ * Timeline tracing.
+ *
+ * When enabled, spans of time taken by the main stages of the event loop
+ * are recorded into a ring buffer for each thread, and can be written to
+ * a file in the Chrome trace event format for viewing in chrome://tracing
+ * or Perfetto. Timestamps are from the monotonic clock, so the trace can
+ * be lined up with system traces.
+ */
+
+extern bool tracing;
+
+long long trace_clock(void);
+void trace_record(string name, long long start, long long arg);
+
+// Start a span, returning 0 if tracing is off.
+static inline long long
+trace_begin(void)
+{
+  return __atomic_load_n(&tracing, __ATOMIC_RELAXED) ? trace_clock() : 0;
+}
+
+// End a span started by trace_begin(). The name must be a literal.
+// The argument, e.g. a byte count, is shown with the span.
+static inline void
+trace_end(string name, long long start, long long arg)
+{
+  if (start)
+    trace_record(name, start, arg);
+}
+
+// Name the calling thread in the trace.
+void trace_thread_name(string);
+
+// Enabling starts afresh; disabling keeps the spans recorded so far.
+void trace_enable(bool);
+
+bool trace_dump(string filename);
+
+#endif
@@ -5,10 +5,14 @@
 
 void win_reconfig(bool font_changed);
 
+void win_close_pane(void);
+
 void win_update(void);
+void win_update_overlays(void);
 void win_schedule_update(void);
 
-void win_text(int x, int y, wchar *text, int len, uint attr, int lattr);
+void win_draw(draw_list *);
+void win_scroll_rect(int top, int bottom, int lines);
 void win_update_mouse(void);
 void win_capture_mouse(void);
 void win_bell(void);
@@ -45,6 +49,21 @@ void win_check_glyphs(wchar *wcs, uint num);
 
 void win_open(wstring path);
 void win_copy(const wchar *data, uint *attrs, int len);
+
+// Clipboard data can be prepared away from the main thread, using colours
+// and settings captured beforehand on the main thread. Preparation stops
+// early, returning null, if the cancel flag is set meanwhile.
+typedef struct {
+  bool as_rtf, bold_as_font, bold_as_colour;
+  char font_name[32];  // the longest face name Windows allows
+  int font_size;
+  colour palette[COLOUR_NUM];
+} copy_style;
+typedef struct clip_data clip_data;
+void win_get_copy_style(copy_style *);
+clip_data *win_prepare_copy(const wchar *data, uint *attrs, int len,
+                            const copy_style *, const bool *cancel);
+void win_finish_copy(clip_data *, bool to_clipboard);
 void win_paste(void);
 
 void win_set_timer(void_fn cb, uint ticks);
@@ -58,7 +77,6 @@ int get_tick_count(void);
 int cursor_blink_ticks(void);
 
 int win_char_width(xchar);
-wchar win_combine_chars(wchar bc, wchar cc);
 extern wchar win_linedraw_chars[31];
 
 #endif
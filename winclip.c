@@ -62,12 +62,40 @@ win_open(wstring wpath)
 }
 
 
+struct clip_data {
+  HGLOBAL text, ansi, rtf;
+};
+
 void
-win_copy(const wchar *data, uint *attrs, int len)
+win_get_copy_style(copy_style *style)
+{
+  style->as_rtf = cfg.copy_as_rtf;
+  style->bold_as_font = cfg.bold_as_font;
+  style->bold_as_colour = cfg.bold_as_colour;
+  snprintf(style->font_name, sizeof style->font_name, "%s", cfg.font.name);
+  style->font_size = cfg.font.size;
+  memcpy(style->palette, colours, sizeof style->palette);
+}
+
+/*
+ * Convert text to the clipboard formats. This doesn't touch the window,
+ * the config or the palette, so it can be done on a background thread
+ * for large copies.
+ */
+clip_data *
+win_prepare_copy(const wchar *data, uint *attrs, int len,
+                 const copy_style *style, const bool *cancel)
 {
   HGLOBAL clipdata, clipdata2, clipdata3 = 0;
   int len2;
   void *lock, *lock2, *lock3;
+  char *rtf = null;
+
+  // Check for cancellation every few thousand characters.
+  bool cancelled(int i) {
+    return
+      cancel && !(i & 0xFFF) && __atomic_load_n(cancel, __ATOMIC_RELAXED);
+  }
 
   len2 = WideCharToMultiByte(CP_ACP, 0, data, len, 0, 0, null, null);
 
@@ -79,19 +107,18 @@ win_copy(const wchar *data, uint *attrs, int len)
       GlobalFree(clipdata);
     if (clipdata2)
       GlobalFree(clipdata2);
-    return;
+    return 0;
   }
   if (!(lock = GlobalLock(clipdata)))
-    return;
+    return 0;
   if (!(lock2 = GlobalLock(clipdata2)))
-    return;
+    return 0;
 
   memcpy(lock, data, len * sizeof (wchar));
   WideCharToMultiByte(CP_ACP, 0, data, len, lock2, len2, null, null);
 
-  if (attrs && cfg.copy_as_rtf) {
+  if (attrs && style->as_rtf) {
     wchar unitab[256];
-    char *rtf = null;
     uchar *tdata = (uchar *) lock2;
     wchar *udata = (wchar_t *) lock;
     int rtflen = 0, uindex = 0, tindex = 0;
@@ -109,11 +136,11 @@ win_copy(const wchar *data, uint *attrs, int len)
       MultiByteToWideChar(CP_ACP, MB_ERR_INVALID_CHARS,
                           (char[]){i}, 1, unitab + i, 1);
 
-    rtfsize = 100 + strlen(cfg.font.name);
+    rtfsize = 100 + strlen(style->font_name);
     rtf = newn(char, rtfsize);
     rtflen = sprintf(rtf,
       "{\\rtf1\\ansi\\deff0{\\fonttbl{\\f0\\fmodern %s;}}\\f0\\fs%d",
-      cfg.font.name, cfg.font.size * 2);
+      style->font_name, style->font_size * 2);
 
    /*
     * Add colour palette
@@ -126,28 +153,19 @@ win_copy(const wchar *data, uint *attrs, int len)
     */
     memset(palette, 0, sizeof (palette));
     for (int i = 0; i < (len - 1); i++) {
+      if (cancelled(i))
+        goto cancelled;
       uint attr = attrs[i];
-      fgcolour = (attr & ATTR_FGMASK) >> ATTR_FGSHIFT;
-      bgcolour = (attr & ATTR_BGMASK) >> ATTR_BGSHIFT;
-
+      colour_i fgi, bgi;
+      term_colour_indices_as(attr, false, style->bold_as_colour,
+                             style->bold_as_font, &fgi, &bgi);
       if (attr & ATTR_REVERSE) {
-        int tmpcolour = fgcolour;     /* Swap foreground and background */
-        fgcolour = bgcolour;
-        bgcolour = tmpcolour;
+        fgcolour = bgi;     /* Swap foreground and background */
+        bgcolour = fgi;
       }
-
-      if ((attr & ATTR_BOLD) && cfg.bold_as_colour) {
-        if (fgcolour < 8)     /* ANSI colours */
-          fgcolour += 8;
-        else if (fgcolour >= 256 && !cfg.bold_as_font)  /* Default colours */
-          fgcolour |= 1;
-      }
-
-      if (attr & ATTR_BLINK) {
-        if (bgcolour < 8)     /* ANSI colours */
-          bgcolour += 8;
-        else if (bgcolour >= 256)     /* Default colours */
-          bgcolour |= 1;
+      else {
+        fgcolour = fgi;
+        bgcolour = bgi;
       }
 
       if (attr & ATTR_INVISIBLE)
@@ -169,7 +187,8 @@ win_copy(const wchar *data, uint *attrs, int len)
    /*
     * Finally - Write the colour table
     */
-    rtf = renewn(rtf, rtfsize + (numcolours * 25));
+    rtfsize += numcolours * 25;
+    rtf = renewn(rtf, rtfsize);
     strcat(rtf, "{\\colortbl ;");
     rtflen = strlen(rtf);
 
@@ -177,9 +196,9 @@ win_copy(const wchar *data, uint *attrs, int len)
       if (palette[i] != 0) {
         rtflen +=
           sprintf(&rtf[rtflen], "\\red%d\\green%d\\blue%d;",
-                  GetRValue(colours[i]),
-                  GetGValue(colours[i]),
-                  GetBValue(colours[i]));
+                  GetRValue(style->palette[i]),
+                  GetGValue(style->palette[i]),
+                  GetBValue(style->palette[i]));
       }
     }
     strcpy(&rtf[rtflen], "}");
@@ -205,6 +224,9 @@ win_copy(const wchar *data, uint *attrs, int len)
     */
     while (tindex < len2 && uindex < len && tdata[tindex] && udata[uindex]) {
 
+      if (cancelled(uindex))
+        goto cancelled;
+
      /* Skip carriage returns */
       if (tdata[tindex] == '\r')
         tindex++, uindex++;
@@ -217,37 +239,26 @@ win_copy(const wchar *data, uint *attrs, int len)
         uint attr = attrs[uindex];
 
         if (rtfsize < rtflen + 64) {
-          rtfsize = rtflen + 512;
+          rtfsize = max(rtfsize * 2, rtflen + 512);
           rtf = renewn(rtf, rtfsize);
         }
 
        /*
         * Determine foreground and background colours
         */
-        fgcolour = (attr & ATTR_FGMASK) >> ATTR_FGSHIFT;
-        bgcolour = (attr & ATTR_BGMASK) >> ATTR_BGSHIFT;
-
+        colour_i fgi, bgi;
+        term_colour_indices_as(attr, false, style->bold_as_colour,
+                               style->bold_as_font, &fgi, &bgi);
         if (attr & ATTR_REVERSE) {
-          int tmpcolour = fgcolour;     /* Swap foreground and background */
-          fgcolour = bgcolour;
-          bgcolour = tmpcolour;
+          fgcolour = bgi;     /* Swap foreground and background */
+          bgcolour = fgi;
         }
-
-        if ((attr & ATTR_BOLD) && cfg.bold_as_colour) {
-          if (fgcolour < 8)     /* ANSI colours */
-            fgcolour += 8;
-          else if (fgcolour >= 256 && !cfg.bold_as_font)  /* Default colours */
-            fgcolour |= 1;
-        }
-
-        if (attr & ATTR_BLINK) {
-          if (bgcolour < 8)     /* ANSI colours */
-            bgcolour += 8;
-          else if (bgcolour >= 256)     /* Default colours */
-            bgcolour |= 1;
+        else {
+          fgcolour = fgi;
+          bgcolour = bgi;
         }
 
-        attrBold = cfg.bold_as_font ? (attr & ATTR_BOLD) : 0;
+        attrBold = style->bold_as_font ? (attr & ATTR_BOLD) : 0;
         attrUnder = attr & ATTR_UNDER;
 
        /*
@@ -262,7 +273,7 @@ win_copy(const wchar *data, uint *attrs, int len)
             bgcolour = -1;      /* No coloring */
 
           if (fgcolour >= 256) {        /* Default colour */
-            if (cfg.bold_as_colour && (fgcolour & 1) && bgcolour == -1)
+            if (style->bold_as_colour && (fgcolour & 1) && bgcolour == -1)
               attrBold = ATTR_BOLD;     /* Emphasize text with bold attribute */
 
             fgcolour = -1;      /* No coloring */
@@ -336,7 +347,7 @@ win_copy(const wchar *data, uint *attrs, int len)
       }
 
       if (rtfsize < rtflen + totallen + 3) {
-        rtfsize = rtflen + totallen + 512;
+        rtfsize = max(rtfsize * 2, rtflen + totallen + 512);
         rtf = renewn(rtf, rtfsize);
       }
 
@@ -380,18 +391,48 @@ win_copy(const wchar *data, uint *attrs, int len)
   GlobalUnlock(clipdata);
   GlobalUnlock(clipdata2);
 
-  if (OpenClipboard(wnd)) {
+  clip_data *clip = new(clip_data);
+  *clip = (clip_data){clipdata, clipdata2, clipdata3};
+  return clip;
+
+  cancelled:
+  free(rtf);
+  GlobalUnlock(clipdata);
+  GlobalUnlock(clipdata2);
+  GlobalFree(clipdata);
+  GlobalFree(clipdata2);
+  return 0;
+}
+
+/* Put prepared data on the clipboard, or just discard it. */
+void
+win_finish_copy(clip_data *clip, bool to_clipboard)
+{
+  if (!clip)
+    return;
+  if (to_clipboard && OpenClipboard(wnd)) {
     EmptyClipboard();
-    SetClipboardData(CF_UNICODETEXT, clipdata);
-    SetClipboardData(CF_TEXT, clipdata2);
-    if (clipdata3)
-      SetClipboardData(RegisterClipboardFormat(CF_RTF), clipdata3);
+    SetClipboardData(CF_UNICODETEXT, clip->text);
+    SetClipboardData(CF_TEXT, clip->ansi);
+    if (clip->rtf)
+      SetClipboardData(RegisterClipboardFormat(CF_RTF), clip->rtf);
     CloseClipboard();
   }
   else {
-    GlobalFree(clipdata);
-    GlobalFree(clipdata2);
+    GlobalFree(clip->text);
+    GlobalFree(clip->ansi);
+    if (clip->rtf)
+      GlobalFree(clip->rtf);
   }
+  delete(clip);
+}
+
+void
+win_copy(const wchar *data, uint *attrs, int len)
+{
+  copy_style style;
+  win_get_copy_style(&style);
+  win_finish_copy(win_prepare_copy(data, attrs, len, &style, 0), true);
 }
 
 static void
@@ -478,10 +519,11 @@ paste_text(HANDLE data)
 {
   char *cs = GlobalLock(data);
   uint l = MultiByteToWideChar(CP_ACP, 0, cs, -1, 0, 0) - 1;
-  wchar s[l];
+  wchar *s = newn(wchar, max(l, 1u));
   MultiByteToWideChar(CP_ACP, 0, cs, -1, s, l);
   GlobalUnlock(data);
   term_paste(s, l);
+  free(s);
 }
 
 void
@@ -490,7 +532,7 @@ win_paste(void)
   if (!OpenClipboard(null))
     return;  
   HGLOBAL data;
-  term.selected = false;
+  term->selected = false;
   if ((data = GetClipboardData(CF_HDROP)))
     paste_hdrop(data);
   else if ((data = GetClipboardData(CF_UNICODETEXT)))
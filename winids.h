@@ -20,5 +20,10 @@
 #define IDM_OPTIONS     0x0090
 #define IDM_NEW         0x00a0
 #define IDM_COPYTITLE   0x00b0
+#define IDM_COUNTERS    0x00c0
+#define IDM_SPLITRIGHT  0x00d0
+#define IDM_SPLITDOWN   0x00e0
+#define IDM_NEXTPANE    0x00f0
+#define IDM_CLOSEPANE   0x0100
 
 #endif
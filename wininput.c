@@ -6,6 +6,7 @@
 
 #include "charset.h"
 #include "child.h"
+#include "latency.h"
 
 #include <math.h>
 #include <windowsx.h>
@@ -17,7 +18,7 @@ static HMENU menu, sysmenu;
 void
 win_update_menus(void)
 {
-  bool shorts = !term.shortcut_override;
+  bool shorts = !term->shortcut_override;
   bool clip = shorts && cfg.clip_shortcuts;
   bool alt_fn = shorts && cfg.alt_fn_shortcuts;
   bool ct_sh = shorts && cfg.ctrl_shift_shortcuts;
@@ -31,7 +32,7 @@ win_update_menus(void)
     alt_fn ? "&Close\tAlt+F4" : ct_sh ? "&Close\tCtrl+Shift+W" : "&Close"
   );
 
-  uint sel_enabled = term.selected ? MF_ENABLED : MF_GRAYED;
+  uint sel_enabled = term->selected ? MF_ENABLED : MF_GRAYED;
   EnableMenuItem(menu, IDM_OPEN, sel_enabled);
   ModifyMenu(
     menu, IDM_COPY, sel_enabled, IDM_COPY,
@@ -54,7 +55,7 @@ win_update_menus(void)
   );
 
   uint defsize_enabled = 
-    IsZoomed(wnd) || term.cols != cfg.cols || term.rows != cfg.rows
+    IsZoomed(wnd) || root_pane->cols != cfg.cols || root_pane->rows != cfg.rows
     ? MF_ENABLED : MF_GRAYED;
   ModifyMenu(
     menu, IDM_DEFSIZE, defsize_enabled, IDM_DEFSIZE,
@@ -69,13 +70,17 @@ win_update_menus(void)
     ct_sh ? "&Full Screen\tCtrl+Shift+F" : "&Full Screen"
   );
 
-  uint otherscreen_checked = term.show_other_screen ? MF_CHECKED : MF_UNCHECKED;
+  uint otherscreen_checked = term->show_other_screen ? MF_CHECKED : MF_UNCHECKED;
   ModifyMenu(
     menu, IDM_FLIPSCREEN, otherscreen_checked, IDM_FLIPSCREEN,
     alt_fn ? "Flip &Screen\tAlt+F12" :
     ct_sh ? "Flip &Screen\tCtrl+Shift+S" : "Flip &Screen"
   );
 
+  uint panes_enabled = root_pane->first ? MF_ENABLED : MF_GRAYED;
+  EnableMenuItem(menu, IDM_NEXTPANE, panes_enabled);
+  EnableMenuItem(menu, IDM_CLOSEPANE, panes_enabled);
+
   uint options_enabled = config_wnd ? MF_GRAYED : MF_ENABLED;
   EnableMenuItem(menu, IDM_OPTIONS, options_enabled);
   EnableMenuItem(sysmenu, IDM_OPTIONS, options_enabled);
@@ -97,10 +102,16 @@ win_init_menus(void)
   AppendMenu(menu, MF_ENABLED | MF_UNCHECKED, IDM_FULLSCREEN, 0);
   AppendMenu(menu, MF_ENABLED | MF_UNCHECKED, IDM_FLIPSCREEN, 0);
   AppendMenu(menu, MF_SEPARATOR, 0, 0);
+  AppendMenu(menu, MF_ENABLED, IDM_SPLITRIGHT, "Split Side &by Side");
+  AppendMenu(menu, MF_ENABLED, IDM_SPLITDOWN, "Split &Top and Bottom");
+  AppendMenu(menu, MF_ENABLED, IDM_NEXTPANE, "Ne&xt Pane");
+  AppendMenu(menu, MF_ENABLED, IDM_CLOSEPANE, "Clos&e Pane");
+  AppendMenu(menu, MF_SEPARATOR, 0, 0);
   AppendMenu(menu, MF_ENABLED, IDM_OPTIONS, "&Options...");
 
   sysmenu = GetSystemMenu(wnd, false);
   InsertMenu(sysmenu, SC_CLOSE, MF_ENABLED, IDM_COPYTITLE, "Copy &Title");
+  InsertMenu(sysmenu, SC_CLOSE, MF_ENABLED, IDM_COUNTERS, "&Counters...");
   InsertMenu(sysmenu, SC_CLOSE, MF_ENABLED, IDM_OPTIONS, "&Options...");
   InsertMenu(sysmenu, SC_CLOSE, MF_ENABLED, IDM_NEW, 0);
   InsertMenu(sysmenu, SC_CLOSE, MF_SEPARATOR, 0, 0);
@@ -142,15 +153,20 @@ get_mods(void)
 static void
 update_mouse(mod_keys mods)
 {
-  static bool app_mouse;
+  static bool app_mouse, copying;
   bool new_app_mouse = 
-    term.mouse_mode && !term.show_other_screen &&
+    term->mouse_mode && !term->show_other_screen &&
     cfg.clicks_target_app ^ ((mods & cfg.click_target_mod) != 0);
-  if (new_app_mouse != app_mouse) {
-    HCURSOR cursor = LoadCursor(null, new_app_mouse ? IDC_ARROW : IDC_IBEAM);
+  // Show that a background copy is in progress.
+  bool new_copying = term_copy_progress() >= 0;
+  if (new_app_mouse != app_mouse || new_copying != copying) {
+    HCURSOR cursor = LoadCursor(null,
+      new_copying ? IDC_APPSTARTING : new_app_mouse ? IDC_ARROW : IDC_IBEAM
+    );
     SetClassLongPtr(wnd, GCLP_HCURSOR, (LONG_PTR)cursor);
     SetCursor(cursor);
     app_mouse = new_app_mouse;
+    copying = new_copying;
   }
 }
 
@@ -187,8 +203,8 @@ static pos
 translate_pos(int x, int y)
 {
   return (pos){
-    .x = floorf((x - PADDING) / (float)font_width ),
-    .y = floorf((y - PADDING) / (float)font_height), 
+    .x = floorf((x - PADDING) / (float)font_width ) - active_pane->x,
+    .y = floorf((y - PADDING) / (float)font_height) - active_pane->y, 
   };
 }
 
@@ -210,6 +226,12 @@ win_mouse_click(mouse_button b, LPARAM lp)
   static pos last_click_pos;
 
   win_show_mouse();
+
+  // Clicking a pane activates it.
+  pane *clicked = win_pane_at(GET_X_LPARAM(lp), GET_Y_LPARAM(lp));
+  if (clicked)
+    win_activate_pane(clicked);
+
   mod_keys mods = get_mods();
   pos p = get_mouse_pos(lp);
   
@@ -277,6 +299,8 @@ send_syscommand(WPARAM cmd)
 bool 
 win_key_down(WPARAM wp, LPARAM lp)
 {
+  trace_latency(LAT_KEY);
+
   uint key = wp;
 
   if (key == VK_PROCESSKEY) {
@@ -350,12 +374,14 @@ win_key_down(WPARAM wp, LPARAM lp)
     return 1;
   }
   
-  // Exit when pressing Enter or Escape while holding the window open after
-  // the child process has died.
-  if ((key == VK_RETURN || key == VK_ESCAPE) && !mods && !child_is_alive())
-    exit(0);
+  // Close the pane, or exit if it's the last one, when pressing Enter or
+  // Escape while holding it open after the child process has died.
+  if ((key == VK_RETURN || key == VK_ESCAPE) && !mods && !child_is_alive()) {
+    win_close_pane();
+    return 1;
+  }
   
-  if (!term.shortcut_override) {
+  if (!term->shortcut_override) {
 
     // Copy&paste
     if (cfg.clip_shortcuts && key == VK_INSERT && mods && !alt) {
@@ -424,7 +450,7 @@ win_key_down(WPARAM wp, LPARAM lp)
     }
     
     // Scrollback
-    if (!term.on_alt_screen || term.show_other_screen) {
+    if (!term->on_alt_screen || term->show_other_screen) {
       mod_keys scroll_mod = cfg.scroll_mod ?: 8;
       if (cfg.pgupdn_scroll && (key == VK_PRIOR || key == VK_NEXT) &&
           !(mods & ~scroll_mod))
@@ -489,7 +515,7 @@ win_key_down(WPARAM wp, LPARAM lp)
     // Mintty-specific: produce app_pad codes not only when vt220 mode is on,
     // but also in PC-style mode when app_cursor_keys is off, to allow the
     // numpad keys to be distinguished from the cursor/editing keys.
-    if (term.app_keypad && (!term.app_cursor_keys || term.vt220_keys)) {
+    if (term->app_keypad && (!term->app_cursor_keys || term->vt220_keys)) {
       // If NumLock is on, Shift must have been pressed to override it and
       // get a VK code for an editing or cursor key code.
       if (numlock)
@@ -507,7 +533,7 @@ win_key_down(WPARAM wp, LPARAM lp)
   
   void cursor_key(char code, char symbol) {
     if (!app_pad_key(symbol))
-      mods ? mod_csi(code) : term.app_cursor_keys ? ss3(code) : csi(code);
+      mods ? mod_csi(code) : term->app_cursor_keys ? ss3(code) : csi(code);
   }
 
   // Keyboard layout
@@ -615,7 +641,7 @@ win_key_down(WPARAM wp, LPARAM lp)
       if (try_key())
         return true;
       shift = is_key_down(VK_SHIFT);
-      if (shift || (key >= '0' && key <= '9' && !term.modify_other_keys)) {
+      if (shift || (key >= '0' && key <= '9' && !term->modify_other_keys)) {
         kbd[VK_SHIFT] ^= 0x80;
         if (try_key())
           return true;
@@ -637,22 +663,22 @@ win_key_down(WPARAM wp, LPARAM lp)
   
   switch(key) {
     when VK_RETURN:
-      if (extended && !numlock && term.app_keypad)
+      if (extended && !numlock && term->app_keypad)
         mod_ss3('M');
-      else if (!extended && term.modify_other_keys && (shift || ctrl))
+      else if (!extended && term->modify_other_keys && (shift || ctrl))
         other_code('\r');
       else if (!ctrl)
         esc_if(alt),
-        term.newline_mode ? ch('\r'), ch('\n') : ch(shift ? '\n' : '\r');
+        term->newline_mode ? ch('\r'), ch('\n') : ch(shift ? '\n' : '\r');
       else
         ctrl_ch(CTRL('^'));
     when VK_BACK:
       if (!ctrl)
-        esc_if(alt), ch(term.backspace_sends_bs ? '\b' : CDEL);
-      else if (term.modify_other_keys)
-        other_code(term.backspace_sends_bs ? '\b' : CDEL);
+        esc_if(alt), ch(term->backspace_sends_bs ? '\b' : CDEL);
+      else if (term->modify_other_keys)
+        other_code(term->backspace_sends_bs ? '\b' : CDEL);
       else
-        ctrl_ch(term.backspace_sends_bs ? CDEL : CTRL('_'));
+        ctrl_ch(term->backspace_sends_bs ? CDEL : CTRL('_'));
     when VK_TAB:
       if (alt)
         return 0;
@@ -663,17 +689,17 @@ win_key_down(WPARAM wp, LPARAM lp)
         return 1;
       }
       else
-        term.modify_other_keys ? other_code('\t') : mod_csi('I');        
+        term->modify_other_keys ? other_code('\t') : mod_csi('I');        
     when VK_ESCAPE:
-      term.app_escape_key
+      term->app_escape_key
       ? ss3('[')
-      : ctrl_ch(term.escape_sends_fs ? CTRL('\\') : CTRL('['));
+      : ctrl_ch(term->escape_sends_fs ? CTRL('\\') : CTRL('['));
     when VK_PAUSE:
       ctrl_ch(ctrl & !extended ? CTRL('\\') : CTRL(']'));
     when VK_CANCEL:
       ctrl_ch(CTRL('\\'));
     when VK_F1 ... VK_F24:
-      if (term.vt220_keys && ctrl && VK_F3 <= key && key <= VK_F10)
+      if (term->vt220_keys && ctrl && VK_F3 <= key && key <= VK_F10)
         key += 10, mods &= ~MDK_CTRL;
       if (key <= VK_F4)
         mod_ss3(key - VK_F1 + 'P');
@@ -689,8 +715,8 @@ win_key_down(WPARAM wp, LPARAM lp)
     when VK_DELETE: edit_key(3, '.');
     when VK_PRIOR:  edit_key(5, '9');
     when VK_NEXT:   edit_key(6, '3');
-    when VK_HOME:   term.vt220_keys ? edit_key(1, '7') : cursor_key('H', '7');
-    when VK_END:    term.vt220_keys ? edit_key(4, '1') : cursor_key('F', '1');
+    when VK_HOME:   term->vt220_keys ? edit_key(1, '7') : cursor_key('H', '7');
+    when VK_END:    term->vt220_keys ? edit_key(4, '1') : cursor_key('F', '1');
     when VK_UP:     cursor_key('A', '8');
     when VK_DOWN:   cursor_key('B', '2');
     when VK_LEFT:   cursor_key('D', '4');
@@ -699,24 +725,24 @@ win_key_down(WPARAM wp, LPARAM lp)
     when VK_MULTIPLY ... VK_DIVIDE:
       if (key == VK_ADD && old_alt_state == ALT_ALONE)
         alt_state = ALT_HEX, alt_code = 0;
-      else if (mods || (term.app_keypad && !numlock) || !layout())
+      else if (mods || (term->app_keypad && !numlock) || !layout())
         app_pad_code(key - VK_MULTIPLY + '*');
     when VK_NUMPAD0 ... VK_NUMPAD9:
-      if ((term.app_cursor_keys || !term.app_keypad) &&
+      if ((term->app_cursor_keys || !term->app_keypad) &&
           alt_code_numpad_key(key - VK_NUMPAD0));
       else if (layout());
       else app_pad_code(key - VK_NUMPAD0 + '0');
     when 'A' ... 'Z' or ' ':
       if (key != ' ' && alt_code_key(key - 'A' + 0xA));
       else if (char_key());
-      else if (term.modify_other_keys > 1) modify_other_key();
+      else if (term->modify_other_keys > 1) modify_other_key();
       else if (ctrl_key());
       else ctrl_ch(CTRL(key));
     when '0' ... '9' or VK_OEM_1 ... VK_OEM_102:
       if (key <= '9' && alt_code_key(key - '0'));
       else if (char_key());
-      else if (term.modify_other_keys <= 1 && ctrl_key());
-      else if (term.modify_other_keys) modify_other_key();
+      else if (term->modify_other_keys <= 1 && ctrl_key());
+      else if (term->modify_other_keys) modify_other_key();
       else if (key <= '9') app_pad_code(key);
       else if (VK_OEM_PLUS <= key && key <= VK_OEM_PERIOD)
         app_pad_code(key - VK_OEM_PLUS + '+');
@@ -9,6 +9,9 @@
 #include "appinfo.h"
 #include "child.h"
 #include "charset.h"
+#include "latency.h"
+#include "counters.h"
+#include "trace.h"
 
 #include <locale.h>
 #include <getopt.h>
@@ -24,6 +27,7 @@ HIMC imc;
 bool win_is_full_screen;
 
 static char **main_argv;
+static char **child_argv;  // command line for the children of new panes
 static ATOM class_atom;
 
 static int extra_width, extra_height;
@@ -74,41 +78,119 @@ load_dwm_funcs(void)
   }
 }
 
+/*
+ * Timers are identified by their callback together with the terminal that
+ * was current when they were set, so that each terminal has timers of its
+ * own. The terminal is made current again for the callback. Timers set
+ * while no terminal is current belong to the window, and run with the
+ * active pane's terminal current.
+ */
+typedef struct {
+  void_fn cb;
+  term_t *term;
+} timer;
+
+static timer *timers;
+static uint timers_size;
+
 void
 win_set_timer(void (*cb)(void), uint ticks)
-{ SetTimer(wnd, (UINT_PTR)cb, ticks, null); }
+{
+  uint i, free_i = timers_size;
+  for (i = 0; i < timers_size; i++) {
+    if (timers[i].cb == cb && timers[i].term == term)
+      break;
+    if (!timers[i].cb && free_i == timers_size)
+      free_i = i;
+  }
+  if (i == timers_size) {
+    i = free_i;
+    if (i == timers_size) {
+      timers_size = max(16u, timers_size * 2);
+      timers = renewn(timers, timers_size);
+      memset(timers + i, 0, (timers_size - i) * sizeof *timers);
+    }
+    timers[i] = (timer){cb, term};
+  }
+  SetTimer(wnd, i + 1, ticks, null);
+}
+
+static void
+run_timer(uint id)
+{
+  if (!id || id > timers_size || !timers[id - 1].cb)
+    return;
+  timer t = timers[id - 1];
+  timers[id - 1].cb = 0;
+  term = t.term ?: active_pane->term;
+  t.cb();
+  term = active_pane->term;
+}
+
+/* Cancel the current terminal's timers. */
+void
+win_kill_timers(void)
+{
+  for (uint i = 0; i < timers_size; i++) {
+    if (timers[i].cb && timers[i].term == term) {
+      KillTimer(wnd, i + 1);
+      timers[i].cb = 0;
+    }
+  }
+}
+
+/*
+ * Applications such as progress displays can change the title many times
+ * a second, so a title is only applied at the next display update, and
+ * only if it differs from the current one. Each pane has a title of its
+ * own, and the window shows the active pane's.
+ */
+static bool title_pending;
 
 void
 win_set_title(char *title)
 {
   wchar wtitle[strlen(title) + 1];
-  if (cs_mbstowcs(wtitle, title, lengthof(wtitle)) >= 0)
-    SetWindowTextW(wnd, wtitle);
+  if (cs_mbstowcs(wtitle, title, lengthof(wtitle)) >= 0) {
+    pane *p = win_pane();
+    delete(p->title);
+    p->title = wcsdup(wtitle);
+    title_pending |= p == active_pane;
+  }
 }
 
 void
-win_copy_title(void)
+win_update_title(void)
 {
+  if (!title_pending)
+    return;
+  title_pending = false;
   int len = GetWindowTextLengthW(wnd);
   wchar title[len + 1];
   len = GetWindowTextW(wnd, title, len + 1);
-  win_copy(title, 0, len + 1);
+  title[len] = 0;
+  if (wcscmp(title, active_pane->title))
+    SetWindowTextW(wnd, active_pane->title);
+}
+
+void
+win_copy_title(void)
+{
+  wstring title = win_pane()->title;
+  win_copy(title, 0, wcslen(title) + 1);
 }
 
 /*
  * Title stack (implemented as fixed-size circular buffer)
  */
-static wstring titles[16];
+static wchar *titles[16];
 static uint titles_i;
 
 void
 win_save_title(void)
 {
-  int len = GetWindowTextLengthW(wnd);
-  wchar *title = newn(wchar, len + 1);
-  GetWindowTextW(wnd, title, len + 1);
   delete(titles[titles_i]);
-  titles[titles_i++] = title;
+  titles[titles_i++] = wcsdup(win_pane()->title);
   if (titles_i == lengthof(titles))
     titles_i = 0;
 }
@@ -118,10 +200,12 @@ win_restore_title(void)
 {
   if (!titles_i)
     titles_i = lengthof(titles);
-  wstring title = titles[--titles_i];
+  wchar *title = titles[--titles_i];
   if (title) {
-    SetWindowTextW(wnd, title);
-    delete(title);
+    pane *p = win_pane();
+    delete(p->title);
+    p->title = title;
+    title_pending |= p == active_pane;
     titles[titles_i] = 0;
   }
 }
@@ -181,11 +265,14 @@ win_set_iconic(bool iconic)
 
 /*
  * Move the window in response to a server-side request.
+ * Server-side requests to move or resize the window are ignored while it's
+ * split into panes, as the window doesn't belong to any one of them, and
+ * resizing it would squeeze the other panes.
  */
 void
 win_set_pos(int x, int y)
 {
-  if (!IsZoomed(wnd))
+  if (!IsZoomed(wnd) && !root_pane->first)
     SetWindowPos(wnd, null, x, y, 0, 0, SWP_NOSIZE | SWP_NOZORDER);
 }
 
@@ -234,8 +321,8 @@ win_get_screen_chars(int *rows_p, int *cols_p)
   *cols_p = (fr.right - fr.left) / font_width;
 }
 
-void
-win_set_pixels(int height, int width)
+static void
+set_pixels(int height, int width)
 {
   SetWindowPos(wnd, null, 0, 0,
                width + 2 * PADDING + extra_width,
@@ -243,6 +330,13 @@ win_set_pixels(int height, int width)
                SWP_NOACTIVATE | SWP_NOCOPYBITS | SWP_NOMOVE | SWP_NOZORDER);
 }
 
+void
+win_set_pixels(int height, int width)
+{
+  if (!root_pane->first)
+    set_pixels(height, width);
+}
+
 void
 win_set_chars(int rows, int cols)
 {
@@ -278,7 +372,7 @@ win_bell(void)
 {
   if (cfg.bell_sound)
     MessageBeep(MB_OK);
-  if (cfg.bell_taskbar && !term.has_focus)
+  if (cfg.bell_taskbar && !term->has_focus)
     flash_taskbar(true);
 }
 
@@ -306,11 +400,7 @@ win_adapt_term_size(void)
   int term_height = client_height - 2 * PADDING;
   int cols = max(1, term_width / font_width);
   int rows = max(1, term_height / font_height);
-  if (rows != term.rows || cols != term.cols) {
-    term_resize(rows, cols);
-    struct winsize ws = {rows, cols, cols * font_width, rows * font_height};
-    child_resize(&ws);
-  }
+  win_layout_panes(rows, cols);
   win_invalidate_all();
 }
 
@@ -329,7 +419,7 @@ update_glass(void)
   if (pDwmExtendFrameIntoClientArea) {
     bool enabled =
       cfg.transparency == TR_GLASS && !win_is_fullscreen &&
-      !(cfg.opaque_when_focused && term.has_focus);
+      !(cfg.opaque_when_focused && term->has_focus);
     pDwmExtendFrameIntoClientArea(wnd, &(MARGINS){enabled ? -1 : 0, 0, 0, 0});
   }
 }
@@ -377,11 +467,11 @@ clear_fullscreen(void)
 }
 
 /*
- * Maximise or restore the window in response to a server-side request.
+ * Maximise or restore the window.
  * Argument value of 2 means go fullscreen.
  */
-void
-win_maximise(int max)
+static void
+maximise(int max)
 {
   if (IsZoomed(wnd)) {
     if (!max)
@@ -396,6 +486,16 @@ win_maximise(int max)
   }
 }
 
+/*
+ * Maximise or restore the window in response to a server-side request.
+ */
+void
+win_maximise(int max)
+{
+  if (!root_pane->first)
+    maximise(max);
+}
+
 /*
  * Go back to configured window size.
  */
@@ -404,7 +504,7 @@ default_size(void)
 {
   if (IsZoomed(wnd))
     ShowWindow(wnd, SW_RESTORE);
-  win_set_chars(cfg.rows, cfg.cols);
+  set_pixels(cfg.rows * font_height, cfg.cols * font_width);
 }
 
 static void
@@ -417,7 +517,7 @@ update_transparency(void)
   style = trans ? style | WS_EX_LAYERED : style & ~WS_EX_LAYERED;
   SetWindowLong(wnd, GWL_EXSTYLE, style);
   if (trans) {
-    if (cfg.opaque_when_focused && term.has_focus)
+    if (cfg.opaque_when_focused && term->has_focus)
       trans = 0;
     SetLayeredWindowAttributes(wnd, 0, 255 - (uchar)trans, LWA_ALPHA);
   }
@@ -428,7 +528,7 @@ update_transparency(void)
 void
 win_update_scrollbar(void)
 {
-  int scrollbar = term.show_scrollbar ? cfg.scrollbar : 0;
+  int scrollbar = term->show_scrollbar ? cfg.scrollbar : 0;
   LONG style = GetWindowLong(wnd, GWL_STYLE);
   SetWindowLong(wnd, GWL_STYLE,
                 scrollbar ? style | WS_VSCROLL : style & ~WS_VSCROLL);
@@ -444,8 +544,9 @@ win_update_scrollbar(void)
 void
 win_reconfig(bool font_changed)
 {
-  /* Pass new config data to the terminal */
-  term_reconfig();
+  /* Pass new config data to the terminals */
+  void reconfig(pane *unused(p)) { term_reconfig(); }
+  win_for_each_pane(reconfig);
   
   win_set_colour(FG_COLOUR_I, cfg.fg_colour);
   win_set_colour(BG_COLOUR_I, cfg.bg_colour);
@@ -462,14 +563,26 @@ win_reconfig(bool font_changed)
 
   bool old_ambig_wide = cs_ambig_wide;
   cs_reconfig();
-  if (term.report_ambig_width && old_ambig_wide != cs_ambig_wide)
-    child_write(cs_ambig_wide ? "\e[2W" : "\e[1W", 4);
+  void report_ambig_width(pane *unused(p)) {
+    if (term->report_ambig_width)
+      child_write(cs_ambig_wide ? "\e[2W" : "\e[1W", 4);
+  }
+  if (old_ambig_wide != cs_ambig_wide)
+    win_for_each_pane(report_ambig_width);
+
+  win_update();
 }
 
 static bool
-confirm_exit(void)
+confirm_exit(bool all_panes)
 {
-  if (!child_is_parent())
+  bool running = false;
+  void check(pane *unused(p)) { running |= child_is_parent(); }
+  if (all_panes)
+    win_for_each_pane(check);
+  else
+    running = child_is_parent();
+  if (!running)
     return true;
 
   int ret =
@@ -484,18 +597,42 @@ confirm_exit(void)
   return !ret || ret == IDOK;
 }
 
+/*
+ * Show the performance counters one per line, or offer to start counting.
+ * The text of a message box can be copied with Ctrl+C.
+ */
+static void
+show_counters(void)
+{
+  if (!counting) {
+    int ret =
+      MessageBox(
+        wnd,
+        "Performance counters are off.\n"
+        "Start counting?",
+        APPNAME, MB_ICONQUESTION | MB_YESNO
+      );
+    if (ret == IDYES)
+      counters_enable(true);
+    return;
+  }
+  char *report = counters_report();
+  for (char *p = report; (p = strchr(p, ';'));)
+    *p = '\n';
+  MessageBox(wnd, report, APPNAME " counters", MB_OK);
+  free(report);
+}
+
 static LRESULT CALLBACK
 win_proc(HWND wnd, UINT message, WPARAM wp, LPARAM lp)
 {
   switch (message) {
-    when WM_TIMER: {
+    when WM_TIMER:
       KillTimer(wnd, wp);
-      void_fn cb = (void_fn)wp;
-      cb();
+      run_timer(wp);
       return 0;
-    }
     when WM_CLOSE:
-      if (!cfg.confirm_exit || confirm_exit())
+      if (!cfg.confirm_exit || confirm_exit(true))
         child_kill((GetKeyState(VK_SHIFT) & 0x80) != 0);
       return 0;
     when WM_COMMAND or WM_SYSCOMMAND:
@@ -504,13 +641,20 @@ win_proc(HWND wnd, UINT message, WPARAM wp, LPARAM lp)
         when IDM_COPY: term_copy();
         when IDM_PASTE: win_paste();
         when IDM_SELALL: term_select_all(); win_update();
-        when IDM_RESET: term_reset(); win_update();
+        when IDM_RESET: term_reset(); win_reset_colours(); win_update();
         when IDM_DEFSIZE: default_size();
-        when IDM_FULLSCREEN: win_maximise(win_is_fullscreen ? 0 : 2);
+        when IDM_FULLSCREEN: maximise(win_is_fullscreen ? 0 : 2);
         when IDM_FLIPSCREEN: term_flip_screen();
         when IDM_OPTIONS: win_open_config();
         when IDM_NEW: child_fork(main_argv);
         when IDM_COPYTITLE: win_copy_title();
+        when IDM_COUNTERS: show_counters();
+        when IDM_SPLITRIGHT: win_split_pane(true, child_argv);
+        when IDM_SPLITDOWN: win_split_pane(false, child_argv);
+        when IDM_NEXTPANE: win_next_pane();
+        when IDM_CLOSEPANE:
+          if (!cfg.confirm_exit || confirm_exit(false))
+            win_close_pane();
       }
     when WM_VSCROLL:
       switch (LOWORD(wp)) {
@@ -518,8 +662,8 @@ win_proc(HWND wnd, UINT message, WPARAM wp, LPARAM lp)
         when SB_TOP:      term_scroll(+1, 0);
         when SB_LINEDOWN: term_scroll(0, +1);
         when SB_LINEUP:   term_scroll(0, -1);
-        when SB_PAGEDOWN: term_scroll(0, +max(1, term.rows - 1));
-        when SB_PAGEUP:   term_scroll(0, -max(1, term.rows - 1));
+        when SB_PAGEDOWN: term_scroll(0, +max(1, term->rows - 1));
+        when SB_PAGEUP:   term_scroll(0, -max(1, term->rows - 1));
         when SB_THUMBPOSITION or SB_THUMBTRACK: {
           SCROLLINFO info;
           info.cbSize = sizeof(SCROLLINFO);
@@ -873,6 +1017,18 @@ main(int argc, char *argv[])
     }
   }
 
+  // Start tracing keystroke latency if requested.
+  if (cfg.latency_trace)
+    latency_enable(true);
+
+  // Likewise for the performance counters and timeline tracing.
+  if (cfg.perf_counters)
+    counters_enable(true);
+  if (cfg.trace_spans)
+    trace_enable(true);
+
+  term = term_new();
+
   inst = GetModuleHandle(NULL);
 
   // Window class name.
@@ -911,6 +1067,9 @@ main(int argc, char *argv[])
       fputs("Using default title due to invalid characters.\n", stderr);
   }
 
+  // The terminal starts out in a pane filling the window.
+  win_init_panes(wtitle);
+
   // The window class.
   class_atom = RegisterClassExW(&(WNDCLASSEXW){
     .cbSize = sizeof(WNDCLASSEXW),
@@ -988,6 +1147,7 @@ main(int argc, char *argv[])
   }
 
   // Initialise the terminal.
+  win_reset_colours();
   term_reset();
   term_resize(cfg.rows, cfg.cols);
 
@@ -1013,6 +1173,7 @@ main(int argc, char *argv[])
   update_transparency();
   
   // Create child process.
+  child_argv = argv;
   child_create(
     argv, &(struct winsize){cfg.rows, cfg.cols, term_width, term_height}
   );
@@ -0,0 +1,264 @@
+// winpane.c (part of mintty)
+// Licensed under the terms of the GNU General Public License v3 or later.
+
+#include "winpriv.h"
+
+#include "child.h"
+
+#include <math.h>
+
+pane *root_pane, *active_pane;
+
+static pane *cur_pane;  // cache for win_pane()
+static wstring initial_title;
+
+static pane *
+new_pane(term_t *t)
+{
+  pane *p = newn(pane, 1);
+  p->term = t;
+  p->title = wcsdup(initial_title);
+  p->update = p->full_update = true;
+  return p;
+}
+
+static pane *
+first_pane(pane *p)
+{
+  while (p->first)
+    p = p->first;
+  return p;
+}
+
+/* The pane after the given one, or null if it's the last one. */
+static pane *
+next_pane(pane *p)
+{
+  while (p->parent && p == p->parent->second)
+    p = p->parent;
+  return p->parent ? first_pane(p->parent->second) : 0;
+}
+
+void
+win_init_panes(wstring title)
+{
+  initial_title = title;
+  root_pane = active_pane = new_pane(term);
+  root_pane->rows = cfg.rows;
+  root_pane->cols = cfg.cols;
+}
+
+/* The current terminal's pane. */
+pane *
+win_pane(void)
+{
+  if (cur_pane && cur_pane->term == term)
+    return cur_pane;
+  for (pane *p = first_pane(root_pane); p; p = next_pane(p)) {
+    if (p->term == term)
+      return cur_pane = p;
+  }
+  return active_pane;
+}
+
+/* The pane at the given point in the client area, if any. */
+pane *
+win_pane_at(int x, int y)
+{
+  x = floorf((x - PADDING) / (float)font_width);
+  y = floorf((y - PADDING) / (float)font_height);
+  for (pane *p = first_pane(root_pane); p; p = next_pane(p)) {
+    if (x >= p->x && x < p->x + p->cols && y >= p->y && y < p->y + p->rows)
+      return p;
+  }
+  return 0;
+}
+
+/* Call a function for each pane, with the pane's terminal current. */
+void
+win_for_each_pane(void (*f)(pane *))
+{
+  term_t *cur = term;
+  for (pane *p = first_pane(root_pane); p; p = next_pane(p)) {
+    term = p->term;
+    f(p);
+  }
+  term = cur;
+}
+
+/*
+ * A pane is collapsed when the window has become too small to show it.
+ * Its terminal keeps its previous size until there's room again.
+ */
+static bool
+collapsed(pane *p)
+{ return !p->rows || !p->cols; }
+
+/*
+ * Share out space between the halves of splits. When there's no room for
+ * a cell on each side of the separator, the second half collapses.
+ */
+static void
+layout(pane *p, int x, int y, int rows, int cols)
+{
+  p->x = x;
+  p->y = y;
+  p->rows = rows;
+  p->cols = cols;
+  if (!p->first)
+    return;
+  if (p->side_by_side) {
+    int cols1 = cols < 3 ? cols : (cols - 1) / 2;
+    layout(p->first, x, y, rows, cols1);
+    layout(p->second, x + cols1 + 1, y, rows, max(0, cols - cols1 - 1));
+  }
+  else {
+    int rows1 = rows < 3 ? rows : (rows - 1) / 2;
+    layout(p->first, x, y, rows1, cols);
+    layout(p->second, x, y + rows1 + 1, max(0, rows - rows1 - 1), cols);
+  }
+}
+
+static void
+resize_pane(pane *p)
+{
+  if (collapsed(p))
+    return;
+  if (p->rows != term->rows || p->cols != term->cols) {
+    term_resize(p->rows, p->cols);
+    struct winsize ws =
+      {p->rows, p->cols, p->cols * font_width, p->rows * font_height};
+    child_resize(&ws);
+  }
+}
+
+/* Share out the given number of cells between the panes. */
+void
+win_layout_panes(int rows, int cols)
+{
+  layout(root_pane, 0, 0, rows, cols);
+  win_for_each_pane(resize_pane);
+  if (collapsed(active_pane))
+    win_activate_pane(first_pane(root_pane));
+}
+
+void
+win_activate_pane(pane *p)
+{
+  if (p == active_pane)
+    return;
+
+  bool focus = GetFocus() == wnd;
+  if (active_pane && focus) {
+    term = active_pane->term;
+    term_set_focus(false);
+  }
+  active_pane = p;
+  term = p->term;
+  term_update_cs();
+  if (focus)
+    term_set_focus(true);
+
+  SetWindowTextW(wnd, p->title);
+  win_update_scrollbar();
+  win_update_mouse();
+  win_update();
+}
+
+void
+win_next_pane(void)
+{
+  pane *p = active_pane;
+  do
+    p = next_pane(p) ?: first_pane(root_pane);
+  while (collapsed(p) && p != active_pane);
+  win_activate_pane(p);
+}
+
+/*
+ * Split the active pane in two, and start a new child in the second half,
+ * which becomes the active pane.
+ */
+void
+win_split_pane(bool side_by_side, char *argv[])
+{
+  pane *p = active_pane;
+  if ((side_by_side ? p->cols : p->rows) < 3)
+    return;  // no room
+
+  // The split takes the place of the pane in the tree.
+  pane *s = newn(pane, 1);
+  s->parent = p->parent;
+  if (!s->parent)
+    root_pane = s;
+  else if (s->parent->first == p)
+    s->parent->first = s;
+  else
+    s->parent->second = s;
+  s->side_by_side = side_by_side;
+
+  pane *q = new_pane(term_new());
+  s->first = p;
+  s->second = q;
+  p->parent = q->parent = s;
+  layout(s, p->x, p->y, p->rows, p->cols);
+
+  term = q->term;
+  term_reset();
+  term_resize(q->rows, q->cols);
+  child_create(
+    argv,
+    &(struct winsize){q->rows, q->cols, q->cols * font_width,
+                      q->rows * font_height}
+  );
+
+  term = p->term;
+  resize_pane(p);
+
+  win_activate_pane(q);
+  win_invalidate_all();
+}
+
+/*
+ * Close the current terminal's pane, letting the other half of its split
+ * take its place. Closing the last pane exits.
+ */
+void
+win_close_pane(void)
+{
+  pane *p = win_pane();
+  pane *s = p->parent;
+  if (!s)
+    exit(0);
+
+  child_free();
+  win_kill_timers();
+  term_free(term);
+
+  pane *o = s->first == p ? s->second : s->first;
+  o->parent = s->parent;
+  if (!s->parent)
+    root_pane = o;
+  else if (s->parent->first == s)
+    s->parent->first = o;
+  else
+    s->parent->second = o;
+  layout(o, s->x, s->y, s->rows, s->cols);
+
+  bool was_active = p == active_pane;
+  if (cur_pane == p)
+    cur_pane = 0;
+  delete(p->title);
+  delete(p);
+  delete(s);
+
+  if (was_active) {
+    active_pane = 0;
+    win_activate_pane(first_pane(o));
+  }
+  else
+    term = active_pane->term;
+
+  win_for_each_pane(resize_pane);
+  win_invalidate_all();
+}
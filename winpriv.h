@@ -22,6 +22,40 @@ extern int font_width, font_height;
 
 enum { PADDING = 1 };
 
+/*
+ * Panes. The window can be split into panes, each with a terminal and a
+ * child process of its own. Splits form a binary tree with the panes as
+ * its leaves. Positions and sizes are in character cells, and there's a
+ * row or column of cells between neighbouring panes for the separator.
+ *
+ * The active pane's terminal is current, except while painting or timer
+ * callbacks make another one current for a while.
+ */
+typedef struct pane pane;
+struct pane {
+  pane *parent;
+  pane *first, *second;  // halves of a split, or null for a pane
+  bool side_by_side;     // how a split is divided
+  term_t *term;
+  wchar *title;
+  bool update;           // needs painting
+  bool full_update;      // more than cursor or overlays changed
+  int x, y, rows, cols;
+};
+
+extern pane *root_pane, *active_pane;
+
+void win_init_panes(wstring title);
+pane *win_pane(void);
+pane *win_pane_at(int x, int y);
+void win_for_each_pane(void (*)(pane *));
+void win_layout_panes(int rows, int cols);
+void win_activate_pane(pane *);
+void win_split_pane(bool side_by_side, char *argv[]);
+void win_next_pane(void);
+
+void win_kill_timers(void);
+
 void win_paint(void);
 
 void win_init_fonts(int size);
@@ -47,6 +81,7 @@ bool win_key_up(WPARAM, LPARAM);
 
 void win_init_drop_target(void);
 
+void win_update_title(void);
 void win_copy_title(void);
 
 void win_switch(bool back);
@@ -6,6 +6,9 @@
 #include "winpriv.h"
 
 #include "minibidi.h"
+#include "glyphcache.h"
+#include "charset.h"
+#include "trace.h"
 
 #include <winnls.h>
 
@@ -90,15 +93,6 @@ brighten(colour c)
   return make_colour(r + s, g + s, b + s);
 }
 
-static uint
-colour_dist(colour a, colour b)
-{
-  return
-    2 * sqr(red(a) - red(b)) +
-    4 * sqr(green(a) - green(b)) +
-    1 * sqr(blue(a) - blue(b));
-}
-
 static uint
 get_font_quality(void) {  
   return
@@ -139,6 +133,86 @@ create_font(int weight, bool underline)
  *   ordinary one (manual underlining by means of line drawing can
  *   be done in a pinch).
  */
+/*
+ * Glyph width and coverage caches for the normal and bold fonts, which
+ * save GDI calls when painting wide characters and answering OSC 7771.
+ * If the GlyphCacheDir setting is set, they're persisted there.
+ */
+static glyph_cache *glyph_caches[2];
+
+static void
+measure_widths(void *ctx, xchar first, uint num, uchar *widths)
+{
+  int ibuf[num];
+  HDC dc = GetDC(wnd);
+  SelectObject(dc, *(HFONT *)ctx);
+  if (first + num <= 0x10000) {
+    if (!GetCharWidth32W(dc, first, first + num - 1, ibuf))
+      memset(ibuf, 0, sizeof ibuf);
+  }
+  else {
+    // GetCharWidth32W only takes UTF-16 code units, so measure characters
+    // outside the BMP as surrogate pairs.
+    for (uint i = 0; i < num; i++) {
+      xchar c = first + i;
+      wchar wcs[] = {high_surrogate(c), low_surrogate(c)};
+      SIZE size;
+      ibuf[i] = GetTextExtentPoint32W(dc, wcs, 2, &size) ? size.cx : 0;
+    }
+  }
+  ReleaseDC(wnd, dc);
+
+  for (uint i = 0; i < num; i++)
+    widths[i] = (ibuf[i] + font_width / 2 - 1) / font_width;
+}
+
+static void
+measure_coverage(void *ctx, const wchar *wcs, uint num, bool *has)
+{
+  HDC dc = GetDC(wnd);
+  SelectObject(dc, *(HFONT *)ctx);
+  ushort glyphs[num];
+  GetGlyphIndicesW(dc, wcs, num, glyphs, true);
+  for (uint i = 0; i < num; i++)
+    has[i] = glyphs[i] != 0xFFFF && glyphs[i] != 0x1F;
+  ReleaseDC(wnd, dc);
+}
+
+static void
+save_glyph_caches(void)
+{
+  for (int i = 0; i < 2; i++) {
+    if (*cfg.glyph_cache_dir)
+      glyph_cache_save(glyph_caches[i], cfg.glyph_cache_dir);
+    glyph_cache_free(glyph_caches[i]);
+    glyph_caches[i] = 0;
+  }
+}
+
+static void
+init_glyph_caches(void)
+{
+  static bool registered;
+  if (!registered) {
+    atexit(save_glyph_caches);
+    registered = true;
+  }
+
+  for (int i = 0; i < 2; i++) {
+    HFONT *font = &fonts[i && fonts[FONT_BOLD] ? FONT_BOLD : FONT_NORMAL];
+    char name[strlen(cfg.font.name) + 8];
+    sprintf(name, "%s%s", cfg.font.name,
+            i ? (cfg.font.isbold ? " Heavy" : " Bold")
+              : (cfg.font.isbold ? " Bold" : ""));
+    glyph_measurer measurer = {
+      .ctx = font, .widths = measure_widths, .coverage = measure_coverage
+    };
+    glyph_caches[i] = glyph_cache_new(measurer, name, font_size);
+    if (*cfg.glyph_cache_dir)
+      glyph_cache_load(glyph_caches[i], cfg.glyph_cache_dir);
+  }
+}
+
 void
 win_init_fonts(int size)
 {
@@ -147,6 +221,8 @@ win_init_fonts(int size)
   int i;
   int fw_dontcare, fw_bold;
 
+  save_glyph_caches();
+
   font_size = size;
 
   for (i = 0; i < FONT_MAXNO; i++) {
@@ -293,6 +369,8 @@ win_init_fonts(int size)
     fonts[FONT_BOLD] = 0;
   }
   fontflag[0] = fontflag[1] = fontflag[2] = 1;
+
+  init_glyph_caches();
 }
 
 uint
@@ -320,46 +398,118 @@ win_zoom_font(int zoom)
 static HDC dc;
 static enum { UPDATE_IDLE, UPDATE_BLOCKED, UPDATE_PENDING } update_state;
 static bool ime_open;
+static bool in_paint;  // drawing to a DC clipped to an invalid region
+static bool colours_changed;  // window needs redrawing in new colours
+
+/*
+ * Panes are drawn with the viewport origin moved to their top left corner,
+ * so the terminal code can carry on drawing at its own cell positions.
+ */
+static void
+set_pane_origin(pane *p)
+{
+  SetViewportOrgEx(dc, p->x * font_width, p->y * font_height, 0);
+  SelectClipRgn(dc, 0);
+  IntersectClipRect(dc, PADDING, PADDING,
+                    PADDING + font_width * p->cols,
+                    PADDING + font_height * p->rows);
+}
+
+static void
+reset_origin(void)
+{
+  SetViewportOrgEx(dc, 0, 0, 0);
+  SelectClipRgn(dc, 0);
+}
 
 void
 win_paint(void)
 {
-  PAINTSTRUCT p;
-  dc = BeginPaint(wnd, &p);
-
-  term_invalidate(
-    (p.rcPaint.left - PADDING) / font_width,
-    (p.rcPaint.top - PADDING) / font_height,
-    (p.rcPaint.right - PADDING - 1) / font_width,
-    (p.rcPaint.bottom - PADDING - 1) / font_height
-  );
-
-  if (update_state != UPDATE_PENDING)
-    term_paint();
-
-  if (p.fErase || p.rcPaint.left < PADDING ||
-      p.rcPaint.top < PADDING ||
-      p.rcPaint.right >= PADDING + font_width * term.cols ||
-      p.rcPaint.bottom >= PADDING + font_height * term.rows) {
-    colour bg_colour = colours[term.rvideo ? FG_COLOUR_I : BG_COLOUR_I];
+  PAINTSTRUCT ps;
+  dc = BeginPaint(wnd, &ps);
+
+  void paint(pane *p) {
+    int x = PADDING + p->x * font_width, y = PADDING + p->y * font_height;
+    term_invalidate(
+      (ps.rcPaint.left - x) / font_width,
+      (ps.rcPaint.top - y) / font_height,
+      (ps.rcPaint.right - x - 1) / font_width,
+      (ps.rcPaint.bottom - y - 1) / font_height
+    );
+    if (update_state != UPDATE_PENDING) {
+      set_pane_origin(p);
+      in_paint = true;
+      term_paint();
+      in_paint = false;
+    }
+    else
+      p->update = p->full_update = true;
+  }
+  win_for_each_pane(paint);
+  reset_origin();
+
+  if (ps.fErase || ps.rcPaint.left < PADDING ||
+      ps.rcPaint.top < PADDING ||
+      ps.rcPaint.right >= PADDING + font_width * root_pane->cols ||
+      ps.rcPaint.bottom >= PADDING + font_height * root_pane->rows ||
+      root_pane->first) {
+    colour bg_colour = colours[term->rvideo ? FG_COLOUR_I : BG_COLOUR_I];
     HBRUSH oldbrush = SelectObject(dc, CreateSolidBrush(bg_colour));
     HPEN oldpen = SelectObject(dc, CreatePen(PS_SOLID, 0, bg_colour));
 
-    IntersectClipRect(dc, p.rcPaint.left, p.rcPaint.top, p.rcPaint.right,
-                      p.rcPaint.bottom);
-
-    ExcludeClipRect(dc, PADDING, PADDING,
-                    PADDING + font_width * term.cols,
-                    PADDING + font_height * term.rows);
+    IntersectClipRect(dc, ps.rcPaint.left, ps.rcPaint.top, ps.rcPaint.right,
+                      ps.rcPaint.bottom);
 
-    Rectangle(dc, p.rcPaint.left, p.rcPaint.top,
-                  p.rcPaint.right, p.rcPaint.bottom);
+    void exclude(pane *p) {
+      int x = PADDING + p->x * font_width, y = PADDING + p->y * font_height;
+      ExcludeClipRect(dc, x, y, x + font_width * p->cols,
+                      y + font_height * p->rows);
+    }
+    win_for_each_pane(exclude);
+
+    Rectangle(dc, ps.rcPaint.left, ps.rcPaint.top,
+                  ps.rcPaint.right, ps.rcPaint.bottom);
+
+    // Draw a line down the middle of the gap between the halves of splits.
+    DeleteObject(SelectObject(dc, CreatePen(PS_SOLID, 0, colours[FG_COLOUR_I])));
+    void separate(pane *s) {
+      if (!s->first)
+        return;
+      pane *p = s->first, *q = s->second;
+      if (!q->rows || !q->cols)
+        ;  // collapsed, so there's nothing to separate
+      else if (s->side_by_side) {
+        int x = PADDING + (p->x + p->cols) * font_width + font_width / 2;
+        MoveToEx(dc, x, PADDING + s->y * font_height, 0);
+        LineTo(dc, x, PADDING + (s->y + s->rows) * font_height);
+      }
+      else {
+        int y = PADDING + (p->y + p->rows) * font_height + font_height / 2;
+        MoveToEx(dc, PADDING + s->x * font_width, y, 0);
+        LineTo(dc, PADDING + (s->x + s->cols) * font_width, y);
+      }
+      separate(s->first);
+      separate(s->second);
+    }
+    separate(root_pane);
 
     DeleteObject(SelectObject(dc, oldbrush));
     DeleteObject(SelectObject(dc, oldpen));
   }
   
-  EndPaint(wnd, &p);
+  EndPaint(wnd, &ps);
+}
+
+static void do_update(void);
+
+/* The update timer belongs to the window rather than to any one pane. */
+static void
+schedule_update(void)
+{
+  term_t *cur = term;
+  term = 0;
+  win_set_timer(do_update, 16);
+  term = cur;
 }
 
 static void
@@ -371,21 +521,47 @@ do_update(void)
   }
 
   update_state = UPDATE_BLOCKED;
+  long long start = trace_begin();
+  bool full = false;
+
+  // Apply title and colour changes since the last update.
+  win_update_title();
+  if (colours_changed) {
+    colours_changed = false;
+    win_invalidate_all();
+  }
 
+  // Only panes that have changed since the last update are painted.
   dc = GetDC(wnd);
-  term_paint();
+  void paint(pane *p) {
+    if (!p->update)
+      return;
+    set_pane_origin(p);
+    if (p->full_update)
+      term_paint();
+    else
+      term_paint_overlays();
+    full |= p->full_update;
+    p->update = p->full_update = false;
+  }
+  win_for_each_pane(paint);
+  reset_origin();
   ReleaseDC(wnd, dc);
 
+  // The scrollbar and caret belong to the active pane.
+  term_t *cur = term;
+  term = active_pane->term;
+
   // Update scrollbar
-  if (cfg.scrollbar && term.show_scrollbar) {
+  if (cfg.scrollbar && term->show_scrollbar) {
     int lines = sblines();
     SCROLLINFO si = {
       .cbSize = sizeof si,
       .fMask = SIF_ALL | SIF_DISABLENOSCROLL,
       .nMin = 0,
-      .nMax = lines + term.rows - 1,
-      .nPage = term.rows,
-      .nPos = lines + term.disptop
+      .nMax = lines + term->rows - 1,
+      .nPage = term->rows,
+      .nPos = lines + term->disptop
     };
     SetScrollInfo(wnd, SB_VERT, &si, true);
   }
@@ -394,9 +570,10 @@ do_update(void)
   // (We maintain a caret, even though it's invisible, for the benefit of
   // blind people: apparently some helper software tracks the system caret,
   // so we should arrange to have one.)
-  if (term.has_focus) {
-    int x = term.curs.x * font_width + PADDING;
-    int y = (term.curs.y - term.disptop) * font_height + PADDING;
+  if (term->has_focus) {
+    int x = (active_pane->x + term->curs.x) * font_width + PADDING;
+    int y =
+      (active_pane->y + term->curs.y - term->disptop) * font_height + PADDING;
     SetCaretPos(x, y);
     if (ime_open) {
       COMPOSITIONFORM cf = {.dwStyle = CFS_POINT, .ptCurrentPos = {x, y}};
@@ -404,13 +581,28 @@ do_update(void)
     }
   }
 
+  term = cur;
+  trace_end("do_update", start, full);
+
   // Schedule next update.
-  win_set_timer(do_update, 16);
+  schedule_update();
 }
 
 void
 win_update(void)
 {
+  win_pane()->full_update = true;
+  win_update_overlays();
+}
+
+/*
+ * Like win_update(), for when only the cursor, blinking text or overlays
+ * such as the selection have changed.
+ */
+void
+win_update_overlays(void)
+{
+  win_pane()->update = true;
   if (update_state == UPDATE_IDLE)
     do_update();
   else
@@ -420,8 +612,10 @@ win_update(void)
 void
 win_schedule_update(void)
 {
+  pane *p = win_pane();
+  p->update = p->full_update = true;
   if (update_state == UPDATE_IDLE)
-    win_set_timer(do_update, 16);
+    schedule_update();
   update_state = UPDATE_PENDING;
 }
 
@@ -474,20 +668,72 @@ win_set_ime_open(bool open)
 {
   if (open != ime_open) {
     ime_open = open;
-    term.cursor_invalid = true;
+    term->cursor_invalid = true;
     win_update();
   }
 }
 
 
+/*
+ * Cache of resolved text colours, keyed by the colour attributes and
+ * the reverse video, IME and cursor type state they were resolved for.
+ * Direct-mapped, as a screen rarely uses more than a handful of
+ * attribute combinations. Must be cleared whenever the palette or the
+ * config changes.
+ */
+enum { COLOUR_CACHE_SIZE = 256 };
+
+static struct {
+  uint attr;
+  uchar state;
+  bool valid;
+  text_colours colours;
+} colour_cache[COLOUR_CACHE_SIZE];
+
+static void
+clear_colour_cache(void)
+{
+  for (int i = 0; i < COLOUR_CACHE_SIZE; i++)
+    colour_cache[i].valid = false;
+}
+
+static text_colours
+get_text_colours(uint attr)
+{
+  int cursor_type = term_cursor_type();
+  attr &= ATTR_COLOURMASK;
+  uchar state = term->rvideo | ime_open << 1 | cursor_type << 2;
+
+  uint h = (attr ^ attr >> 9 ^ attr >> 18 ^ attr >> 27 ^ state) &
+           (COLOUR_CACHE_SIZE - 1);
+  typeof(*colour_cache) *e = &colour_cache[h];
+  if (!e->valid || e->attr != attr || e->state != state) {
+    e->attr = attr;
+    e->state = state;
+    e->valid = true;
+    e->colours =
+      term_text_colours(attr, colours, term->rvideo,
+                        ime_open ? IME_CURSOR_COLOUR_I : CURSOR_COLOUR_I,
+                        cursor_type);
+  }
+  return e->colours;
+}
+
+/*
+ * GDI state selected into the device context while drawing a draw list,
+ * so that runs sharing a font or colours don't set them again.
+ */
+static HFONT cur_font;
+static colour cur_fg, cur_bg;
+
 /*
  * Draw a line of text in the window, at given character
  * coordinates, in given attributes.
  *
  * We are allowed to fiddle with the contents of `text'.
  */
-void
-win_text(int x, int y, wchar *text, int len, uint attr, int lattr)
+static void
+draw_text(int x, int y, wchar *text, int len, uint attr, int lattr)
 {
   lattr &= LATTR_MODE;
   int char_width = font_width * (1 + (lattr != LATTR_NORM));
@@ -500,7 +746,7 @@ win_text(int x, int y, wchar *text, int len, uint attr, int lattr)
     char_width *= 2;
 
  /* Only want the left half of double width lines */
-  if (lattr != LATTR_NORM && x * 2 >= term.cols)
+  if (lattr != LATTR_NORM && x * 2 >= term->cols)
     return;
 
   uint nfont; 
@@ -529,64 +775,22 @@ win_text(int x, int y, wchar *text, int len, uint attr, int lattr)
   if (!fonts[nfont])
     nfont = FONT_NORMAL;
 
-  colour_i fgi = (attr & ATTR_FGMASK) >> ATTR_FGSHIFT;
-  colour_i bgi = (attr & ATTR_BGMASK) >> ATTR_BGSHIFT;
+  text_colours tc = get_text_colours(attr);
+  colour fg = tc.fg, bg = tc.bg, cursor_colour = tc.cursor;
+  bool has_cursor = attr & (TATTR_ACTCURS | TATTR_PASCURS);
 
-  if (term.rvideo) {
-    if (fgi >= 256)
-      fgi ^= 2;
-    if (bgi >= 256)
-      bgi ^= 2;
-  }
-  if (attr & ATTR_BOLD && cfg.bold_as_colour) {
-    if (fgi < 8)
-      fgi |= 8;
-    else if (fgi >= 256 && !cfg.bold_as_font)
-      fgi |= 1;
-  }
-  if (attr & ATTR_BLINK) {
-    if (bgi < 8)
-      bgi |= 8;
-    else if (bgi >= 256)
-      bgi |= 1;
+  if (fonts[nfont] != cur_font) {
+    cur_font = fonts[nfont];
+    SelectObject(dc, cur_font);
   }
-  
-  colour fg = colours[fgi];
-  colour bg = colours[bgi];
-  
-  if (attr & ATTR_DIM) {
-    fg = (fg & 0xFEFEFEFE) >> 1; // Halve the brightness.
-    if (!cfg.bold_as_colour || fgi >= 256)
-      fg += (bg & 0xFEFEFEFE) >> 1; // Blend with background.
+  if (fg != cur_fg) {
+    cur_fg = fg;
+    SetTextColor(dc, fg);
   }
-  if (attr & ATTR_REVERSE) {
-    colour t = fg; fg = bg; bg = t;
+  if (bg != cur_bg) {
+    cur_bg = bg;
+    SetBkColor(dc, bg);
   }
-  if (attr & ATTR_INVISIBLE)
-    fg = bg;
-
-  bool has_cursor = attr & (TATTR_ACTCURS | TATTR_PASCURS);
-  colour cursor_colour = 0;
-  
-  if (has_cursor) {
-    cursor_colour = colours[ime_open ? IME_CURSOR_COLOUR_I : CURSOR_COLOUR_I];
-    
-    bool too_close = colour_dist(cursor_colour, bg) < 32768;
-    
-    if (too_close)
-      cursor_colour = fg;
-    
-    if ((attr & TATTR_ACTCURS) && term_cursor_type() == CUR_BLOCK) {
-      fg = colours[CURSOR_TEXT_COLOUR_I];
-      if (too_close && colour_dist(cursor_colour, fg) < 32768)
-        fg = bg;
-      bg = cursor_colour;
-    }
-  }
-
-  SelectObject(dc, fonts[nfont]);
-  SetTextColor(dc, fg);
-  SetBkColor(dc, bg);
   
  /* Check whether the text has any right-to-left characters */
   bool has_rtl = false;
@@ -620,7 +824,7 @@ win_text(int x, int y, wchar *text, int len, uint attr, int lattr)
   int width = char_width * (combining ? 1 : len);
   RECT box = {
     .left = x, .top = y,
-    .right = min(x + width, font_width * term.cols + PADDING),
+    .right = min(x + width, font_width * term->cols + PADDING),
     .bottom = y + font_height
   };
   
@@ -649,7 +853,8 @@ win_text(int x, int y, wchar *text, int len, uint attr, int lattr)
     int dec = (lattr == LATTR_BOT) ? descent * 2 - font_height : descent;
     HPEN oldpen = SelectObject(dc, CreatePen(PS_SOLID, 0, fg));
     MoveToEx(dc, x, y + dec, null);
-    LineTo(dc, x + len * char_width, y + dec);
+    // Clip like the text, as combining runs are longer than their cells.
+    LineTo(dc, box.right, y + dec);
     oldpen = SelectObject(dc, oldpen);
     DeleteObject(oldpen);
   }
@@ -696,22 +901,80 @@ win_text(int x, int y, wchar *text, int len, uint attr, int lattr)
   }
 }
 
+static int
+cmp_runs(const void *a, const void *b)
+{
+  const draw_run *r = *(draw_run **)a, *s = *(draw_run **)b;
+  if (r->lattr != s->lattr)
+    return r->lattr < s->lattr ? -1 : 1;
+  if (r->attr != s->attr)
+    return r->attr < s->attr ? -1 : 1;
+  return r < s ? -1 : r > s;
+}
+
+/*
+ * Draw the runs produced by term_paint(). Everything draw_text() paints,
+ * including the manual underline, is clipped to the run's own cells, so the
+ * order of drawing doesn't matter, which means runs can be grouped by
+ * attributes to minimise font and colour changes.
+ */
+void
+win_draw(draw_list *dl)
+{
+  static draw_run **order;
+  static uint order_size;
+  if (order_size < dl->num_runs) {
+    order_size = dl->num_runs;
+    order = renewn(order, order_size);
+  }
+  for (uint i = 0; i < dl->num_runs; i++)
+    order[i] = &dl->runs[i];
+  qsort(order, dl->num_runs, sizeof *order, cmp_runs);
+
+  cur_font = 0;
+  cur_fg = GetTextColor(dc);
+  cur_bg = GetBkColor(dc);
+  for (uint i = 0; i < dl->num_runs; i++) {
+    draw_run *r = order[i];
+    draw_text(r->x, r->y, dl->text + r->text, r->len, r->attr, r->lattr);
+  }
+}
+
+/*
+ * Move the pixels of character rows [top, bottom) up by the given number
+ * of lines, or down if negative. The terminal takes care of redrawing the
+ * rows uncovered by this, so they needn't be invalidated, but any parts
+ * of the window that couldn't be scrolled because they were obscured are.
+ */
+void
+win_scroll_rect(int top, int bottom, int lines)
+{
+  pane *p = win_pane();
+  int x = PADDING + p->x * font_width, y = PADDING + p->y * font_height;
+  RECT rect = {
+    .left = x, .right = x + font_width * term->cols,
+    .top = y + top * font_height, .bottom = y + bottom * font_height
+  };
+  ScrollWindowEx(wnd, 0, -lines * font_height, &rect, &rect, 0, 0,
+                 SW_INVALIDATE);
+  if (in_paint)
+    return;  // Drawing is clipped, so leave the uncovered rows invalid.
+  RECT uncovered = rect;
+  if (lines > 0)
+    uncovered.top = rect.bottom - lines * font_height;
+  else
+    uncovered.bottom = rect.top - lines * font_height;
+  ValidateRect(wnd, &uncovered);
+}
+
 /* Check availability of characters in the current font.
  * Zeroes each of the characters in the input array that isn't available.
  */
 void
 win_check_glyphs(wchar *wcs, uint num)
 {
-  HDC dc = GetDC(wnd);
-  bool bold = (bold_mode == BOLD_FONT) && (term.curs.attr & ATTR_BOLD);
-  SelectObject(dc, fonts[bold ? FONT_BOLD : FONT_NORMAL]);
-  ushort glyphs[num];
-  GetGlyphIndicesW(dc, wcs, num, glyphs, true);
-  for (size_t i = 0; i < num; i++) {
-    if (glyphs[i] == 0xFFFF || glyphs[i] == 0x1F)
-      wcs[i] = 0;
-  }
-  ReleaseDC(wnd, dc);
+  bool bold = (bold_mode == BOLD_FONT) && (term->curs.attr & ATTR_BOLD);
+  glyph_cache_check(glyph_caches[bold], wcs, num);
 }
 
 /* This function gets the actual width of a character in the normal font.
@@ -719,8 +982,6 @@ win_check_glyphs(wchar *wcs, uint num)
 int
 win_char_width(xchar c)
 {
-  int ibuf = 0;
-
  /* If the font max is the same as the font ave width then this
   * function is a no-op.
   */
@@ -731,25 +992,7 @@ win_char_width(xchar c)
   if (c >= ' ' && c <= '~')
     return 1;
 
-  SelectObject(dc, fonts[FONT_NORMAL]);
-  if (!GetCharWidth32W(dc, c, c, &ibuf))
-    return 0;
-
-  ibuf += font_width / 2 - 1;
-  ibuf /= font_width;
-
-  return ibuf;
-}
-
-/* Try to combine a base and combining character into a precomposed one.
- * Returns 0 if unsuccessful.
- */
-wchar
-win_combine_chars(wchar c, wchar cc)
-{
-  wchar cs[2];
-  int len = FoldStringW(MAP_PRECOMPOSED, (wchar[]){c, cc}, 2, cs, 2);
-  return len == 1 ? *cs : 0;
+  return glyph_cache_width(glyph_caches[0], c);
 }
 
 void
@@ -774,8 +1017,12 @@ win_set_colour(colour_i i, colour c)
     otherwise:
       break;
   }
-  // Redraw everything.
-  win_invalidate_all();
+  // Redraw everything. This is also called on reconfig, which takes care
+  // of resolved colours that depend on the bold settings. The window is
+  // only invalidated at the next update, so that a series of changes
+  // costs a single redraw.
+  clear_colour_cache();
+  colours_changed = true;
 }
 
 colour win_get_colour(colour_i i) { return i < COLOUR_NUM ? colours[i] : 0; }